@@ -20,6 +20,8 @@
 #include "unicode_utilities.h"
 #include "utf_std.h"
 #include "utf_toolkit.h"
+#include "utf_bulk.h"
+#include "utf_container.h"
 #include "utf_helpers.h"
 #include "text_hash.h"
 
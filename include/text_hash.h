@@ -29,6 +29,11 @@ inline constexpr uint32_t crc_to_ascii_hash(const uint16_t crc) noexcept;
 //  length-aware helper when data may include embedded null bytes.
 uint16_t crc_ccitt_false(const uint8_t* const text) noexcept;
 uint16_t crc_ccitt_false(const uint8_t* const text, const uint32_t length) noexcept;
+
+// ==== 16-bit crc ccitt false incremental calculation ====
+//  Continues a crc over a further block of data (the initial crc is 0xffff),
+//  so text received in chunks hashes the same as the whole text.
+uint16_t crc_ccitt_false_update(const uint16_t crc, const uint8_t* const text, const uint32_t length) noexcept;
 inline uint32_t crc_ccitt_false_ascii_hash(const uint8_t* const text) noexcept { return crc_to_ascii_hash(crc_ccitt_false(text)); };
 inline uint32_t crc_ccitt_false_ascii_hash(const uint8_t* const text, const uint32_t length) noexcept { return crc_to_ascii_hash(crc_ccitt_false(text, length)); };
 
@@ -36,6 +36,7 @@ bool isLowSurrogate(const unicode_t unicode) noexcept;      //! a low surrogate
 bool isC0(const unicode_t unicode) noexcept;                //! a c0 control character
 bool isC1(const unicode_t unicode) noexcept;                //! a c1 control character
 bool isCC(const unicode_t unicode) noexcept;                //! a c0, c1 or delete control character
+bool isBidiControl(const unicode_t unicode) noexcept;       //! a bidirectional formatting control character
 bool isBreakingWhite(const unicode_t unicode) noexcept;     //! a breaking white space character
 bool isTrivialWhite(const unicode_t unicode) noexcept;      //! a trivial white space character
 
@@ -0,0 +1,449 @@
+
+//  SuiteUTF
+//  Original design 20102016; maintained and extended 20242025.
+//  Copyright (c) 20102025 Ritchie Brannan.
+//  MIT License. See LICENSE.txt. Project history: docs/History.md.
+//
+//  File:   utf_bulk.h
+//  Author: Ritchie Brannan
+//  Date:   18 Oct 26
+//  
+//  Description:
+//  
+//      Bulk UTF buffer processing built on the toolkit handlers.
+//  
+//  Notes:
+//  
+//      The bulk functions process whole utf_text buffers rather than single code-points. Each function has exactly
+//      the same code-point semantics as the equivalent loop over the IUTFTK handler functions, the bulk functions
+//      only add fast paths for common cases (for example runs of plain ASCII between ASCII compatible sub-types).
+//  
+//      Source and destination offsets are advanced past the data that was processed, allowing the functions to be
+//      resumed after a WriteOverflow by emptying or replacing the destination buffer.
+//  
+//      Chunk functions:
+//  
+//          getChunk() and readChunk() split a buffer into chunks at boundaries which are safe for independent
+//          processing: a chunk never ends inside a code-point, between the halves of a surrogate pair or between
+//          the halves of a { 0x0d, 0x0a } or { 0x0a, 0x0d } line-feed pairing. Processing the chunks separately
+//          produces the same result as processing the whole buffer.
+//  
+//          The boundaries are found without decoding from the start of the buffer, so the chunks of a buffer can
+//          be planned cheaply and then processed in parallel.
+
+#pragma once
+
+#ifndef __UTF_BULK_INCLUDED__
+#define __UTF_BULK_INCLUDED__
+
+#include "utf_toolkit.h"
+
+namespace unicode
+{
+
+namespace utf
+{
+
+namespace bulk
+{
+
+// ==== bulk transcoding functions ====
+
+/// output store mode for the bulk transcoding functions
+enum class StoreMode : uint8_t { Automatic = 0, Cached, NonTemporal };
+
+/// source size in bytes at or above which StoreMode::Automatic uses non-temporal stores
+constexpr uint32_t kNonTemporalThreshold = (32u << 20);
+
+//  Notes:
+//
+//      The transcode() and repair() functions read code-points from src using the 'from' handler and write them to
+//      dst using the 'to' handler. When use_nlf is true the code-points are read using getNLF() so that all the
+//      line-feed variants are written as 0x0a.
+//
+//      Both functions stop:
+//
+//          at the end of src (the return value will not include ReadExhausted),
+//          when the next code-point would overflow dst (WriteOverflow, src is left at the code-point),
+//          on a truncated sequence (ReadTruncated, src is left at the start of the truncated sequence).
+//
+//      transcode() also stops on any decode or encode error, src is left at the failing code-point.
+//
+//      repair() replaces code-points which fail to decode, fail to encode or for which use_replacement_character()
+//      is true with U+FFFD, or with '?' if the 'to' handler cannot encode U+FFFD. The repairs count is set to the
+//      number of code-points replaced. Truncated sequences are not repaired as more data may follow in a stream.
+//
+//      The return value accumulates the warnings of all the code-points transcoded and the errors that stopped
+//      the function. The errors of repaired code-points are not included.
+//
+//      The store mode selects how the output is written. StoreMode::NonTemporal writes the output with streaming
+//      stores that bypass the cache (followed by a store fence before returning) and prefetches the input without
+//      polluting the cache, so very large transcodes do not evict the working sets of other processes. The output
+//      is identical in all modes. StoreMode::Automatic uses non-temporal stores when the remaining source is at
+//      least kNonTemporalThreshold bytes. Non-temporal stores are only used on SSE2 capable targets, other targets
+//      always use cached stores.
+
+[[nodiscard]] toolkit::cp_errors transcode(const toolkit::IUTFTK& from, utf_text& src, const toolkit::IUTFTK& to, utf_text& dst, const bool use_nlf = false, const StoreMode store = StoreMode::Automatic) noexcept;
+[[nodiscard]] toolkit::cp_errors repair(const toolkit::IUTFTK& from, utf_text& src, const toolkit::IUTFTK& to, utf_text& dst, uint32_t& repairs, const bool use_nlf = false, const StoreMode store = StoreMode::Automatic) noexcept;
+
+//  Notes:
+//
+//      Between the UTF16 family (UTF16 and UCS2) and the UTF32 family (UTF32, UCS4, CESU32 and CESU4) transcode()
+//      and repair() convert runs of BMP code-points with vectorised kernels and combine or split surrogate pairs
+//      directly, any other code-point is passed to the handlers. The results are identical to the handler loop.
+//
+//      readCodePoints() reads code-points from src using the handler and stores them in the dst array, count is set
+//      to the number of code-points stored. It stops at the end of src, when dst is full (WriteOverflow), on a
+//      truncated sequence (ReadTruncated) or on any decode error, src is left at the first code-point not stored.
+//
+//      writeCodePoints() writes the code-points of the src array to dst using the handler, consumed is set to the
+//      number of code-points written. It stops on any encode error (including WriteOverflow) at the failing
+//      code-point.
+//
+//      Both return the warnings of all the code-points processed and the error that stopped them, exactly as the
+//      equivalent loops over IUTFTK::get() and IUTFTK::set() (the surrogate pair rules of the UTF16 and UCS2
+//      sub-types are unchanged). The UTF16 family handlers use the same kernels as transcode().
+
+[[nodiscard]] toolkit::cp_errors readCodePoints(const toolkit::IUTFTK& handler, utf_text& src, unicode_t* const dst, const uint32_t capacity, uint32_t& count) noexcept;
+[[nodiscard]] toolkit::cp_errors writeCodePoints(const toolkit::IUTFTK& handler, const unicode_t* const src, const uint32_t count, uint32_t& consumed, utf_text& dst) noexcept;
+
+//  Notes:
+//
+//      decodePermissive() reads code-points from src like readCodePoints() but does not stop on decode errors. A
+//      code-point which fails to decode is stored as the value the handler returns for it (the first byte of the
+//      sequence) and src is advanced by the bytes the handler consumed, so the sequences are exactly those of the
+//      IUTFTK::get() loop: the permissive UTF8 sub-types coalesce an invalid lead byte with every byte up to the next
+//      legal lead byte, the ns and st sub-types stop at the problem byte. failures is set to the number of these
+//      code-points and their errors are not included in the result (their warnings are).
+//
+//      If offsets is not null it must hold capacity entries and receives the byte offset in src.buffer of each
+//      code-point stored. It stops at the end of src, when dst is full (WriteOverflow) or on a truncated sequence
+//      (ReadTruncated, never skipped as more data may follow in a stream), src is left at the first code-point not
+//      stored.
+//
+//      For the UTF8 family sub-types clean text is found 64 bytes at a time with the validate() block masks and
+//      decoded without calling the handler, the handler is only used in the regions the block scan rejects.
+
+[[nodiscard]] toolkit::cp_errors decodePermissive(const toolkit::IUTFTK& handler, utf_text& src, unicode_t* const dst, uint32_t* const offsets, const uint32_t capacity, uint32_t& count, uint32_t& failures) noexcept;
+
+//  Notes:
+//
+//      encodedSize() returns the bytes needed to encode the src array with the handler (the sum of IUTFTK::len() over
+//      the array) and sets unencodable to the number of code-points for which len() is 0. If mask is not null it must
+//      hold (count + 7) / 8 bytes, bit (index & 7) of mask[index >> 3] is set for each unencodable code-point and
+//      cleared for the others. The UTF8, UTF16, UTF32, BYTE and ASCII families are summed 4 code-points at a time
+//      with vector compares, the other sub-types call len() for each code-point.
+
+[[nodiscard]] uint64_t encodedSize(const toolkit::IUTFTK& handler, const unicode_t* const src, const uint32_t count, uint32_t& unencodable, uint8_t* const mask = nullptr) noexcept;
+
+// ==== compact storage functions ====
+
+/// fixed width code-point storage (the buffer is owned by the caller)
+struct compact_text
+{
+    uint8_t*    buffer; //! code-point array (host byte order, aligned to the width)
+    uint32_t    count;  //! code-point count
+    uint32_t    width;  //! bytes per code-point: 1 (U+0000 to U+00FF), 2 (U+0000 to U+FFFF) or 4
+};
+
+//  Notes:
+//
+//      A compact_text stores each code-point of a string in the narrowest fixed width that holds all of them:
+//      1 byte when every code-point is representable as a BYTE (Latin-1) value, 2 bytes when every code-point is in
+//      the BMP and 4 bytes otherwise, so any code-point can be indexed in O(1). Lone surrogates accepted by the
+//      handler are stored as their code-point values.
+//
+//      measureCompact() reads the text once, returning the code-point count and the width needed. Runs of plain
+//      ASCII (ASCII compatible sub-types) and of plain BMP code-units (UTF16 and UTF32 families) are scanned a word
+//      or a vector at a time. The buffer required is count * width bytes.
+//
+//      makeCompact() decodes the text into the buffer using the width given (normally the measured width, a wider
+//      width may be used to keep the tables of a set of strings uniform). It fails with WriteOverflow if the buffer
+//      is too small and NotEncodable if a code-point does not fit in the width. compact.count is set to the number
+//      of code-points stored.
+//
+//      writeCompact() encodes the code-points from index onwards to dst using the handler, index is advanced past
+//      the code-points written. It stops on any encode error (including WriteOverflow) at the failing code-point.
+//      Runs of ASCII are copied directly for ASCII compatible sub-types and 4 byte storage uses writeCodePoints().
+//
+//      All of the functions return the warnings of the code-points processed and the error that stopped them,
+//      exactly as the equivalent loops over IUTFTK::get() and IUTFTK::set().
+
+[[nodiscard]] toolkit::cp_errors measureCompact(const toolkit::IUTFTK& handler, const utf_text& text, uint32_t& count, uint32_t& width) noexcept;
+[[nodiscard]] toolkit::cp_errors makeCompact(const toolkit::IUTFTK& handler, const utf_text& text, const uint32_t width, uint8_t* const buffer, const uint32_t capacity, compact_text& compact) noexcept;
+[[nodiscard]] toolkit::cp_errors writeCompact(const compact_text& compact, uint32_t& index, const toolkit::IUTFTK& handler, utf_text& dst) noexcept;
+
+/// returns the code-point at the index (the index must be less than compact.count)
+inline [[nodiscard]] unicode_t compactAt(const compact_text& compact, const uint32_t index) noexcept
+{
+    return ((compact.width == 1) ? compact.buffer[index] :
+        ((compact.width == 2) ? reinterpret_cast<const uint16_t*>(compact.buffer)[index] : reinterpret_cast<const unicode_t*>(compact.buffer)[index]));
+}
+
+// ==== bulk validation functions ====
+
+/// diagnostic masks selecting the warnings reported by validate() (errors are always reported)
+using toolkit::kAllDiagnostics;
+using toolkit::kNoDiagnostics;
+
+//  Notes:
+//
+//      validate() reads code-points from text using the handler until the end of the buffer or the first error,
+//      accumulating the warnings of every code-point read. The result is the same as IUTFTK::validate() but the
+//      text offset is advanced, so on an error text.offset is left at the start of the failing code-point (the
+//      position of a truncated sequence is reported with ReadTruncated). The result will not include ReadExhausted.
+//
+//      The diagnostics mask selects the warnings included in the result, the errors (and so where validation stops)
+//      do not depend on it. Warnings which are not requested are not computed where that can be avoided: for the
+//      UTF8 sub-types, runs of well-formed multi-byte sequences are checked without calling the handler, and unless
+//      NonCharacter or Supplementary is requested no per code-point classification is done for them. The remaining
+//      code-points are read with the masked IUTFTK::get(), which skips the warnings which cannot change the errors.
+//
+//      For all of the UTF8 family sub-types the text is first checked in 64 byte blocks using byte masks, including
+//      the { 0xc0, 0x80 } nulls of the Java sub-types and the surrogate pairs of the CESU sub-types. A block scan
+//      stops at the first sequence it cannot take and the remainder is read as above; after a short block run the
+//      block scan is skipped for a while so that text dense with such sequences is not checked twice.
+
+[[nodiscard]] toolkit::cp_errors validate(const toolkit::IUTFTK& handler, utf_text& text, const toolkit::cp_errors diagnostics = kAllDiagnostics) noexcept;
+
+// ==== scatter/gather functions ====
+
+/// scatter/gather list of text fragments (as an iovec array, the fragment array and buffers are not owned)
+struct text_fragments
+{
+    utf_text*   fragments;  //! fragment array (each fragment is processed from its offset to its length)
+    uint32_t    count;      //! number of fragments
+    uint32_t    index;      //! current fragment
+};
+
+//  Notes:
+//
+//      The scatter/gather functions are transcode(), readCodePoints() and validate() over lists of fragments. The
+//      results, warnings and stopping rules are the same as for the concatenated fragments: on a stop the list index
+//      and the fragment offsets are left at the code-point the single buffer function would leave the offset at.
+//      Empty fragments (which may have a null buffer) are skipped and the fragment offsets need not be aligned.
+//
+//      The fragments are processed in place by the single buffer functions. Only a code-point which spans fragments
+//      (or a trailing high surrogate, CR or LF which may pair with the next fragment) is gathered into a small temporary
+//      buffer, and only a code-point which does not fit in the rest of the current destination fragment is encoded
+//      to a temporary buffer and scattered across the destination fragments. The destination fragments of
+//      transcode() are filled in order, so the used part of each fragment (up to its offset) can be passed
+//      directly to writev().
+
+[[nodiscard]] toolkit::cp_errors transcode(const toolkit::IUTFTK& from, text_fragments& src, const toolkit::IUTFTK& to, text_fragments& dst, const bool use_nlf = false, const StoreMode store = StoreMode::Automatic) noexcept;
+[[nodiscard]] toolkit::cp_errors readCodePoints(const toolkit::IUTFTK& handler, text_fragments& src, unicode_t* const dst, const uint32_t capacity, uint32_t& count) noexcept;
+[[nodiscard]] toolkit::cp_errors validate(const toolkit::IUTFTK& handler, text_fragments& text, const toolkit::cp_errors diagnostics = kAllDiagnostics) noexcept;
+
+// ==== incremental validation functions ====
+
+/// incremental validation block summary
+struct validation_block
+{
+    toolkit::cp_errors  errors; //! accumulated errors and warnings of the code-points starting in the block
+    uint32_t            start;  //! offset of the first code-point starting in the block (beyond the block if there is none)
+};
+
+/// incremental validation state (the block summaries are owned by the caller)
+struct validation_state
+{
+    validation_block*   blocks;     //! block summaries, one per (1 << shift) bytes of text
+    uint32_t            capacity;   //! number of block summaries available
+    uint32_t            shift;      //! log2 of the block size (6 to 31)
+    uint32_t            count;      //! number of block summaries in use
+    uint32_t            length;     //! size of the text validated
+    toolkit::cp_errors  errors;     //! accumulated errors and warnings of the whole text
+};
+
+//  Notes:
+//
+//      validateBlocks() validates the text from text.offset to text.length and records a summary for each block of
+//      (1 << shift) bytes: the accumulated errors and warnings of the code-points starting in the block and the offset
+//      of the first of them. Offsets are relative to text.offset. Unlike validate(), decoding continues after an error
+//      (skipping at least one code-unit) so every block containing an error is flagged, the blocks with error() set
+//      form the error map of the text. state.errors is the accumulation of all the block summaries.
+//
+//      revalidateRange() updates the state after the bytes in [editStart, editEnd) have been modified in place. The
+//      decoding restarts at a recorded code-point boundary before the edit (far enough before it that no earlier
+//      code-point can have read the modified bytes) and stops at the first block after the edit where the decoding
+//      is back in step with the recorded boundaries, so the cost depends on the size of the edit and not the size of
+//      the text. If the text length has changed every block from the edit onwards is validated again.
+//
+//      Both functions return state.errors, or InvalidBuffer if the state is not usable and WriteOverflow if there are
+//      not enough block summaries for the text (state.count is then 0).
+
+[[nodiscard]] toolkit::cp_errors validateBlocks(const toolkit::IUTFTK& handler, const utf_text& text, validation_state& state) noexcept;
+[[nodiscard]] toolkit::cp_errors revalidateRange(const toolkit::IUTFTK& handler, const utf_text& text, const uint32_t editStart, const uint32_t editEnd, validation_state& state) noexcept;
+
+// ==== position tracking reader ====
+
+/// text position (all the values are zero based)
+struct text_position
+{
+    uint32_t    offset; //! byte offset into the buffer
+    uint32_t    line;   //! line index (counted using the getNLF() line-feed rules)
+    uint32_t    column; //! code-point index into the line
+    uint32_t    units;  //! UTF16 code-unit index into the line
+};
+
+//  Notes:
+//
+//      tracking_reader wraps a handler and a buffer and maintains the position of the next code-point as it reads.
+//      Lines are counted using the getNLF() rules, so all the line-feed variants (including the { 0x0d, 0x0a } and
+//      { 0x0a, 0x0d } pairings) end a line. Code-points above U+FFFF count as two UTF16 code-units.
+//
+//      read() has the same semantics as IUTFTK::readNLF(). A code-point which fails to decode but is skipped by the
+//      handler counts as a single column (as it would be displayed as U+FFFD).
+//
+//      advance() reads code-points until the position reaches the specified byte offset (a final line-feed pairing
+//      may extend beyond it), stopping at the start of the first code-point which fails to decode. Plain ASCII is
+//      counted a word at a time for ASCII compatible sub-types. The result will not include ReadExhausted.
+
+/// code-point reader tracking the byte offset, line and column
+class tracking_reader
+{
+public:
+    tracking_reader(const toolkit::IUTFTK& handler, const utf_text& text) noexcept : tk(&handler) { reset(text); }
+    void reset(const utf_text& text) noexcept { source = text; pos = { text.offset, 0, 0, 0 }; }
+    const toolkit::IUTFTK& handler() const noexcept { return *tk; }
+    const utf_text& text() const noexcept { return source; }
+    const text_position& position() const noexcept { return pos; }
+    [[nodiscard]] toolkit::cp_errors read(unicode_t& unicode) noexcept;
+    [[nodiscard]] toolkit::cp_errors advance(const uint32_t offset) noexcept;
+private:
+    const toolkit::IUTFTK*  tk;
+    utf_text                source;
+    text_position           pos;
+};
+
+// ==== record splitting functions ====
+
+/// delimited record format (CSV, TSV, ...)
+struct record_format
+{
+    unicode_t   delimiter;  //! field delimiter (',' for CSV, 0x09 for TSV)
+    unicode_t   quote;      //! quote character ('"' for CSV, 0 if fields are never quoted)
+};
+
+/// delimited record field
+struct record_field
+{
+    utf_text    text;       //! zero offset view of the field (excluding the enclosing quotes of a quoted field)
+    bool        quoted;     //! the field was quoted (doubled quotes in the text are escaped quotes)
+};
+
+//  Notes:
+//
+//      getRecord() and readRecord() split the record starting at text.offset into fields without copying, in the
+//      same way that getLine() and readLine() split lines. Records end at a line-feed using the getNLF() rules
+//      (so { 0x0d, 0x0a } and { 0x0a, 0x0d } pairings are a single line-feed) or at the end of the buffer, line-feeds
+//      and delimiters between quotes are part of the field. The delimiter and quote must not be line-feed variants.
+//
+//      Quoting follows the usual CSV convention: a delimiter or line-feed is only structural if it is preceded by an
+//      even number of quotes in the record. A field which starts and ends with a quote and only contains doubled
+//      quotes in between is returned without the enclosing quotes and with quoted set, unquoteField() removes the
+//      doubled quotes. Any other field containing quotes is returned as it is and IrregularForm is reported.
+//
+//      count is set to the number of fields in the record and bytes to the size of the record including the
+//      line-feed. The result accumulates the warnings of all the code-points in the record and includes
+//      ReadExhausted if the record ends at the end of the buffer (count is 0 if the buffer is already exhausted).
+//
+//      On an error count and bytes are set to 0:
+//
+//          a decode error is reported as returned by the handler,
+//          an open quote at the end of the buffer is reported with ReadTruncated (more data may follow),
+//          more than 'capacity' fields is reported with WriteOverflow (count is set to the number of fields needed).
+//
+//      For ASCII compatible sub-types with ASCII delimiter and quote characters the structural characters are found
+//      64 bytes at a time using bit masks (with a prefix-XOR of the quote mask to exclude quoted text), and the
+//      record is then validated with the bulk validator. Overlong (and modified) UTF8 encodings decode to the same
+//      characters as their ASCII forms, so a record containing them is split by decoding every code-point and the
+//      fields are the same whichever path is taken.
+
+[[nodiscard]] toolkit::cp_errors getRecord(const toolkit::IUTFTK& handler, const utf_text& text, const record_format& format, record_field* const fields, const uint32_t capacity, uint32_t& count, uint32_t& bytes) noexcept;
+[[nodiscard]] toolkit::cp_errors readRecord(const toolkit::IUTFTK& handler, utf_text& text, const record_format& format, record_field* const fields, const uint32_t capacity, uint32_t& count) noexcept;
+[[nodiscard]] toolkit::cp_errors unquoteField(const toolkit::IUTFTK& handler, const record_field& field, const unicode_t quote, utf_text& dst) noexcept;
+
+// ==== white space functions ====
+
+//  Notes:
+//
+//      The white space functions split and trim text at breaking white space code-points (as isBreakingWhite()).
+//      Code-points which fail to decode are treated as text, the text is not otherwise validated. The results are
+//      zero offset utf_text views referencing the text buffer (as getLine() returns).
+//
+//      getToken() skips any white space at text.offset and returns the following run of text as the token, bytes
+//      is set to the size up to the end of the token. If only white space remains the result includes ReadExhausted,
+//      the token is empty and bytes includes the remaining white space.
+//
+//      splitOnWhite() sets count to the number of tokens in the text and stores up to 'capacity' tokens, WriteOverflow
+//      is reported if there are more tokens than 'capacity'.
+//
+//      trim(), trimStart() and trimEnd() return the text without the leading and/or trailing white space.
+//
+//      collapseWhite() copies src to dst replacing each run of white space with a single space. The offsets are
+//      advanced past the data processed and the function can be resumed after a WriteOverflow, however a run of
+//      white space which is split between two calls (or two src buffers) is written as two spaces.
+//
+//      For the UTF8 family and the single byte sub-types the text is scanned 16 bytes at a time and only the bytes
+//      which can start a multi-byte white space code-point are decoded (for the UTF8 family 0xc2, 0xe1 to 0xe3 and
+//      the overlong lead bytes). trimEnd() scans backwards for the last byte which cannot be part of a white space
+//      code-point and only decodes forwards from there.
+
+[[nodiscard]] toolkit::cp_errors getToken(const toolkit::IUTFTK& handler, const utf_text& text, utf_text& token, uint32_t& bytes) noexcept;
+[[nodiscard]] toolkit::cp_errors readToken(const toolkit::IUTFTK& handler, utf_text& text, utf_text& token) noexcept;
+[[nodiscard]] toolkit::cp_errors splitOnWhite(const toolkit::IUTFTK& handler, const utf_text& text, utf_text* const tokens, const uint32_t capacity, uint32_t& count) noexcept;
+[[nodiscard]] toolkit::cp_errors trim(const toolkit::IUTFTK& handler, const utf_text& text, utf_text& trimmed) noexcept;
+[[nodiscard]] toolkit::cp_errors trimStart(const toolkit::IUTFTK& handler, const utf_text& text, utf_text& trimmed) noexcept;
+[[nodiscard]] toolkit::cp_errors trimEnd(const toolkit::IUTFTK& handler, const utf_text& text, utf_text& trimmed) noexcept;
+[[nodiscard]] toolkit::cp_errors collapseWhite(const toolkit::IUTFTK& handler, utf_text& src, utf_text& dst) noexcept;
+
+// ==== log sanitizing functions ====
+
+/// sanitizeForLog() handling of the flagged code-points and malformed sequences
+enum class LogPolicy : uint8_t
+{
+    Escape = 0, //  write \u{...} (hexadecimal) for a flagged code-point and \xNN for each byte of a malformed sequence
+    Replace,    //  write U+FFFD (or '?' if the sub-type cannot encode U+FFFD)
+    Drop        //  write nothing
+};
+
+//  Notes:
+//
+//      sanitizeForLog() copies src to dst (both in the handler's encoding) for writing untrusted text to a log. The
+//      C0, C1 and delete controls (as isCC(), including tab and line-feed), non-characters, surrogates and bidi
+//      controls (as isBidiControl()) are flagged, as are malformed sequences: sequences which fail to decode
+//      (including a truncated sequence at the end of src), irregular, overlong or extended UTF8 encodings and
+//      code-points above U+10FFFF. Each flagged code-point or malformed sequence is escaped, replaced or dropped
+//      as the policy specifies and the clean runs between them are copied unchanged. Backslashes are not escaped.
+//
+//      The offsets are advanced past the data processed. On a WriteOverflow src is left at the first code-point
+//      not written (escapes and replacements are never split) and the call can be resumed with a new destination.
+//      A malformed sequence can be a run of any length (the coalescing UTF8 sub-types and the skipping single byte
+//      sub-types return a run of invalid bytes as one sequence), every byte of it is escaped and the whole escape
+//      must fit in dst.
+//
+//      For the UTF8 family and the single byte sub-types the text is scanned 16 bytes at a time and printable ASCII
+//      is skipped, for the UTF8 family well-formed 2 and 3 byte sequences are decoded inline and only the other
+//      sequences are decoded with the handler. The other sub-types decode every code-point.
+
+[[nodiscard]] toolkit::cp_errors sanitizeForLog(const toolkit::IUTFTK& handler, utf_text& src, utf_text& dst, const LogPolicy policy = LogPolicy::Escape) noexcept;
+
+// ==== bulk chunk planning functions ====
+
+//  Notes:
+//
+//      The chunk begins at text.offset and will be at least 'size' bytes long unless the end of the buffer is
+//      reached first. If no safe boundary is found after 'size' bytes the chunk extends to the end of the buffer.
+//
+//      The chunk is returned as a zero offset utf_text referencing the text buffer (as getLine() does).
+
+[[nodiscard]] toolkit::cp_errors getChunk(const toolkit::IUTFTK& handler, const utf_text& text, utf_text& chunk, uint32_t& bytes, const uint32_t size) noexcept;
+[[nodiscard]] toolkit::cp_errors readChunk(const toolkit::IUTFTK& handler, utf_text& text, utf_text& chunk, const uint32_t size) noexcept;
+
+};  //  namespace bulk
+
+};  //  namespace utf
+
+};  //  namespace unicode
+
+#endif  //  #ifndef __UTF_BULK_INCLUDED__
@@ -0,0 +1,105 @@
+
+//  SuiteUTF
+//  Original design 20102016; maintained and extended 20242025.
+//  Copyright (c) 20102025 Ritchie Brannan.
+//  MIT License. See LICENSE.txt. Project history: docs/History.md.
+//
+//  File:   utf_cache.h
+//  Author: Ritchie Brannan
+//  Date:   18 Oct 26
+//  
+//  Description:
+//  
+//      Bounded memo cache of transcoded strings in caller supplied memory.
+//  
+//  Notes:
+//  
+//      This header is not included by suite_utf.h.
+//  
+//      transcode_cache is a set associative cache: each string is hashed (crc_ccitt_false() of the bytes, mixed with
+//      the length, the sub-types and the use_nlf flag) to one of a power of 2 number of sets and can be stored in
+//      any of the 'ways' slots of that set, the least recently used slot of the set is replaced. Each slot holds
+//      the source bytes, the transcoded bytes and the transcode() result, a hit is verified by comparing the source
+//      bytes, so hash collisions never return the wrong text.
+//  
+//      Lookups are lock-free: each slot has a sequence number which is odd while the slot is written, a reader
+//      copies the cached bytes to dst and only uses them if the sequence number was even and unchanged. Inserts
+//      (and clear()) take a per-set spin lock, so writers only contend with writers using the same set. The cache
+//      never allocates memory, the sets and slots are constructed in the memory passed to init().
+
+#pragma once
+
+#ifndef __UTF_CACHE_INCLUDED__
+#define __UTF_CACHE_INCLUDED__
+
+#include "utf_toolkit.h"
+#include <atomic>
+#include <cstddef>
+
+namespace unicode
+{
+
+namespace utf
+{
+
+namespace cache
+{
+
+/// memo cache counters (summed over the sets)
+struct cache_statistics
+{
+    uint64_t    hits;       //! lookups returning cached text
+    uint64_t    misses;     //! lookups which transcoded the text
+    uint64_t    inserts;    //! strings stored
+    uint64_t    evictions;  //! stored strings replaced by an insert
+};
+
+/// bounded memo cache of whole string transcodes
+class transcode_cache
+{
+public:
+    static constexpr uint32_t   kAlignment = 64;    //! required alignment of the memory and the slot size
+    static constexpr uint32_t   kMaxWays = 16;      //! maximum number of slots per set
+
+    /// memory required for a cache (0 if the layout is invalid)
+    static [[nodiscard]] size_t memorySize(const uint32_t sets, const uint32_t ways, const uint32_t slotSize) noexcept;
+
+    /// largest source plus transcoded size which fits in a slot of slotSize bytes (0 if the slot size is invalid)
+    static [[nodiscard]] uint32_t slotCapacity(const uint32_t slotSize) noexcept;
+
+    transcode_cache() noexcept;
+    transcode_cache(const transcode_cache&) = delete;
+    transcode_cache& operator=(const transcode_cache&) = delete;
+
+    /// sets the cache up in the memory (sets must be a power of 2, slotSize a multiple of kAlignment and the memory kAlignment aligned)
+    [[nodiscard]] bool init(void* const memory, const size_t size, const uint32_t sets, const uint32_t ways, const uint32_t slotSize) noexcept;
+
+    /// bulk::transcode() of the whole of src, using and updating the cache
+    [[nodiscard]] toolkit::cp_errors transcode(const toolkit::IUTFTK& from, utf_text& src, const toolkit::IUTFTK& to, utf_text& dst, const bool use_nlf = false) noexcept;
+
+    /// removes all the stored strings (the counters are not reset)
+    void clear() noexcept;
+
+    [[nodiscard]] cache_statistics statistics() const noexcept;
+    [[nodiscard]] bool isValid() const noexcept { return (m_sets != nullptr); }
+private:
+    struct cache_set;
+    struct cache_slot;
+    [[nodiscard]] cache_set& getSet(const uint32_t index) const noexcept;
+    [[nodiscard]] cache_slot& getSlot(const cache_set& set, const uint32_t way) const noexcept;
+    [[nodiscard]] bool lookup(cache_set& set, const uint32_t hash, const uint32_t key, const utf_text& src, utf_text& dst, toolkit::cp_errors& errors) const noexcept;
+    void insert(cache_set& set, const uint32_t hash, const uint32_t key, const uint8_t* const source, const uint32_t sourceSize, const uint8_t* const output, const uint32_t outputSize, const toolkit::cp_errors errors) noexcept;
+    uint8_t*    m_sets;         //  set memory
+    uint32_t    m_setMask;      //  number of sets - 1
+    uint32_t    m_ways;         //  slots per set
+    uint32_t    m_slotSize;     //  slot size in bytes
+    uint32_t    m_setSize;      //  set size in bytes
+};
+
+};  //  namespace cache
+
+};  //  namespace utf
+
+};  //  namespace unicode
+
+#endif  //  #ifndef __UTF_CACHE_INCLUDED__
@@ -0,0 +1,135 @@
+
+//  SuiteUTF
+//  Original design 20102016; maintained and extended 20242025.
+//  Copyright (c) 20102025 Ritchie Brannan.
+//  MIT License. See LICENSE.txt. Project history: docs/History.md.
+//
+//  File:   utf_container.h
+//  Author: Ritchie Brannan
+//  Date:   18 Oct 26
+//  
+//  Description:
+//  
+//      Self-describing binary container for encoded text.
+//  
+//  Notes:
+//  
+//      A container is a fixed size header, optional sampled indexes and the raw encoded payload. The header records
+//      the sub-type, the payload length, the code-point count, the UTF16 length, the line count, the accumulated
+//      warnings and the crc_ccitt_false() of the payload, so a reader can trust the header and use the payload
+//      without validating, counting or hashing it again.
+//  
+//      Layout (all values little endian):
+//  
+//          offset  size    field
+//          0       4       magic "SUTF"
+//          4       2       version (1)
+//          6       1       UTF_SUB_TYPE of the payload
+//          7       1       reserved (0)
+//          8       4       payload offset (the header, index and padding size)
+//          12      4       payload length in bytes
+//          16      4       code-point count
+//          20      4       UTF16 length in code-units (code-points above U+FFFF count as 2)
+//          24      4       line count (line-feeds counted using the getNLF() rules, plus 1)
+//          28      4       cp_errors warnings of the payload
+//          32      4       index interval (0 if there are no indexes)
+//          36      4       code-point index entry count
+//          40      4       line index entry count
+//          44      2       crc_ccitt_false() of the payload
+//          46      2       crc_ccitt_false() of bytes 0 to 45 and the indexes
+//          48              code-point index: byte offset of code-point (n * interval) for n = 1, 2, ...
+//                          line index: byte offset of the start of line (n * interval) for n = 1, 2, ...
+//                          payload
+//  
+//      Only text which decodes without errors can be stored, so the counts are exact and the indexes can be used
+//      with the step() and getNLF() handler functions. Lines are numbered from 0.
+//  
+//      openContainer() checks the header and the indexes (using the header crc) but does not read the payload unless
+//      verify is true, when the payload crc, counts, warnings and indexes are all recalculated and compared.
+
+#pragma once
+
+#ifndef __UTF_CONTAINER_INCLUDED__
+#define __UTF_CONTAINER_INCLUDED__
+
+#include "utf_toolkit.h"
+
+namespace unicode
+{
+
+namespace utf
+{
+
+namespace container
+{
+
+/// container format constants
+constexpr uint32_t kContainerMagic = 0x46545553u;   //  "SUTF" read as a little endian value
+constexpr uint32_t kContainerVersion = 1;
+constexpr uint32_t kContainerHeaderSize = 48;
+
+/// container metadata
+struct container_info
+{
+    toolkit::UTF_SUB_TYPE   utfSubType;     //! sub-type of the payload
+    uint32_t                length;         //! payload length in bytes
+    uint32_t                code_points;    //! code-point count
+    uint32_t                utf16_length;   //! UTF16 length in code-units
+    uint32_t                line_count;     //! line count
+    toolkit::cp_errors      warnings;       //! accumulated warnings of the payload
+    uint32_t                interval;       //! index interval (0 if there are no indexes)
+    uint32_t                point_samples;  //! code-point index entry count
+    uint32_t                line_samples;   //! line index entry count
+    uint16_t                crc;            //! crc_ccitt_false() of the payload
+};
+
+/// opened container view (the container buffer is not owned by the view)
+struct container_view
+{
+    container_info          info;           //! header metadata
+    utf_text                text;           //! payload view
+    const uint8_t*          point_index;    //! code-point index entries (little endian uint32_t values)
+    const uint8_t*          line_index;     //! line index entries (little endian uint32_t values)
+};
+
+// ==== container writing functions ====
+
+//  Notes:
+//
+//      describeText() calculates the metadata of the text from text.offset to text.length. It fails on the first
+//      decode error (the error is returned and the info is not valid), otherwise the warnings are returned. An
+//      interval of 0 omits the indexes.
+//
+//      containerSize() returns the size of the container for the metadata, or 0 if it would exceed 4GB.
+//
+//      writeContainer() writes the container for the text at dst.offset and advances dst.offset past it. The info
+//      must be the result of describeText() for the same text. The destination is not changed on WriteOverflow.
+//      Custom sub-types are rejected (their ids are assigned at run time and cannot be stored).
+
+[[nodiscard]] toolkit::cp_errors describeText(const toolkit::IUTFTK& handler, const utf_text& text, const uint32_t interval, container_info& info) noexcept;
+uint32_t containerSize(const container_info& info) noexcept;
+[[nodiscard]] toolkit::cp_errors writeContainer(const toolkit::IUTFTK& handler, const utf_text& text, const container_info& info, utf_text& dst) noexcept;
+
+// ==== container reading functions ====
+
+//  Notes:
+//
+//      openContainer() opens the container at src.offset. A container which is shorter than its header describes
+//      returns ReadTruncated, a header which is not valid (or, when verify is true, does not match the payload)
+//      returns InvalidBuffer and a sub-type which is not available in this build returns NotDecodable.
+//
+//      seekCodePoint() and seekLine() return the payload byte offset of a code-point or the start of a line, using
+//      the indexes to limit the scan to one interval. An index beyond the end returns InvalidOffset, the code-point
+//      count and line count are valid arguments (the offset is the payload length).
+
+[[nodiscard]] toolkit::cp_errors openContainer(const utf_text& src, container_view& view, const bool verify = false) noexcept;
+[[nodiscard]] toolkit::cp_errors seekCodePoint(const container_view& view, const uint32_t index, uint32_t& offset) noexcept;
+[[nodiscard]] toolkit::cp_errors seekLine(const container_view& view, const uint32_t line, uint32_t& offset) noexcept;
+
+};  //  namespace container
+
+};  //  namespace utf
+
+};  //  namespace unicode
+
+#endif  //  #ifndef __UTF_CONTAINER_INCLUDED__
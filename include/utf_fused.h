@@ -0,0 +1,306 @@
+
+//  SuiteUTF
+//  Original design 20102016; maintained and extended 20242025.
+//  Copyright (c) 20102025 Ritchie Brannan.
+//  MIT License. See LICENSE.txt. Project history: docs/History.md.
+//
+//  File:   utf_fused.h
+//  Author: Ritchie Brannan
+//  Date:   18 Oct 26
+//  
+//  Description:
+//  
+//      Single pass decode, transform and encode pipelines composed at compile time.
+//  
+//  Notes:
+//  
+//      This header is not included by suite_utf.h.
+//  
+//      A fused_pipeline reads the source in blocks of kBlockSize code-points (a 1KB array on the stack, so the block
+//      stays in L1), passes each code-point through every stage in turn, then writes the kept code-points to the
+//      destination and passes the bytes written to the sink. Newline normalisation, control stripping, case folding,
+//      transcoding and hashing are done in one pass over the source with no intermediate buffers.
+//  
+//      The stages are a compile time list, so the calls are inlined into one loop over the block. A stage is any
+//      nothrow copyable type with a 'bool operator()(unicode_t& unicode) noexcept' which may change the code-point
+//      and returns false to drop it. Stages may hold state (nlf_stage remembers a line-feed pairing across blocks
+//      and calls). Lambdas are not copy assignable, so wrap a function pointer or a functor in map_stage or
+//      filter_stage instead.
+//  
+//      A sink is any type with a 'void update(const uint8_t* const data, const uint32_t size) noexcept', crc_sink
+//      continues crc_ccitt_false() over the encoded output.
+//  
+//      run() has the same stopping rules as bulk::transcode():
+//  
+//          at the end of src (the return value will not include ReadExhausted),
+//          when the next kept code-point would overflow dst (WriteOverflow, src is left at the code-point),
+//          on a truncated sequence (ReadTruncated, src is left at the start of the truncated sequence),
+//          on any decode or encode error, src is left at the failing code-point.
+//  
+//      After an error the stage states and the sink have seen exactly the code-points before src, so the call can
+//      be resumed with a new destination. The bytes past dst.offset may have been overwritten.
+
+#pragma once
+
+#ifndef __UTF_FUSED_INCLUDED__
+#define __UTF_FUSED_INCLUDED__
+
+#include "utf_bulk.h"
+#include "text_hash.h"
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace unicode
+{
+
+namespace utf
+{
+
+namespace fused
+{
+
+/// code-points decoded per block
+constexpr uint32_t kBlockSize = 256;
+
+// ==== stages ====
+
+/// line-feed normalisation (as IUTFTK::getNLF(), 0x0b, 0x0c, 0x0d, 0x85, 0x2028, 0x2029, {0x0d, 0x0a} and {0x0a, 0x0d} are all written as 0x0a)
+struct nlf_stage
+{
+    bool operator()(unicode_t& unicode) noexcept
+    {
+        const uint32_t previous = pending;
+        pending = 0;
+        switch (unicode)
+        {
+            case(0x000au): //  line-feed
+            case(0x000du): //  carriage return
+            {
+                if (static_cast<uint32_t>(unicode) == (previous ^ 0x0007u))
+                {   //  the second half of a { 0x0d, 0x0a } or { 0x0a, 0x0d } pairing
+                    return false;
+                }
+                pending = static_cast<uint32_t>(unicode);
+                unicode = 0x000au;
+                return true;
+            }
+            case(0x000bu):  //  vertical tab
+            case(0x000cu):  //  form-feed
+            case(0x0085u):  //  next line
+            case(0x2028u):  //  line separator
+            case(0x2029u):  //  paragraph separator
+            {
+                unicode = 0x000au;
+                return true;
+            }
+            default:
+            {
+                return true;
+            }
+        }
+    }
+    uint32_t    pending = 0;    //  the first half of a possible pairing (0x0a or 0x0d), or 0
+};
+
+/// drops the C0, delete and C1 controls other than tab and line-feed
+struct strip_controls_stage
+{
+    bool operator()(unicode_t& unicode) noexcept
+    {
+        const uint32_t value = static_cast<uint32_t>(unicode);
+        return ((value >= 0x00a0u) || ((value >= 0x0020u) && (value < 0x007fu)) || (value == 0x0009u) || (value == 0x000au));
+    }
+};
+
+/// folds the ASCII upper case letters to lower case
+struct ascii_fold_stage
+{
+    bool operator()(unicode_t& unicode) noexcept
+    {
+        if ((static_cast<uint32_t>(unicode) - 0x0041u) < 26u)
+        {
+            unicode += 0x0020;
+        }
+        return true;
+    }
+};
+
+/// replaces the code-points which are not unicode scalar values (surrogates and values above U+10FFFF)
+struct replace_stage
+{
+    explicit replace_stage(const unicode_t unicode = 0xfffd) noexcept : replacement(unicode) {}
+    bool operator()(unicode_t& unicode) noexcept
+    {
+        const uint32_t value = static_cast<uint32_t>(unicode);
+        if ((value > 0x0010ffffu) || ((value & 0xfffff800u) == 0x0000d800u))
+        {
+            unicode = replacement;
+        }
+        return true;
+    }
+    unicode_t   replacement;
+};
+
+/// maps each code-point with a function (a function pointer or a functor)
+template <typename Function>
+struct map_stage
+{
+    explicit map_stage(const Function& callable) noexcept : function(callable) {}
+    bool operator()(unicode_t& unicode) noexcept
+    {
+        unicode = function(unicode);
+        return true;
+    }
+    Function    function;
+};
+
+/// keeps the code-points for which a function returns true (a function pointer or a functor)
+template <typename Function>
+struct filter_stage
+{
+    explicit filter_stage(const Function& callable) noexcept : function(callable) {}
+    bool operator()(unicode_t& unicode) noexcept
+    {
+        return function(unicode);
+    }
+    Function    function;
+};
+
+// ==== sinks ====
+
+/// discards the output
+struct null_sink
+{
+    void update(const uint8_t* const, const uint32_t) noexcept {}
+};
+
+/// crc_ccitt_false() of the output (continued across calls)
+struct crc_sink
+{
+    void update(const uint8_t* const data, const uint32_t size) noexcept { crc = crc_ccitt_false_update(crc, data, size); }
+    uint16_t    crc = 0xffffu;
+};
+
+// ==== pipeline ====
+
+/// single pass pipeline: decode (from) -> stages -> encode (to) -> sink
+template <typename... Stages>
+class fused_pipeline
+{
+    static_assert(::std::conjunction<::std::is_nothrow_copy_assignable<Stages>...>::value, "fused_pipeline stages must be nothrow copyable (wrap lambdas as function pointers)");
+public:
+    fused_pipeline(const toolkit::IUTFTK& decoder, const toolkit::IUTFTK& encoder, const Stages&... list) noexcept : from(&decoder), to(&encoder), stages(list...), initial(list...) {}
+    [[nodiscard]] toolkit::cp_errors run(utf_text& src, utf_text& dst) noexcept
+    {
+        null_sink sink;
+        return run(src, dst, sink);
+    }
+    template <typename Sink>
+    [[nodiscard]] toolkit::cp_errors run(utf_text& src, utf_text& dst, Sink& sink) noexcept
+    {
+        toolkit::cp_errors errors = (toolkit::get_errors(src, from->unitSize() - 1) | toolkit::get_errors(dst, to->unitSize() - 1));
+        if (errors.error())
+        {
+            return errors;
+        }
+        unicode_t block[kBlockSize];
+        for (;;)
+        {
+            const uint32_t source = src.offset;
+            const uint32_t start = dst.offset;
+            const ::std::tuple<Stages...> saved(stages);
+            uint32_t count = 0;
+            const toolkit::cp_errors read = bulk::readCodePoints(*from, src, block, kBlockSize, count);
+            uint32_t kept = 0;
+            for (uint32_t index = 0; index < count; ++index)
+            {
+                unicode_t unicode = block[index];
+                if (apply(unicode, ::std::index_sequence_for<Stages...>()))
+                {
+                    block[kept++] = unicode;
+                }
+            }
+            uint32_t consumed = 0;
+            const toolkit::cp_errors write = bulk::writeCodePoints(*to, block, kept, consumed, dst);
+            if (write.error())
+            {   //  redo the block one code-point at a time to stop at the code-point which failed
+                src.offset = source;
+                dst.offset = start;
+                stages = saved;
+                const toolkit::cp_errors check = single(src, dst, sink, count);
+                errors |= check;
+                if (check.error())
+                {
+                    return errors;
+                }
+            }
+            else
+            {
+                sink.update(&dst.buffer[start], (dst.offset - start));
+                errors |= (write | read.warnings_only());
+                if (read.error() && !read.any(toolkit::cp_errors::bits::WriteOverflow))
+                {   //  stopped by the source (a full block is not an error)
+                    return (errors | read);
+                }
+            }
+            if ((count == 0) || (src.offset >= src.length))
+            {
+                return errors;
+            }
+        }
+    }
+    void reset() noexcept { stages = initial; }
+private:
+    template <size_t... Index>
+    bool apply(unicode_t& unicode, ::std::index_sequence<Index...>) noexcept
+    {
+        return (... && ::std::get<Index>(stages)(unicode));
+    }
+    template <typename Sink>
+    [[nodiscard]] toolkit::cp_errors single(utf_text& src, utf_text& dst, Sink& sink, const uint32_t count) noexcept
+    {
+        toolkit::cp_errors errors;
+        for (uint32_t index = 0; index < count; ++index)
+        {
+            const uint32_t source = src.offset;
+            const uint32_t start = dst.offset;
+            const ::std::tuple<Stages...> saved(stages);
+            unicode_t unicode = 0;
+            uint32_t decoded = 0;
+            const toolkit::cp_errors read = bulk::readCodePoints(*from, src, &unicode, 1, decoded);
+            if (decoded == 0)
+            {
+                return (errors | read);
+            }
+            if (apply(unicode, ::std::index_sequence_for<Stages...>()))
+            {
+                uint32_t consumed = 0;
+                const toolkit::cp_errors write = bulk::writeCodePoints(*to, &unicode, 1, consumed, dst);
+                if (write.error())
+                {   //  the warnings of the failing code-point are not included (as bulk::transcode())
+                    src.offset = source;
+                    stages = saved;
+                    return (errors | write);
+                }
+                errors |= write;
+                sink.update(&dst.buffer[start], (dst.offset - start));
+            }
+            errors |= read.warnings_only();
+        }
+        return errors;
+    }
+    const toolkit::IUTFTK*      from;
+    const toolkit::IUTFTK*      to;
+    ::std::tuple<Stages...>     stages;
+    ::std::tuple<Stages...>     initial;
+};
+
+};  //  namespace fused
+
+};  //  namespace utf
+
+};  //  namespace unicode
+
+#endif  //  #ifndef __UTF_FUSED_INCLUDED__
@@ -0,0 +1,358 @@
+
+//  SuiteUTF
+//  Original design 20102016; maintained and extended 20242025.
+//  Copyright (c) 20102025 Ritchie Brannan.
+//  MIT License. See LICENSE.txt. Project history: docs/History.md.
+//
+//  File:   utf_pipeline.h
+//  Author: Ritchie Brannan
+//  Date:   18 Oct 26
+//  
+//  Description:
+//  
+//      Bounded lock-free hand-off queues and a threaded stage pipeline for chunked text processing.
+//  
+//  Notes:
+//  
+//      This header requires thread support and is not included by suite_utf.h.
+//  
+//      spsc_queue is a single producer, single consumer ring and mpmc_queue is a multiple producer, multiple
+//      consumer ring (using per-cell sequence numbers). Both have a fixed power of 2 capacity, store their items
+//      inline (no allocation) and never block in tryPush() or tryPop(). push() and pop() spin (yielding the thread)
+//      until they succeed, pop() returns false once the queue has been closed and emptied.
+//  
+//      pipeline connects a source, up to MaxStages - 2 filter stages and a sink with spsc_queues and runs each of
+//      them on its own thread, optionally pinned to a CPU. The items are usually chunk_descriptor values referencing
+//      buffers owned by the caller, so only the descriptors are copied between the stages.
+//  
+//      The queues and pipeline do not allocate memory once constructed, but the std::function stage wrappers and
+//      the threads started by pipeline::run() may allocate.
+
+#pragma once
+
+#ifndef __UTF_PIPELINE_INCLUDED__
+#define __UTF_PIPELINE_INCLUDED__
+
+#include "utf_toolkit.h"
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <type_traits>
+
+namespace unicode
+{
+
+namespace utf
+{
+
+namespace pipeline
+{
+
+/// chunk hand-off descriptor (the text buffer is not owned by the descriptor)
+struct chunk_descriptor
+{
+    utf_text                    text;       //! chunk view
+    uint64_t                    sequence;   //! chunk sequence number
+    uint64_t                    position;   //! byte offset of the chunk in the stream
+    const toolkit::IUTFTK*      handler;    //! handler for the chunk text (nullptr if not yet known)
+    toolkit::cp_errors          errors;     //! accumulated errors and warnings
+    uint32_t                    user;       //! caller defined value (for example a buffer index or hash)
+    bool                        final;      //! the chunk is the last chunk of the stream
+};
+
+/// pins the calling thread to a CPU (returns false if the CPU is invalid or pinning is not supported)
+[[nodiscard]] bool pinThread(const int cpu) noexcept;
+
+/// spin then yield back-off for the blocking queue functions
+inline void backoff(uint32_t& spins) noexcept
+{
+    if (spins < 64)
+    {
+        ++spins;
+    }
+    else
+    {
+        ::std::this_thread::yield();
+    }
+}
+
+/// bounded lock-free single producer, single consumer queue
+template <typename T, uint32_t Capacity>
+class spsc_queue
+{
+    static_assert((Capacity >= 2) && ((Capacity & (Capacity - 1)) == 0), "spsc_queue capacity must be a power of 2");
+    static_assert(::std::is_nothrow_copy_assignable<T>::value && ::std::is_nothrow_default_constructible<T>::value, "spsc_queue items must be nothrow copyable");
+public:
+    spsc_queue() noexcept : head(0), tail(0), closed(false), head_cache(0), tail_cache(0) {}
+    spsc_queue(const spsc_queue&) = delete;
+    spsc_queue& operator=(const spsc_queue&) = delete;
+    [[nodiscard]] bool tryPush(const T& item) noexcept
+    {   //  producer only
+        const uint32_t index = tail.load(::std::memory_order_relaxed);
+        if ((index - head_cache) == Capacity)
+        {
+            head_cache = head.load(::std::memory_order_acquire);
+            if ((index - head_cache) == Capacity)
+            {
+                return false;
+            }
+        }
+        items[index & (Capacity - 1)] = item;
+        tail.store((index + 1), ::std::memory_order_release);
+        return true;
+    }
+    [[nodiscard]] bool tryPop(T& item) noexcept
+    {   //  consumer only
+        const uint32_t index = head.load(::std::memory_order_relaxed);
+        if (index == tail_cache)
+        {
+            tail_cache = tail.load(::std::memory_order_acquire);
+            if (index == tail_cache)
+            {
+                return false;
+            }
+        }
+        item = items[index & (Capacity - 1)];
+        head.store((index + 1), ::std::memory_order_release);
+        return true;
+    }
+    void push(const T& item) noexcept
+    {
+        for (uint32_t spins = 0; !tryPush(item); backoff(spins));
+    }
+    [[nodiscard]] bool pop(T& item) noexcept
+    {   //  returns false once the queue is closed and empty
+        for (uint32_t spins = 0; !tryPop(item); backoff(spins))
+        {
+            if (closed.load(::std::memory_order_acquire))
+            {
+                return tryPop(item);
+            }
+        }
+        return true;
+    }
+    void close() noexcept { closed.store(true, ::std::memory_order_release); }
+    bool isClosed() const noexcept { return closed.load(::std::memory_order_acquire); }
+private:
+    alignas(64) ::std::atomic<uint32_t> head;
+    alignas(64) ::std::atomic<uint32_t> tail;
+    alignas(64) ::std::atomic<bool>     closed;
+    alignas(64) uint32_t                head_cache;     //  producer copy of head
+    alignas(64) uint32_t                tail_cache;     //  consumer copy of tail
+    alignas(64) T                       items[Capacity];
+};
+
+/// bounded lock-free multiple producer, multiple consumer queue
+template <typename T, uint32_t Capacity>
+class mpmc_queue
+{
+    static_assert((Capacity >= 2) && ((Capacity & (Capacity - 1)) == 0), "mpmc_queue capacity must be a power of 2");
+    static_assert(::std::is_nothrow_copy_assignable<T>::value && ::std::is_nothrow_default_constructible<T>::value, "mpmc_queue items must be nothrow copyable");
+public:
+    mpmc_queue() noexcept : enqueue(0), dequeue(0), closed(false)
+    {
+        for (uint32_t index = 0; index < Capacity; ++index)
+        {
+            cells[index].sequence.store(index, ::std::memory_order_relaxed);
+        }
+    }
+    mpmc_queue(const mpmc_queue&) = delete;
+    mpmc_queue& operator=(const mpmc_queue&) = delete;
+    [[nodiscard]] bool tryPush(const T& item) noexcept
+    {
+        uint32_t position = enqueue.load(::std::memory_order_relaxed);
+        for (;;)
+        {
+            cell& slot = cells[position & (Capacity - 1)];
+            const int32_t delta = static_cast<int32_t>(slot.sequence.load(::std::memory_order_acquire) - position);
+            if (delta == 0)
+            {
+                if (enqueue.compare_exchange_weak(position, (position + 1), ::std::memory_order_relaxed))
+                {
+                    slot.item = item;
+                    slot.sequence.store((position + 1), ::std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (delta < 0)
+            {   //  full
+                return false;
+            }
+            else
+            {
+                position = enqueue.load(::std::memory_order_relaxed);
+            }
+        }
+    }
+    [[nodiscard]] bool tryPop(T& item) noexcept
+    {
+        uint32_t position = dequeue.load(::std::memory_order_relaxed);
+        for (;;)
+        {
+            cell& slot = cells[position & (Capacity - 1)];
+            const int32_t delta = static_cast<int32_t>(slot.sequence.load(::std::memory_order_acquire) - (position + 1));
+            if (delta == 0)
+            {
+                if (dequeue.compare_exchange_weak(position, (position + 1), ::std::memory_order_relaxed))
+                {
+                    item = slot.item;
+                    slot.sequence.store((position + Capacity), ::std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (delta < 0)
+            {   //  empty
+                return false;
+            }
+            else
+            {
+                position = dequeue.load(::std::memory_order_relaxed);
+            }
+        }
+    }
+    void push(const T& item) noexcept
+    {
+        for (uint32_t spins = 0; !tryPush(item); backoff(spins));
+    }
+    [[nodiscard]] bool pop(T& item) noexcept
+    {   //  returns false once the queue is closed and empty
+        for (uint32_t spins = 0; !tryPop(item); backoff(spins))
+        {
+            if (closed.load(::std::memory_order_acquire))
+            {
+                return tryPop(item);
+            }
+        }
+        return true;
+    }
+    void close() noexcept { closed.store(true, ::std::memory_order_release); }
+    bool isClosed() const noexcept { return closed.load(::std::memory_order_acquire); }
+private:
+    struct cell
+    {
+        ::std::atomic<uint32_t> sequence;
+        T                       item;
+    };
+    alignas(64) ::std::atomic<uint32_t> enqueue;
+    alignas(64) ::std::atomic<uint32_t> dequeue;
+    alignas(64) ::std::atomic<bool>     closed;
+    alignas(64) cell                    cells[Capacity];
+};
+
+/// threaded stage pipeline: source -> [stage -> ...] -> sink
+///
+///     The source returns false when there are no more items, a stage returns false to drop an item. Each part
+///     runs on its own thread, pinned to the CPU given (or not pinned if the CPU is negative). A pipeline can be
+///     run once, run() returns false if the pipeline is incomplete.
+///
+template <typename T, uint32_t Capacity = 256, uint32_t MaxStages = 8>
+class pipeline
+{
+    static_assert(MaxStages >= 2, "a pipeline needs at least a source and a sink");
+public:
+    using producer = ::std::function<bool(T&)>;
+    using filter = ::std::function<bool(T&)>;
+    using consumer = ::std::function<void(T&)>;
+    pipeline() noexcept : count(0), has_sink(false), valid(true), pinned(0) {}
+    pipeline(const pipeline&) = delete;
+    pipeline& operator=(const pipeline&) = delete;
+    pipeline& source(producer function, const int cpu = -1)
+    {
+        valid = (valid && (count == 0));
+        return add(::std::move(function), cpu);
+    }
+    pipeline& stage(filter function, const int cpu = -1)
+    {
+        valid = (valid && (count != 0) && !has_sink);
+        return add(::std::move(function), cpu);
+    }
+    pipeline& sink(consumer function, const int cpu = -1)
+    {
+        valid = (valid && (count != 0) && !has_sink);
+        has_sink = true;
+        return add([function](T& item) { function(item); return true; }, cpu);
+    }
+    [[nodiscard]] bool run()
+    {
+        if (!valid || !has_sink)
+        {
+            return false;
+        }
+        valid = false;
+        ::std::thread threads[MaxStages];
+        for (uint32_t index = 0; index < count; ++index)
+        {
+            threads[index] = ::std::thread([this, index]() { execute(index); });
+        }
+        for (uint32_t index = 0; index < count; ++index)
+        {
+            threads[index].join();
+        }
+        return true;
+    }
+    uint32_t pinnedCount() const noexcept { return pinned.load(::std::memory_order_relaxed); }
+private:
+    pipeline& add(filter&& function, const int cpu)
+    {
+        if (count < MaxStages)
+        {
+            functions[count] = ::std::move(function);
+            cpus[count] = cpu;
+            ++count;
+        }
+        else
+        {
+            valid = false;
+        }
+        return *this;
+    }
+    void execute(const uint32_t index)
+    {
+        if ((cpus[index] >= 0) && pinThread(cpus[index]))
+        {
+            ++pinned;
+        }
+        T item;
+        if (index == 0)
+        {   //  source
+            while (functions[0](item))
+            {
+                queues[0].push(item);
+            }
+            queues[0].close();
+        }
+        else if ((index + 1) == count)
+        {   //  sink
+            while (queues[index - 1].pop(item))
+            {
+                functions[index](item);
+            }
+        }
+        else
+        {
+            while (queues[index - 1].pop(item))
+            {
+                if (functions[index](item))
+                {
+                    queues[index].push(item);
+                }
+            }
+            queues[index].close();
+        }
+    }
+    filter                          functions[MaxStages];
+    int                             cpus[MaxStages];
+    spsc_queue<T, Capacity>         queues[MaxStages - 1];
+    uint32_t                        count;
+    bool                            has_sink;
+    bool                            valid;
+    ::std::atomic<uint32_t>         pinned;
+};
+
+};  //  namespace pipeline
+
+};  //  namespace utf
+
+};  //  namespace unicode
+
+#endif  //  #ifndef __UTF_PIPELINE_INCLUDED__
@@ -0,0 +1,96 @@
+
+//  SuiteUTF
+//  Original design 20102016; maintained and extended 20242025.
+//  Copyright (c) 20102025 Ritchie Brannan.
+//  MIT License. See LICENSE.txt. Project history: docs/History.md.
+//
+//  File:   utf_sort.h
+//  Author: Ritchie Brannan
+//  Date:   18 Oct 26
+//  
+//  Description:
+//  
+//      Code-point order radix sort of arrays of encoded strings.
+//  
+//  Notes:
+//  
+//      This header is not included by suite_utf.h.
+//  
+//      sortTexts() sorts an array of utf_text views, all in the sub-type of the handler, into the code-point order
+//      of their unread text (the bytes from offset to length). Only the views are moved, the text is not copied or
+//      modified. The sort is an in-place MSD radix sort over key bytes which are in code-point order:
+//  
+//          UTF8, BYTE and ASCII            : the bytes (UTF8 byte order is code-point order),
+//          Java style UTF8                 : the bytes, with the C0 of a { 0xc0, 0x80 } null mapped to 0x00,
+//          CESU8                           : the bytes, with the 0xed lead of a surrogate mapped to 0xf8,
+//          UTF16                           : big endian code-units, with 0xd800 to 0xdfff moved above 0xffff,
+//          UCS2, UTF32 and UCS4            : big endian code-units,
+//          CESU32 and CESU4                : big endian code-units, with 0xd800 to 0xdfff moved above 0x10ffff,
+//          CP1252                          : big endian 16-bit code-points.
+//  
+//      The surrogate remapping is done on the fly as the key bytes are read, so UTF16 and the CESU forms sort
+//      supplementary code-points (surrogate pairs) after the rest of the BMP, as code-point order requires. A raw
+//      memcmp() sort of UTF16 gets this wrong. Malformed sequences, lone surrogates and texts mixing two forms of
+//      the same code-point (a CESU8 text with 4 byte sequences, say) are ordered consistently, but not necessarily
+//      in code-point order. A text which is a prefix of another sorts first, and texts with equal keys are in no
+//      particular order (the sort is not stable).
+//  
+//      Each entry caches an 8 byte key prefix, so each radix pass reads the entries sequentially and the text is
+//      only touched once per 8 key bytes. Runs of key bytes shared by a whole bucket are skipped 8 bytes at a time
+//      and small buckets are finished with an insertion sort. Only the smaller buckets are sorted recursively, so
+//      the stack depth is logarithmic in the count.
+//  
+//      The scratch memory holds scratchSize(count) bytes, 8 byte aligned, and is owned by the caller. The sort does
+//      not allocate memory. The threaded overload partitions the whole array on the first key byte that differs,
+//      then sorts the buckets on up to 'threads' threads (including the calling thread), the results are identical.
+//  
+//      The functions return false, leaving the texts unchanged, if the handler is a custom sub-type, the scratch
+//      memory is too small or misaligned, or a text view is invalid (offset past length, or a null buffer with a
+//      non-zero length). compareTexts() compares an invalid view as empty text and the texts of a custom sub-type
+//      by their bytes.
+
+#pragma once
+
+#ifndef __UTF_SORT_INCLUDED__
+#define __UTF_SORT_INCLUDED__
+
+#include "utf_toolkit.h"
+#include <cstddef>
+
+namespace unicode
+{
+
+namespace utf
+{
+
+namespace sort
+{
+
+/// scratch bytes per text
+constexpr size_t kScratchPerText = 24;
+
+/// scratch memory required to sort count texts
+inline constexpr [[nodiscard]] size_t scratchSize(const uint32_t count) noexcept
+{
+    return (static_cast<size_t>(count) * kScratchPerText);
+}
+
+/// check for a sub-type which can be sorted (the built in sub-types)
+[[nodiscard]] bool isSortable(const toolkit::IUTFTK& handler) noexcept;
+
+/// three-way code-point order comparison of the unread text of two views (the order used by sortTexts())
+[[nodiscard]] int compareTexts(const toolkit::IUTFTK& handler, const utf_text& lhs, const utf_text& rhs) noexcept;
+
+/// sorts the texts into code-point order
+[[nodiscard]] bool sortTexts(const toolkit::IUTFTK& handler, utf_text* const texts, const uint32_t count, void* const scratch, const size_t size) noexcept;
+
+/// sorts the texts into code-point order, sorting the first level buckets in parallel (may start threads)
+[[nodiscard]] bool sortTexts(const toolkit::IUTFTK& handler, utf_text* const texts, const uint32_t count, void* const scratch, const size_t size, const uint32_t threads);
+
+};  //  namespace sort
+
+};  //  namespace utf
+
+};  //  namespace unicode
+
+#endif  //  #ifndef __UTF_SORT_INCLUDED__
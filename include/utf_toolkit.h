@@ -172,9 +172,89 @@ enum class UTF_SUB_TYPE : int32_t
     CP1252      = 28,   //  type: other, sub-type: Windows Code-Page 1252 (permissive)
     CP1252ns    = 29,   //  type: other, sub-type: Windows Code-Page 1252 (non-skipping)
     CP1252st    = 30,   //  type: other, sub-type: Windows Code-Page 1252 (strict)
-    COUNT       = 31    //  count of sub-types
+    COUNT       = 31,   //  count of sub-types
+    CUSTOM      = 32    //  first custom sub-type (see registerSubType())
 };
 
+// ==== sub-type subset build configuration ====
+
+//  Notes:
+//
+//      Defining SUITEUTF_SUBTYPES (for the whole build) as a mask of the SUITEUTF_SUBTYPE_... bits below limits the
+//      handlers compiled into utf_toolkit.cpp to those sub-types, for example:
+//
+//          -DSUITEUTF_SUBTYPES="(SUITEUTF_SUBTYPE_UTF8st|SUITEUTF_SUBTYPE_UTF16le)"
+//
+//      getHandler() returns the SUITEUTF_SUBTYPE_FALLBACK handler (default JUTF8st, which is also returned for
+//      invalid sub-types) for sub-types which are not available, so the sub-type of the handler returned should be
+//      checked (or isSubTypeAvailable() used) when the requested sub-type may be missing. The fallback sub-type must be
+//      included in the subset.
+//
+//      The stand alone encode, decode, back and step functions are always compiled. With function level linking
+//      (-ffunction-sections with --gc-sections, or /Gy with /OPT:REF) those only used by the excluded handlers are
+//      removed from the program along with the excluded handlers.
+
+#define SUITEUTF_SUBTYPE_UTF8        (1u << 0)
+#define SUITEUTF_SUBTYPE_UTF8ns      (1u << 1)
+#define SUITEUTF_SUBTYPE_UTF8st      (1u << 2)
+#define SUITEUTF_SUBTYPE_JUTF8       (1u << 3)
+#define SUITEUTF_SUBTYPE_JUTF8ns     (1u << 4)
+#define SUITEUTF_SUBTYPE_JUTF8st     (1u << 5)
+#define SUITEUTF_SUBTYPE_CESU8       (1u << 6)
+#define SUITEUTF_SUBTYPE_CESU8ns     (1u << 7)
+#define SUITEUTF_SUBTYPE_CESU8st     (1u << 8)
+#define SUITEUTF_SUBTYPE_JCESU8      (1u << 9)
+#define SUITEUTF_SUBTYPE_JCESU8ns    (1u << 10)
+#define SUITEUTF_SUBTYPE_JCESU8st    (1u << 11)
+#define SUITEUTF_SUBTYPE_UTF16le     (1u << 12)
+#define SUITEUTF_SUBTYPE_UTF16be     (1u << 13)
+#define SUITEUTF_SUBTYPE_UCS2le      (1u << 14)
+#define SUITEUTF_SUBTYPE_UCS2be      (1u << 15)
+#define SUITEUTF_SUBTYPE_UTF32le     (1u << 16)
+#define SUITEUTF_SUBTYPE_UTF32be     (1u << 17)
+#define SUITEUTF_SUBTYPE_UCS4le      (1u << 18)
+#define SUITEUTF_SUBTYPE_UCS4be      (1u << 19)
+#define SUITEUTF_SUBTYPE_CESU32le    (1u << 20)
+#define SUITEUTF_SUBTYPE_CESU32be    (1u << 21)
+#define SUITEUTF_SUBTYPE_CESU4le     (1u << 22)
+#define SUITEUTF_SUBTYPE_CESU4be     (1u << 23)
+#define SUITEUTF_SUBTYPE_BYTE        (1u << 24)
+#define SUITEUTF_SUBTYPE_BYTEns      (1u << 25)
+#define SUITEUTF_SUBTYPE_ASCII       (1u << 26)
+#define SUITEUTF_SUBTYPE_ASCIIns     (1u << 27)
+#define SUITEUTF_SUBTYPE_CP1252      (1u << 28)
+#define SUITEUTF_SUBTYPE_CP1252ns    (1u << 29)
+#define SUITEUTF_SUBTYPE_CP1252st    (1u << 30)
+
+#define SUITEUTF_SUBTYPES_UTF8      (0x00000fffu)   //  all the UTF8 family sub-types
+#define SUITEUTF_SUBTYPES_UTF16     (0x0000f000u)   //  all the UTF16 family sub-types
+#define SUITEUTF_SUBTYPES_UTF32     (0x00ff0000u)   //  all the UTF32 family sub-types
+#define SUITEUTF_SUBTYPES_OTHER     (0x7f000000u)   //  all the single byte sub-types
+#define SUITEUTF_SUBTYPES_ALL       (0x7fffffffu)   //  all the sub-types
+
+#ifndef SUITEUTF_SUBTYPES
+#define SUITEUTF_SUBTYPES           SUITEUTF_SUBTYPES_ALL
+#endif
+
+#ifndef SUITEUTF_SUBTYPE_FALLBACK
+#define SUITEUTF_SUBTYPE_FALLBACK   JUTF8st
+#endif
+
+/// check that a sub-type handler is compiled into this build
+inline constexpr [[nodiscard]] bool isSubTypeAvailable(const UTF_SUB_TYPE utfSubType) noexcept
+{
+    return ((static_cast<uint32_t>(utfSubType) < static_cast<uint32_t>(UTF_SUB_TYPE::COUNT)) && (((SUITEUTF_SUBTYPES) >> static_cast<uint32_t>(utfSubType)) & 1u));
+}
+
+/// maximum number of custom sub-types which can be registered
+constexpr uint32_t kMaxCustomSubTypes = 32;
+
+/// check for a custom sub-type id (registered or not)
+inline constexpr [[nodiscard]] bool isCustomSubType(const UTF_SUB_TYPE utfSubType) noexcept
+{
+    return ((static_cast<uint32_t>(utfSubType) - static_cast<uint32_t>(UTF_SUB_TYPE::CUSTOM)) < kMaxCustomSubTypes);
+}
+
 /// code-point encode and decode functions return data type
 class cp_errors
 {
@@ -275,6 +355,7 @@ public:
     constexpr [[nodiscard]] cp_errors errors_only() const noexcept { return cp_errors(state & ErrorsMask); }
     constexpr [[nodiscard]] cp_errors warnings_only() const noexcept { return cp_errors(state & WarningsMask); }
     constexpr [[nodiscard]] cp_errors buffer_errors_only() const noexcept { return cp_errors(state & BufferErrorsMask); }
+    constexpr [[nodiscard]] cp_errors diagnosed(const cp_errors diagnostics) const noexcept { return cp_errors(state & ~(WarningsMask & ~(diagnostics.state | u(bits::ReadExhausted)))); }
     constexpr [[nodiscard]] uint32_t get_byte_index() const noexcept { return uint32_t(state & ByteIndexMask); }
     constexpr void set_byte_index(const uint32_t index) noexcept { state = (state & ~ByteIndexMask) | (index & ByteIndexMask); }
 private:
@@ -314,6 +395,10 @@ constexpr [[nodiscard]] cp_errors operator|(const cp_errors::bits lhs, const cp_
     return cp_errors(static_cast<cp_errors::underlying_type>(lhs) | static_cast<cp_errors::underlying_type>(rhs));
 }
 
+/// diagnostic masks selecting the warnings reported by the decoding functions (errors and ReadExhausted are always reported)
+constexpr cp_errors kAllDiagnostics = cp_errors(0xffffffffu);
+constexpr cp_errors kNoDiagnostics = cp_errors(0u);
+
 // ==== stand alone utf_text structure error checking ====
 inline [[nodiscard]] cp_errors get_errors(const utf_text& text) noexcept;
 inline [[nodiscard]] cp_errors get_errors(const utf_text& text, const uint32_t alignment_mask) noexcept;
@@ -332,11 +417,20 @@ uint32_t lenUTF32(const unicode_t unicode, const bool use_cesu = false, const bo
 [[nodiscard]] cp_errors encodeCP1252(utf_text& text, const unicode_t unicode, uint32_t& bytes, const bool strict = false) noexcept;
 
 // ==== low level code-point decoding functions ====
-[[nodiscard]] cp_errors decodeBYTE(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const bool use_ascii = false, const bool coalesce = true) noexcept;
-[[nodiscard]] cp_errors decodeUTF8(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const bool use_cesu = false, const bool use_java = false, const bool strict = false, const bool coalesce = true) noexcept;
-[[nodiscard]] cp_errors decodeUTF16(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const bool le = false, const bool use_ucs2 = false) noexcept;
-[[nodiscard]] cp_errors decodeUTF32(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const bool le = false, const bool use_cesu = false, const bool use_ucs4 = false) noexcept;
-[[nodiscard]] cp_errors decodeCP1252(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const bool strict = false, const bool coalesce = true) noexcept;
+
+//  Notes:
+//
+//      The diagnostics mask selects the warnings included in the result. The warnings which can change the errors
+//      of the sub-type (the surrogate, overlong, modified and extended forms) are always derived, but NonCharacter,
+//      Supplementary and DelimitString only add to the result and are not computed unless they are requested.
+//      A surrogate pair still sets Supplementary and SurrogatePair as it is combined (they are then masked out).
+//      The step() and back() functions do not compute any warnings, so they need no mask.
+
+[[nodiscard]] cp_errors decodeBYTE(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const bool use_ascii = false, const bool coalesce = true, const cp_errors diagnostics = kAllDiagnostics) noexcept;
+[[nodiscard]] cp_errors decodeUTF8(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const bool use_cesu = false, const bool use_java = false, const bool strict = false, const bool coalesce = true, const cp_errors diagnostics = kAllDiagnostics) noexcept;
+[[nodiscard]] cp_errors decodeUTF16(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const bool le = false, const bool use_ucs2 = false, const cp_errors diagnostics = kAllDiagnostics) noexcept;
+[[nodiscard]] cp_errors decodeUTF32(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const bool le = false, const bool use_cesu = false, const bool use_ucs4 = false, const cp_errors diagnostics = kAllDiagnostics) noexcept;
+[[nodiscard]] cp_errors decodeCP1252(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const bool strict = false, const bool coalesce = true, const cp_errors diagnostics = kAllDiagnostics) noexcept;
 
 // ==== low level utf byte order marker and NULL code-point fast encoding functions ====
 [[nodiscard]] cp_errors encodeUTF8_BOM(utf_text& text, uint32_t& bytes) noexcept;
@@ -394,6 +488,7 @@ public:
     virtual uint32_t                lenBOM() const noexcept = 0;
     virtual uint32_t                lenNull() const noexcept = 0;
     virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes) const noexcept = 0;
+    virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const cp_errors diagnostics) const noexcept;
     virtual [[nodiscard]] cp_errors set(utf_text& text, const unicode_t unicode, uint32_t& bytes) const noexcept = 0;
     virtual [[nodiscard]] cp_errors setBOM(utf_text& text, uint32_t& bytes) const noexcept = 0;
     virtual [[nodiscard]] cp_errors setNull(utf_text& text, uint32_t& bytes) const noexcept = 0;
@@ -412,6 +507,59 @@ public:
     [[nodiscard]] cp_errors         readLine(utf_text& text, utf_text& line) const noexcept;
 };
 
+// ==== custom sub-type registration ====
+
+//  Notes:
+//
+//      A custom sub-type handler is derived from ICustomUTFTK and registered with registerSubType(), which assigns
+//      it the next free id from UTF_SUB_TYPE::CUSTOM. The id is returned by the handler's utfSubType() and accepted
+//      by getHandler(), and the handler can be used with all the toolkit, bulk, cache and pipeline functions.
+//      Registered handlers are never unregistered, so they must outlive all their uses (usually static objects).
+//
+//      The ids depend on the order of registration, so they must not be persisted (writeContainer() rejects them).
+//      Custom handlers must decode each code-point independently of the text before it (no shift states), as the
+//      bulk functions may split the text between any two code-points. The masked get() need not be overridden, by
+//      default it filters the warnings of get().
+//
+//      The optional bulk kernels let the bulk functions process runs of text without calling the handler for each
+//      code-point. Each kernel processes a leading run of code-points which the handler would decode or encode
+//      without any errors or warnings, stopping where it chooses, and returns 0 to leave the rest to the handler:
+//
+//          decode      : decodes up to capacity code-points, sets count and returns the bytes consumed.
+//          encode      : encodes up to count code-points into space bytes, sets bytes and returns the count consumed.
+//          validate    : returns the size of a leading run of complete code-points.
+//
+//      The kernel results must be identical to those of the handler, and a decode kernel called again with a
+//      smaller capacity must decode the same leading code-points. The decode kernel is not used when line-feeds
+//      are being normalised.
+
+/// optional bulk kernels for a custom sub-type (any of the kernels may be nullptr)
+struct custom_kernels
+{
+    uint32_t (*decode)(const uint8_t* src, uint32_t size, unicode_t* dst, uint32_t capacity, uint32_t& count) noexcept;
+    uint32_t (*encode)(const unicode_t* src, uint32_t count, uint8_t* dst, uint32_t space, uint32_t& bytes) noexcept;
+    uint32_t (*validate)(const uint8_t* src, uint32_t size) noexcept;
+};
+
+/// custom sub-type handler base (utfSubType() returns UTF_SUB_TYPE::COUNT until the handler is registered)
+struct ICustomUTFTK : public IUTFTK
+{
+protected:
+    inline                          ICustomUTFTK() : customSubType(UTF_SUB_TYPE::COUNT) {};
+    inline                          ~ICustomUTFTK() {};
+public:
+    virtual UTF_SUB_TYPE            utfSubType(void) const noexcept final { return customSubType; }
+private:
+    friend bool registerSubType(ICustomUTFTK& handler, const custom_kernels& kernels) noexcept;
+    UTF_SUB_TYPE                    customSubType;
+};
+
+/// registers a custom sub-type handler and its bulk kernels (returns false if the handler is already registered or there are no free ids)
+[[nodiscard]] bool registerSubType(ICustomUTFTK& handler, const custom_kernels& kernels) noexcept;
+
+/// registered bulk kernels of a handler (nullptr if the handler is not a registered custom sub-type)
+[[nodiscard]] const custom_kernels* getCustomKernels(const IUTFTK& handler) noexcept;
+
 // ==== inline function bodies ====
 
 [[nodiscard]] cp_errors get_errors(const utf_text& text) noexcept
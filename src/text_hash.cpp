@@ -67,7 +67,12 @@ uint16_t crc_ccitt_false(const uint8_t* const text) noexcept
 
 uint16_t crc_ccitt_false(const uint8_t* const text, const uint32_t length) noexcept
 {
-	uint32_t hash = 0x0000ffffu;
+	return crc_ccitt_false_update(0xffffu, text, length);
+}
+
+uint16_t crc_ccitt_false_update(const uint16_t crc, const uint8_t* const text, const uint32_t length) noexcept
+{
+	uint32_t hash = static_cast<uint32_t>(crc);
 	for (uint32_t index = 0; index < length; ++index)
 	{
 		hash = ((hash << 8) ^ kCRC_CCITT_FALSE[((hash >> 8) ^ text[index]) & 0xffu]);
@@ -97,6 +97,12 @@ bool isCC(const unicode_t unicode) noexcept
 	return ((unicode & 0xffffff60u) == 0x0000u) || (unicode == 0x007fu);
 }
 
+//! determine if a unicode code-point is a bidirectional formatting control character
+bool isBidiControl(const unicode_t unicode) noexcept
+{   //  U+061C, 200E200F, 202A202E, 20662069
+	return (unicode == 0x061cu) || ((unicode >= 0x200eu) && ((unicode <= 0x200fu) || ((unicode >= 0x202au) && (unicode <= 0x202eu)) || ((unicode >= 0x2066u) && (unicode <= 0x2069u))));
+}
+
 //! determine if a unicode code-point is a breaking white space character
 bool isBreakingWhite(const unicode_t unicode) noexcept
 {
@@ -0,0 +1,3156 @@
+
+//  SuiteUTF
+//  Original design 20102016; maintained and extended 20242025.
+//  Copyright (c) 20102025 Ritchie Brannan.
+//  MIT License. See LICENSE.txt. Project history: docs/History.md.
+//
+//  File:   utf_bulk.cpp
+//  Author: Ritchie Brannan
+//  Date:   18 Oct 26
+//  
+//  Description:
+//  
+//      Bulk UTF buffer processing built on the toolkit handlers.
+
+#include "utf_bulk.h"
+#include "unicode_classification.h"
+#include "utf_simd.h"
+#include <string.h>
+
+namespace unicode
+{
+
+namespace utf
+{
+
+namespace bulk
+{
+
+namespace internal
+{
+
+using toolkit::cp_errors;
+using toolkit::IUTFTK;
+using toolkit::UTF_SUB_TYPE;
+using toolkit::custom_kernels;
+
+/// internal check for sub-types which decode and encode U+0001 to U+007F as single bytes without warnings
+inline [[nodiscard]] bool isAsciiCompatible(const UTF_SUB_TYPE utfSubType) noexcept
+{
+    const uint32_t index = static_cast<uint32_t>(utfSubType);
+    return ((index <= static_cast<uint32_t>(UTF_SUB_TYPE::JCESU8st)) || ((index >= static_cast<uint32_t>(UTF_SUB_TYPE::BYTE)) && (index < static_cast<uint32_t>(UTF_SUB_TYPE::COUNT))));
+}
+
+/// internal check for a plain ASCII byte (0x01 to 0x7f, excluding the line-feed variants 0x0a to 0x0d when use_nlf is true)
+inline [[nodiscard]] bool isPlainAscii(const uint8_t byte, const bool use_nlf) noexcept
+{
+    return ((static_cast<uint8_t>(byte - 1) < 0x7fu) && !(use_nlf && (static_cast<uint8_t>(byte - 0x0au) < 4)));
+}
+
+/// internal word-at-a-time scan returning the length of a run of plain ASCII bytes
+uint32_t scanAsciiRun(const uint8_t* const buffer, const uint32_t size, const bool use_nlf) noexcept
+{   //  a word only passes the quick test if every byte is in the range [low, 0x7f], failing words are checked byte by byte
+    const uint64_t low = (use_nlf ? 0x0e0e0e0e0e0e0e0eull : 0x0101010101010101ull);
+    uint32_t index = 0;
+    while ((size - index) >= 8)
+    {
+        uint64_t word;
+        memcpy(&word, &buffer[index], 8);
+        if (((word | (word - low)) & 0x8080808080808080ull) != 0)
+        {
+            for (uint32_t limit = (index + 8); index < limit; ++index)
+            {
+                if (!isPlainAscii(buffer[index], use_nlf))
+                {
+                    return index;
+                }
+            }
+        }
+        else
+        {
+            index += 8;
+        }
+    }
+    while ((index < size) && isPlainAscii(buffer[index], use_nlf))
+    {
+        ++index;
+    }
+    return index;
+}
+
+/// internal length of the well-formed UTF8 multi-byte sequence at the start of the buffer (Unicode table 3-7), 0 if there is none
+inline [[nodiscard]] uint32_t wellFormedUTF8(const uint8_t* const buffer, const uint32_t size) noexcept
+{
+    const uint8_t lead = buffer[0];
+    if ((lead < 0xc2) || (lead > 0xf4))
+    {
+        return 0;
+    }
+    if (lead < 0xe0)
+    {
+        return (((size >= 2) && ((buffer[1] & 0xc0) == 0x80)) ? 2 : 0);
+    }
+    if (lead < 0xf0)
+    {   //  excludes overlong forms (0xe0 0x80 to 0x9f) and surrogates (0xed 0xa0 to 0xbf)
+        const uint8_t low = ((lead == 0xe0) ? 0xa0 : 0x80);
+        const uint8_t high = ((lead == 0xed) ? 0x9f : 0xbf);
+        return (((size >= 3) && (buffer[1] >= low) && (buffer[1] <= high) && ((buffer[2] & 0xc0) == 0x80)) ? 3 : 0);
+    }
+    {   //  excludes overlong forms (0xf0 0x80 to 0x8f) and code-points above U+10FFFF (0xf4 0x90 to 0xbf)
+        const uint8_t low = ((lead == 0xf0) ? 0x90 : 0x80);
+        const uint8_t high = ((lead == 0xf4) ? 0x8f : 0xbf);
+        return (((size >= 4) && (buffer[1] >= low) && (buffer[1] <= high) && ((buffer[2] & 0xc0) == 0x80) && ((buffer[3] & 0xc0) == 0x80)) ? 4 : 0);
+    }
+}
+
+/// internal check for a well-formed UTF8 sequence encoding a non-character (U+FDD0 to U+FDEF and U+xFFFE to U+xFFFF)
+inline [[nodiscard]] bool isNonCharacterUTF8(const uint8_t* const buffer, const uint32_t length) noexcept
+{
+    if (length == 3)
+    {
+        return ((buffer[0] == 0xef) && (((buffer[1] == 0xb7) && (buffer[2] >= 0x90) && (buffer[2] <= 0xaf)) || ((buffer[1] == 0xbf) && (buffer[2] >= 0xbe))));
+    }
+    return ((length == 4) && ((buffer[1] & 0x0f) == 0x0f) && (buffer[2] == 0xbf) && (buffer[3] >= 0xbe));
+}
+
+/// internal scan of a run of well-formed UTF8 multi-byte sequences, accumulating only the requested warnings
+///
+///     Well-formed sequences never fail to decode in any of the UTF8 sub-types and can only have the Supplementary
+///     and NonCharacter warnings, so the handler is not called. Non-characters end the run when NonCharacter is
+///     requested (the handler reports them).
+///
+uint32_t scanWellFormedUTF8(const uint8_t* const buffer, const uint32_t size, const cp_errors diagnostics, cp_errors& warnings) noexcept
+{
+    const bool noncharacters = diagnostics.any(cp_errors::bits::NonCharacter);
+    const bool supplementary = diagnostics.any(cp_errors::bits::Supplementary);
+    uint32_t index = 0;
+    while (index < size)
+    {
+        const uint32_t length = wellFormedUTF8(&buffer[index], (size - index));
+        if ((length == 0) || (noncharacters && isNonCharacterUTF8(&buffer[index], length)))
+        {
+            break;
+        }
+        if (supplementary && (length == 4))
+        {
+            warnings |= cp_errors::bits::Supplementary;
+        }
+        index += length;
+    }
+    return index;
+}
+
+/// internal UTF8 family block validation settings
+struct utf8_family
+{
+    bool    java;       //  { 0xc0, 0x80 } nulls are well-formed (JUTF8 and JCESU8)
+    bool    cesu;       //  surrogate pairs are well-formed (CESU8 and JCESU8)
+};
+
+inline [[nodiscard]] utf8_family getUTF8Family(const UTF_SUB_TYPE utfSubType) noexcept
+{
+    const uint32_t family = (static_cast<uint32_t>(utfSubType) / 3);
+    return { ((family & 1) != 0), ((family & 2) != 0) };
+}
+
+/// internal validation of a 64 byte block of UTF8 family text (returns the bytes of the leading well-formed run)
+///
+///     Every byte position is classified with mask compares and each lead byte is checked against the bytes that
+///     follow it, so the run ends at the first lead byte which does not start a sequence in the block which the
+///     handler decodes without errors and with only the warnings accumulated here:
+///
+///         0x01 to 0x7f, 2 byte, 3 byte (not surrogate) and 4 byte (up to U+10FFFF) sequences,
+///         0x00 (DelimitString),
+///         { 0xc0, 0x80 } for the Java style sub-types (ModifiedUTF8),
+///         surrogate pairs for the CESU sub-types (SurrogatePair and Supplementary),
+///
+///     with Supplementary for the 4 byte sequences and NonCharacter for the non-characters. Sequences crossing the
+///     end of the block are left for the next block.
+///
+uint32_t validateBlockUTF8(const uint8_t* const buffer, const utf8_family family, cp_errors& warnings) noexcept
+{
+    const simd::block64 bytes = simd::loadBlock(buffer);
+    const uint64_t cont = simd::rangeMask(bytes, 0x80, 0x3f);
+    const uint64_t nulls = simd::equalMask(bytes, 0x00);
+    const uint64_t single = (simd::rangeMask(bytes, 0x01, 0x7e) | nulls);
+    const uint64_t lead2 = (simd::rangeMask(bytes, 0xc2, 0x1d) & (cont >> 1));
+    uint64_t valid2 = lead2;
+    uint64_t valid3 = 0;
+    uint64_t valid4 = 0;
+    uint64_t specials = 0;      //  { 0xc0, 0x80 } nulls
+    uint64_t pairs = 0;         //  surrogate pairs
+    uint64_t nonCharacters = 0;
+    if (family.java)
+    {
+        specials = (simd::equalMask(bytes, 0xc0) & (simd::equalMask(bytes, 0x80) >> 1));
+        valid2 |= specials;
+    }
+    const uint64_t lead3 = simd::rangeMask(bytes, 0xe0, 0x0f);
+    if (lead3)
+    {   //  excludes overlong forms (0xe0 0x80 to 0x9f) and surrogates (0xed 0xa0 to 0xbf), except the pairs of the CESU sub-types
+        valid3 = (lead3 & (cont >> 1) & (cont >> 2));
+        const uint64_t e0 = (simd::equalMask(bytes, 0xe0) & valid3);
+        if (e0)
+        {
+            valid3 &= ~(e0 & (simd::rangeMask(bytes, 0x80, 0x1f) >> 1));
+        }
+        const uint64_t ed = (simd::equalMask(bytes, 0xed) & valid3);
+        if (ed)
+        {
+            const uint64_t surrogates = (ed & (simd::rangeMask(bytes, 0xa0, 0x1f) >> 1));
+            valid3 &= ~surrogates;
+            if (family.cesu && surrogates)
+            {   //  a high surrogate (0xed 0xa0 to 0xaf) followed by a low surrogate (0xed 0xb0 to 0xbf)
+                const uint64_t low = (surrogates & (simd::rangeMask(bytes, 0xb0, 0x0f) >> 1));
+                pairs = ((surrogates & ~low) & (low >> 3));
+                if (pairs)
+                {   //  U+xFFFE and U+xFFFF are 0xed 0xa? 0xbf 0xed 0xbf 0xbe to 0xbf
+                    valid3 |= (pairs | (pairs << 3));
+                    const uint64_t bf = simd::equalMask(bytes, 0xbf);
+                    nonCharacters |= (pairs & (bf >> 2) & (bf >> 4) & ((bf | simd::equalMask(bytes, 0xbe)) >> 5));
+                }
+            }
+        }
+        const uint64_t ef = (simd::equalMask(bytes, 0xef) & valid3);
+        if (ef)
+        {   //  U+FDD0 to U+FDEF are 0xef 0xb7 0x90 to 0xaf, U+FFFE and U+FFFF are 0xef 0xbf 0xbe to 0xbf
+            const uint64_t bf = simd::equalMask(bytes, 0xbf);
+            nonCharacters |= (ef & (((simd::equalMask(bytes, 0xb7) >> 1) & (simd::rangeMask(bytes, 0x90, 0x1f) >> 2)) |
+                ((bf >> 1) & ((bf | simd::equalMask(bytes, 0xbe)) >> 2))));
+        }
+    }
+    const uint64_t lead4 = simd::rangeMask(bytes, 0xf0, 0x04);
+    if (lead4)
+    {   //  excludes overlong forms (0xf0 0x80 to 0x8f) and code-points above U+10FFFF (0xf4 0x90 to 0xbf)
+        valid4 = (lead4 & (cont >> 1) & (cont >> 2) & (cont >> 3) &
+            ~(simd::equalMask(bytes, 0xf0) & (simd::rangeMask(bytes, 0x80, 0x0f) >> 1)) &
+            ~(simd::equalMask(bytes, 0xf4) & (simd::rangeMask(bytes, 0x90, 0x2f) >> 1)));
+        if (valid4)
+        {   //  U+xFFFE and U+xFFFF are 0xf? 0x8f, 0x9f, 0xaf or 0xbf, 0xbf, 0xbe to 0xbf
+            const uint64_t bf = simd::equalMask(bytes, 0xbf);
+            const uint64_t planes = (simd::equalMask(bytes, 0x8f) | simd::equalMask(bytes, 0x9f) | simd::equalMask(bytes, 0xaf) | bf);
+            nonCharacters |= (valid4 & (planes >> 1) & (bf >> 2) & ((bf | simd::equalMask(bytes, 0xbe)) >> 3));
+        }
+    }
+    const uint64_t needed = ((valid2 << 1) | (valid3 << 1) | (valid3 << 2) | (valid4 << 1) | (valid4 << 2) | (valid4 << 3));
+    const uint64_t invalid = ((~cont & ~(single | valid2 | valid3 | valid4)) | (cont & ~needed));
+    const uint32_t run = (invalid ? simd::lowestBit(invalid) : 64);
+    const uint64_t taken = ((run < 64) ? ((1ull << run) - 1) : ~0ull);
+    if ((nulls & taken) != 0)
+    {
+        warnings |= cp_errors::bits::DelimitString;
+    }
+    if ((specials & taken) != 0)
+    {
+        warnings |= cp_errors::bits::ModifiedUTF8;
+    }
+    if (((valid4 | pairs) & taken) != 0)
+    {
+        warnings |= cp_errors::bits::Supplementary;
+    }
+    if ((pairs & taken) != 0)
+    {
+        warnings |= cp_errors::bits::SurrogatePair;
+    }
+    if ((nonCharacters & taken) != 0)
+    {
+        warnings |= cp_errors::bits::NonCharacter;
+    }
+    return run;
+}
+
+/// internal scan of a run of UTF8 family text in 64 byte blocks (see validateBlockUTF8())
+uint32_t scanBlocksUTF8(const uint8_t* const buffer, const uint32_t size, const utf8_family family, cp_errors& warnings) noexcept
+{
+    uint32_t index = 0;
+    while ((size - index) >= 64)
+    {
+        const uint32_t run = validateBlockUTF8(&buffer[index], family, warnings);
+        index += run;
+        if (run < 64)
+        {
+            break;
+        }
+    }
+    return index;
+}
+
+/// internal back-off of the block scans: after a block run shorter than kShortBlockRun bytes the next
+/// kBlockBackoff bytes are left to the scalar paths (text dense with sequences the block scan cannot take)
+constexpr uint32_t kShortBlockRun = 16;
+constexpr uint32_t kBlockBackoff = 256;
+
+/// internal decode of a run of UTF8 family text already validated by scanBlocksUTF8()
+///
+///     The run only contains sequences which the handler decodes without errors, so each lead byte gives the
+///     sequence length directly. The surrogate pairs of the CESU sub-types (the only 3 byte sequences starting
+///     0xed 0xa0 to 0xaf in a validated run) are combined. Offsets are stored relative to base. Returns the number
+///     of code-points stored (never more than size).
+///
+uint32_t decodeBlocksUTF8(const uint8_t* const buffer, const uint32_t size, unicode_t* const dst, uint32_t* const offsets, const uint32_t base) noexcept
+{
+    uint32_t index = 0;
+    uint32_t count = 0;
+    while (index < size)
+    {
+        const uint32_t byte = buffer[index];
+        unicode_t unicode = 0;
+        uint32_t bytes = 1;
+        if (byte < 0x80u)
+        {
+            unicode = byte;
+        }
+        else if (byte < 0xe0u)
+        {
+            unicode = (((byte & 0x1fu) << 6) | (buffer[index + 1] & 0x3fu));
+            bytes = 2;
+        }
+        else if (byte < 0xf0u)
+        {
+            unicode = (((byte & 0x0fu) << 12) | ((buffer[index + 1] & 0x3fu) << 6) | (buffer[index + 2] & 0x3fu));
+            bytes = 3;
+            if ((unicode & 0xfffffc00u) == 0x0000d800u)
+            {   //  CESU surrogate pair
+                const unicode_t low = (((buffer[index + 4] & 0x0fu) << 6) | (buffer[index + 5] & 0x3fu));
+                unicode = (((unicode & 0x000003ffu) << 10) + low + 0x00010000u);
+                bytes = 6;
+            }
+        }
+        else
+        {
+            unicode = (((byte & 0x07u) << 18) | ((buffer[index + 1] & 0x3fu) << 12) | ((buffer[index + 2] & 0x3fu) << 6) | (buffer[index + 3] & 0x3fu));
+            bytes = 4;
+        }
+        dst[count] = unicode;
+        if (offsets != nullptr)
+        {
+            offsets[count] = (base + index);
+        }
+        ++count;
+        index += bytes;
+    }
+    return count;
+}
+
+/// internal check for the use of non-temporal stores (only available on targets with streaming stores)
+inline [[nodiscard]] bool useNonTemporal(const StoreMode store, const utf_text& src) noexcept
+{
+    return (simd::kStreaming && ((store == StoreMode::NonTemporal) || ((store == StoreMode::Automatic) && ((src.length - src.offset) >= kNonTemporalThreshold))));
+}
+
+/// internal copy using non-temporal stores for the 16 byte aligned part of the destination
+void streamCopy(uint8_t* const dst, const uint8_t* const src, const uint32_t size) noexcept
+{
+    uint32_t head = (static_cast<uint32_t>(0u - reinterpret_cast<uintptr_t>(dst)) & 15u);
+    if (head > size)
+    {
+        head = size;
+    }
+    memcpy(dst, src, head);
+    uint32_t index = head;
+    for (; (size - index) >= 16; index += 16)
+    {
+        simd::streamStore(&dst[index], simd::loadu(&src[index]));
+    }
+    memcpy(&dst[index], &src[index], (size - index));
+}
+
+/// internal non-temporal prefetch of the source bytes in [offset, offset + size)
+void prefetchText(const utf_text& text, const uint32_t offset, const uint32_t size) noexcept
+{
+    if (simd::kStreaming && (offset < text.length))
+    {
+        const uint32_t limit = (((text.length - offset) < size) ? text.length : (offset + size));
+        for (uint32_t index = offset; index < limit; index += 64)
+        {
+            simd::prefetch(&text.buffer[index]);
+        }
+    }
+}
+
+/// internal UTF16 and UTF32 conversion kernel settings
+struct wide_kernel
+{
+    bool    src_le;     //  little endian source code-units
+    bool    dst_le;     //  little endian destination code-units
+    bool    pairs;      //  surrogate pairs are combined (UTF16) or written (UTF16 and CESU32 destinations)
+    bool    use_nlf;    //  the line-feed variants are left for getNLF()
+};
+
+/// internal check for the UTF16 family sub-types (UTF16 and UCS2)
+inline [[nodiscard]] bool isWide16(const UTF_SUB_TYPE utfSubType) noexcept
+{
+    return ((utfSubType >= UTF_SUB_TYPE::UTF16le) && (utfSubType <= UTF_SUB_TYPE::UCS2be));
+}
+
+/// internal check for the UTF32 family sub-types (UTF32, UCS4, CESU32 and CESU4)
+inline [[nodiscard]] bool isWide32(const UTF_SUB_TYPE utfSubType) noexcept
+{
+    return ((utfSubType >= UTF_SUB_TYPE::UTF32le) && (utfSubType <= UTF_SUB_TYPE::CESU4be));
+}
+
+/// internal check for the little endian UTF16 and UTF32 family sub-types (the le sub-types have even values)
+inline [[nodiscard]] bool isWideLE(const UTF_SUB_TYPE utfSubType) noexcept
+{
+    return ((static_cast<uint32_t>(utfSubType) & 1) == 0);
+}
+
+/// internal check for the UTF32 family sub-types which write supplementary code-points as surrogate pairs
+inline [[nodiscard]] bool isWideCESU(const UTF_SUB_TYPE utfSubType) noexcept
+{
+    return ((utfSubType >= UTF_SUB_TYPE::CESU32le) && (utfSubType <= UTF_SUB_TYPE::CESU4be));
+}
+
+/// internal check for the byte order of unicode_t arrays
+inline [[nodiscard]] bool isHostLE() noexcept
+{
+    const unicode_t probe = 1;
+    return (*reinterpret_cast<const uint8_t*>(&probe) == 1);
+}
+
+/// internal check for a BMP code-point which decodes and encodes in both UTF16 and UTF32 without warnings
+///
+///     U+0001 to U+D7FF, U+E000 to U+FDCF and U+FDF0 to U+FFFD, excluding the line-feed variants when use_nlf is true.
+///
+inline [[nodiscard]] bool isPlainWide(const unicode_t unicode, const bool use_nlf) noexcept
+{
+    const uint32_t value = static_cast<uint32_t>(unicode);
+    const bool plain = ((value - 1u) < 0xd7ffu) || (((value - 0xe000u) < 0x1dd0u) || ((value - 0xfdf0u) < 0x020eu));
+    return (plain && !(use_nlf && (((value - 0x0au) < 4u) || (value == 0x85u) || ((value & 0xfffffffeu) == 0x2028u))));
+}
+
+inline [[nodiscard]] unicode_t loadWide16(const uint8_t* const buffer, const bool le) noexcept
+{
+    return simd::load16(buffer, le);
+}
+
+inline [[nodiscard]] unicode_t loadWide32(const uint8_t* const buffer, const bool le) noexcept
+{
+    return static_cast<unicode_t>(simd::load32(buffer, le));
+}
+
+inline void storeWide16(uint8_t* const buffer, const unicode_t unicode, const bool le) noexcept
+{
+    buffer[le ? 0 : 1] = static_cast<uint8_t>(unicode);
+    buffer[le ? 1 : 0] = static_cast<uint8_t>(unicode >> 8);
+}
+
+inline void storeWide32(uint8_t* const buffer, const unicode_t unicode, const bool le) noexcept
+{
+    buffer[le ? 0 : 3] = static_cast<uint8_t>(unicode);
+    buffer[le ? 1 : 2] = static_cast<uint8_t>(unicode >> 8);
+    buffer[le ? 2 : 1] = static_cast<uint8_t>(unicode >> 16);
+    buffer[le ? 3 : 0] = static_cast<uint8_t>(unicode >> 24);
+}
+
+/// internal UTF16 to UTF32 kernel, converts the leading plain code-units and surrogate pairs (returns the source bytes consumed)
+///
+///     Stops at the first code-unit which is not plain or part of a surrogate pair which can be converted, the
+///     caller handles that code-point with the handlers. Surrogate pairs are only combined when kernel.pairs is
+///     true, and are written as two UTF32 code-units if cesu is true. Surrogate pairs which combine to a
+///     non-character are left to the caller so that repair() can replace them.
+///
+uint32_t widenUTF16(const uint8_t* const src, const uint32_t size, uint8_t* const dst, const uint32_t space, uint32_t& written, const wide_kernel& kernel, const bool cesu, cp_errors& warnings) noexcept
+{
+    uint32_t index = 0;
+    written = 0;
+    const simd::v128 zero = simd::zero();
+    while (((size - index) >= 16) && ((space - written) >= 32))
+    {   //  8 code-units in the range U+0001 to U+D7FF
+        simd::v128 units = simd::loadu(&src[index]);
+        if (!kernel.src_le)
+        {
+            units = simd::swapBytes16(units);
+        }
+        simd::v128 bad = simd::greater16(simd::bitXor(simd::sub16(units, simd::splat16(1)), simd::splat16(0x8000)), simd::splat16(0x57fe));
+        if (kernel.use_nlf)
+        {
+            bad = simd::bitOr(bad, simd::less16(simd::bitXor(simd::sub16(units, simd::splat16(0x0a)), simd::splat16(0x8000)), simd::splat16(0x8004)));
+            bad = simd::bitOr(bad, simd::equal16(units, simd::splat16(0x85)));
+            bad = simd::bitOr(bad, simd::equal16(simd::bitAnd(units, simd::splat16(0xfffe)), simd::splat16(0x2028)));
+        }
+        if (simd::moveMask8(bad))
+        {
+            break;
+        }
+        if (kernel.dst_le)
+        {
+            simd::storeu(&dst[written], simd::interleaveLow16(units, zero));
+            simd::storeu(&dst[written + 16], simd::interleaveHigh16(units, zero));
+        }
+        else
+        {
+            units = simd::swapBytes16(units);
+            simd::storeu(&dst[written], simd::interleaveLow16(zero, units));
+            simd::storeu(&dst[written + 16], simd::interleaveHigh16(zero, units));
+        }
+        index += 16;
+        written += 32;
+    }
+    while (((size - index) >= 2) && ((space - written) >= 4))
+    {
+        const unicode_t unicode = loadWide16(&src[index], kernel.src_le);
+        if (isPlainWide(unicode, kernel.use_nlf))
+        {
+            storeWide32(&dst[written], unicode, kernel.dst_le);
+            index += 2;
+            written += 4;
+            continue;
+        }
+        if (!kernel.pairs || ((unicode & 0xfc00u) != 0xd800u) || ((size - index) < 4))
+        {
+            break;
+        }
+        const unicode_t low = loadWide16(&src[index + 2], kernel.src_le);
+        const unicode_t combined = ((((unicode & 0x03ffu) << 10) | (low & 0x03ffu)) + 0x00010000u);
+        if (((low & 0xfc00u) != 0xdc00u) || ((combined & 0xfffeu) == 0xfffeu))
+        {
+            break;
+        }
+        if (cesu)
+        {
+            if ((space - written) < 8)
+            {
+                break;
+            }
+            storeWide32(&dst[written], unicode, kernel.dst_le);
+            storeWide32(&dst[written + 4], low, kernel.dst_le);
+            written += 8;
+        }
+        else
+        {
+            storeWide32(&dst[written], combined, kernel.dst_le);
+            written += 4;
+        }
+        index += 4;
+        warnings |= (cp_errors::bits::SurrogatePair | cp_errors::bits::Supplementary);
+    }
+    return index;
+}
+
+/// internal UTF32 to UTF16 kernel, converts the leading plain code-points and supplementary code-points (returns the source bytes consumed)
+///
+///     Stops at the first code-point which is not plain or a supplementary code-point which can be written as a
+///     surrogate pair (only when kernel.pairs is true), the caller handles that code-point with the handlers.
+///
+uint32_t narrowUTF32(const uint8_t* const src, const uint32_t size, uint8_t* const dst, const uint32_t space, uint32_t& written, const wide_kernel& kernel, cp_errors& warnings) noexcept
+{
+    uint32_t index = 0;
+    written = 0;
+    while (((size - index) >= 32) && ((space - written) >= 16))
+    {   //  8 code-points in the range U+0001 to U+D7FF
+        simd::v128 units0 = simd::loadu(&src[index]);
+        simd::v128 units1 = simd::loadu(&src[index + 16]);
+        if (!kernel.src_le)
+        {
+            units0 = simd::swapBytes32(units0);
+            units1 = simd::swapBytes32(units1);
+        }
+        const simd::v128 bias = simd::splat32(0x80000000u);
+        const simd::v128 limit = simd::splat32(0x8000d7feu);
+        const simd::v128 one = simd::splat32(1);
+        simd::v128 bad = simd::bitOr(
+            simd::greater32(simd::bitXor(simd::sub32(units0, one), bias), limit),
+            simd::greater32(simd::bitXor(simd::sub32(units1, one), bias), limit));
+        if (kernel.use_nlf)
+        {
+            const simd::v128 units = simd::packSigned32(simd::sub32(units0, simd::splat32(0x8000)), simd::sub32(units1, simd::splat32(0x8000)));
+            const simd::v128 lf = simd::add16(units, simd::splat16(0x8000));
+            bad = simd::bitOr(bad, simd::less16(simd::bitXor(simd::sub16(lf, simd::splat16(0x0a)), simd::splat16(0x8000)), simd::splat16(0x8004)));
+            bad = simd::bitOr(bad, simd::equal16(lf, simd::splat16(0x85)));
+            bad = simd::bitOr(bad, simd::equal16(simd::bitAnd(lf, simd::splat16(0xfffe)), simd::splat16(0x2028)));
+        }
+        if (simd::moveMask8(bad))
+        {
+            break;
+        }
+        simd::v128 units = simd::add16(simd::packSigned32(simd::sub32(units0, simd::splat32(0x8000)), simd::sub32(units1, simd::splat32(0x8000))), simd::splat16(0x8000));
+        if (!kernel.dst_le)
+        {
+            units = simd::swapBytes16(units);
+        }
+        simd::storeu(&dst[written], units);
+        index += 32;
+        written += 16;
+    }
+    while (((size - index) >= 4) && ((space - written) >= 2))
+    {
+        const unicode_t unicode = loadWide32(&src[index], kernel.src_le);
+        if (isPlainWide(unicode, kernel.use_nlf))
+        {
+            storeWide16(&dst[written], unicode, kernel.dst_le);
+            index += 4;
+            written += 2;
+            continue;
+        }
+        if (!kernel.pairs || ((unicode - 0x00010000u) >= 0x00100000u) || ((unicode & 0xfffeu) == 0xfffeu) || ((space - written) < 4))
+        {
+            break;
+        }
+        const unicode_t surrogate = (unicode - 0x00010000u);
+        storeWide16(&dst[written], (0xd800u | (surrogate >> 10)), kernel.dst_le);
+        storeWide16(&dst[written + 2], (0xdc00u | (surrogate & 0x03ffu)), kernel.dst_le);
+        index += 4;
+        written += 4;
+        warnings |= (cp_errors::bits::SurrogatePair | cp_errors::bits::Supplementary);
+    }
+    return index;
+}
+
+/// internal selection of the UTF16 and UTF32 kernels for a pair of handlers
+///
+///     Returns 1 for UTF16 to UTF32, 2 for UTF32 to UTF16 and 0 if neither kernel applies.
+///
+inline [[nodiscard]] uint32_t getWideKernel(const UTF_SUB_TYPE from, const UTF_SUB_TYPE to, const bool use_nlf, wide_kernel& kernel, bool& cesu) noexcept
+{
+    kernel.src_le = isWideLE(from);
+    kernel.dst_le = isWideLE(to);
+    kernel.use_nlf = use_nlf;
+    cesu = false;
+    if (isWide16(from) && isWide32(to))
+    {   //  UCS2 does not combine surrogate pairs
+        kernel.pairs = (from <= UTF_SUB_TYPE::UTF16be);
+        cesu = isWideCESU(to);
+        return 1;
+    }
+    if (isWide32(from) && isWide16(to))
+    {   //  UCS2 cannot write surrogate pairs
+        kernel.pairs = (to <= UTF_SUB_TYPE::UTF16be);
+        return 2;
+    }
+    return 0;
+}
+
+/// internal piecewise constant encoded length of a sub-type
+///
+///     len(unicode) = base (+ zero for U+0000) + the steps of every limit below the code-point, or 0 above maximum.
+///
+struct length_steps
+{
+    uint32_t    maximum;    //  largest encodable code-point
+    uint32_t    base;       //  bytes for the smallest code-points
+    uint32_t    zero;       //  extra bytes for U+0000 (Java style UTF8)
+    uint32_t    count;      //  number of limits
+    uint32_t    limits[6];  //  ascending code-point limits
+    int32_t     steps[6];   //  bytes added (or removed) above each limit
+};
+
+/// internal length steps matching IUTFTK::len() for the UTF8, UTF16, UTF32, BYTE and ASCII families (returns false for other sub-types)
+inline [[nodiscard]] bool getLengthSteps(const UTF_SUB_TYPE utfSubType, length_steps& table) noexcept
+{
+    const uint32_t index = static_cast<uint32_t>(utfSubType);
+    table = { 0, 0, 0, 0, { 0, 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0, 0 } };
+    if (utfSubType <= UTF_SUB_TYPE::JCESU8st)
+    {   //  lenUTF8(): cesu writes supplementary code-points as 6 byte surrogate pairs, java writes U+0000 as 2 bytes
+        const bool cesu = (utfSubType >= UTF_SUB_TYPE::CESU8);
+        table = { 0x7fffffffu, 1, (((index % 6) >= 3) ? 1u : 0u), 6, { 0x7fu, 0x7ffu, 0xffffu, 0x10ffffu, 0x1fffffu, 0x3ffffffu }, { 1, 1, (cesu ? 3 : 1), (cesu ? -2 : 0), 1, 1 } };
+        return true;
+    }
+    if (isWide16(utfSubType))
+    {   //  lenUTF16(): UCS2 cannot encode supplementary code-points
+        const bool ucs2 = (utfSubType >= UTF_SUB_TYPE::UCS2le);
+        table = { (ucs2 ? 0xffffu : 0x10ffffu), 2, 0, 1, { 0xffffu, 0, 0, 0, 0, 0 }, { 2, 0, 0, 0, 0, 0 } };
+        return true;
+    }
+    if (isWide32(utfSubType))
+    {   //  lenUTF32(): CESU32 and CESU4 write supplementary code-points as surrogate pairs, UCS4 and CESU4 encode up to U+7FFFFFFF
+        const bool cesu = isWideCESU(utfSubType);
+        const bool ucs4 = ((utfSubType == UTF_SUB_TYPE::UCS4le) || (utfSubType == UTF_SUB_TYPE::UCS4be) || (utfSubType >= UTF_SUB_TYPE::CESU4le));
+        table = { (ucs4 ? 0x7fffffffu : 0x10ffffu), 4, 0, 2, { 0xffffu, 0x10ffffu, 0, 0, 0, 0 }, { (cesu ? 4 : 0), (cesu ? -4 : 0), 0, 0, 0, 0 } };
+        return true;
+    }
+    if ((utfSubType == UTF_SUB_TYPE::BYTE) || (utfSubType == UTF_SUB_TYPE::BYTEns))
+    {
+        table.maximum = 0xffu;
+        table.base = 1;
+        return true;
+    }
+    if ((utfSubType == UTF_SUB_TYPE::ASCII) || (utfSubType == UTF_SUB_TYPE::ASCIIns))
+    {
+        table.maximum = 0x7fu;
+        table.base = 1;
+        return true;
+    }
+    return false;
+}
+
+/// internal scalar encoded length using the length steps
+inline [[nodiscard]] uint32_t getStepLength(const length_steps& table, const uint32_t unicode) noexcept
+{
+    if (unicode > table.maximum)
+    {
+        return 0;
+    }
+    int32_t bytes = static_cast<int32_t>(table.base + ((unicode == 0) ? table.zero : 0));
+    for (uint32_t index = 0; index < table.count; ++index)
+    {
+        if (unicode > table.limits[index])
+        {
+            bytes += table.steps[index];
+        }
+    }
+    return static_cast<uint32_t>(bytes);
+}
+
+/// internal encoded size of a code-point array using the length steps (4 code-points at a time)
+uint64_t sumStepLengths(const length_steps& table, const unicode_t* const src, const uint32_t count, uint32_t& unencodable, uint8_t* const mask) noexcept
+{
+    uint64_t size = 0;
+    uint32_t index = 0;
+    const simd::v128 bias = simd::splat32(0x80000000u);
+    const simd::v128 maximum = simd::splat32(table.maximum ^ 0x80000000u);
+    const simd::v128 base = simd::splat32(table.base);
+    const simd::v128 zero = simd::splat32(table.zero);
+    simd::v128 limits[6];
+    simd::v128 steps[6];
+    for (uint32_t step = 0; step < table.count; ++step)
+    {
+        limits[step] = simd::splat32(table.limits[step] ^ 0x80000000u);
+        steps[step] = simd::splat32(static_cast<uint32_t>(table.steps[step]));
+    }
+    while (((count - index) >= 4) && isHostLE())
+    {   //  the lane sums are flushed every 64K blocks (each block adds at most 8 per lane), the vector lanes are little endian
+        const uint32_t blocks = ((((count - index) >> 2) < 0x10000u) ? ((count - index) >> 2) : 0x10000u);
+        simd::v128 sums = simd::zero();
+        for (uint32_t block = 0; block < blocks; ++block, index += 4)
+        {
+            const simd::v128 units = simd::loadu(&src[index]);
+            const simd::v128 biased = simd::bitXor(units, bias);
+            simd::v128 bytes = simd::add32(base, simd::bitAnd(simd::equal32(units, simd::zero()), zero));
+            for (uint32_t step = 0; step < table.count; ++step)
+            {
+                bytes = simd::add32(bytes, simd::bitAnd(simd::greater32(biased, limits[step]), steps[step]));
+            }
+            const simd::v128 bad = simd::greater32(biased, maximum);
+            sums = simd::add32(sums, simd::bitAndNot(bad, bytes));
+            const uint32_t bits = simd::moveMask32(bad);
+            if (bits)
+            {
+                unencodable += simd::popCount(bits);
+                if (mask != nullptr)
+                {
+                    mask[index >> 3] |= static_cast<uint8_t>(bits << (index & 4));
+                }
+            }
+        }
+        uint32_t lanes[4];
+        simd::lanes32(sums, lanes);
+        size += (static_cast<uint64_t>(lanes[0]) + lanes[1]) + (static_cast<uint64_t>(lanes[2]) + lanes[3]);
+    }
+    for (; index < count; ++index)
+    {
+        const uint32_t bytes = getStepLength(table, static_cast<uint32_t>(src[index]));
+        if (bytes == 0)
+        {
+            ++unencodable;
+            if (mask != nullptr)
+            {
+                mask[index >> 3] |= static_cast<uint8_t>(1u << (index & 7));
+            }
+        }
+        size += bytes;
+    }
+    return size;
+}
+
+/// internal number of code-points transcoded per custom kernel run
+constexpr uint32_t kCustomRun = 128;
+
+/// internal decode of a leading run of code-points without errors or warnings (returns the bytes consumed)
+uint32_t decodeCustomRun(const IUTFTK& from, const custom_kernels* const kernels, const utf_text& src, unicode_t* const run, const uint32_t capacity, uint32_t& count, const bool use_nlf) noexcept
+{
+    if ((kernels != nullptr) && (kernels->decode != nullptr))
+    {
+        count = 0;
+        return kernels->decode(&src.buffer[src.offset], (src.length - src.offset), run, capacity, count);
+    }
+    utf_text scan = src;
+    for (count = 0; (count < capacity) && (scan.offset < scan.length); ++count)
+    {
+        uint32_t bytes = 0;
+        if ((use_nlf ? from.getNLF(scan, run[count], bytes) : from.get(scan, run[count], bytes)).any())
+        {
+            break;
+        }
+        scan.offset += bytes;
+    }
+    return (scan.offset - src.offset);
+}
+
+/// internal transcoding of a leading run of code-points through the custom sub-type kernels
+///
+///     Only code-points which decode and encode without errors or warnings are transcoded, so the results are
+///     identical to those of the code-point by code-point loop. The decoder kernel must be nullptr when use_nlf is
+///     true. Returns the bytes consumed (0 if there is no run).
+///
+uint32_t transcodeCustomRun(const IUTFTK& from, const custom_kernels* const decoder, const utf_text& src, const IUTFTK& to, const custom_kernels* const encoder, const utf_text& dst, uint32_t& written, const bool use_nlf) noexcept
+{
+    written = 0;
+    unicode_t run[kCustomRun];
+    uint32_t count = 0;
+    uint32_t consumed = decodeCustomRun(from, decoder, src, run, kCustomRun, count, use_nlf);
+    uint32_t encoded = 0;
+    if (count && (encoder != nullptr) && (encoder->encode != nullptr))
+    {
+        encoded = encoder->encode(run, count, &dst.buffer[dst.offset], (dst.length - dst.offset), written);
+    }
+    else if (count)
+    {
+        utf_text target = dst;
+        for (; encoded < count; ++encoded)
+        {
+            uint32_t bytes = 0;
+            if (to.set(target, run[encoded], bytes).any())
+            {
+                break;
+            }
+            target.offset += bytes;
+        }
+        written = (target.offset - dst.offset);
+    }
+    if (encoded == 0)
+    {
+        written = 0;
+        return 0;
+    }
+    if (encoded < count)
+    {   //  measure the source of the code-points which were encoded
+        consumed = decodeCustomRun(from, decoder, src, run, encoded, count, use_nlf);
+    }
+    return consumed;
+}
+
+/// internal transcoding loop shared by transcode() and repair() (the buffers must already be validated)
+[[nodiscard]] cp_errors transcodeBlock(const IUTFTK& from, utf_text& src, const IUTFTK& to, utf_text& dst, uint32_t& repairs, const bool use_repair, const bool use_nlf) noexcept
+{
+    cp_errors errors;
+    const bool ascii = (isAsciiCompatible(from.utfSubType()) && isAsciiCompatible(to.utfSubType()));
+    wide_kernel kernel;
+    bool cesu = false;
+    const uint32_t wide = getWideKernel(from.utfSubType(), to.utfSubType(), use_nlf, kernel, cesu);
+    const custom_kernels* const decoder = (use_nlf ? nullptr : toolkit::getCustomKernels(from));
+    const custom_kernels* const encoder = toolkit::getCustomKernels(to);
+    const bool custom = (((decoder != nullptr) && (decoder->decode != nullptr)) || ((encoder != nullptr) && (encoder->encode != nullptr)));
+    while (src.offset < src.length)
+    {
+        if (custom)
+        {   //  transcode runs of code-points with the custom sub-type kernels
+            uint32_t written = 0;
+            const uint32_t run = transcodeCustomRun(from, decoder, src, to, encoder, dst, written, use_nlf);
+            if (run)
+            {
+                src.offset += run;
+                dst.offset += written;
+                continue;
+            }
+        }
+        else if (ascii)
+        {   //  copy runs of plain ASCII directly (these bytes are identical in both encodings and produce no warnings)
+            const uint32_t space = (dst.length - dst.offset);
+            const uint32_t limit = (src.length - src.offset);
+            const uint32_t run = scanAsciiRun(&src.buffer[src.offset], ((limit < space) ? limit : space), use_nlf);
+            if (run)
+            {
+                memcpy(&dst.buffer[dst.offset], &src.buffer[src.offset], run);
+                src.offset += run;
+                dst.offset += run;
+                continue;
+            }
+        }
+        else if (wide)
+        {   //  convert runs of plain code-units and surrogate pairs between UTF16 and UTF32 directly
+            uint32_t written = 0;
+            const uint32_t run = ((wide == 1) ?
+                widenUTF16(&src.buffer[src.offset], (src.length - src.offset), &dst.buffer[dst.offset], (dst.length - dst.offset), written, kernel, cesu, errors) :
+                narrowUTF32(&src.buffer[src.offset], (src.length - src.offset), &dst.buffer[dst.offset], (dst.length - dst.offset), written, kernel, errors));
+            if (run)
+            {
+                src.offset += run;
+                dst.offset += written;
+                continue;
+            }
+        }
+        unicode_t unicode = 0;
+        uint32_t bytes = 0;
+        cp_errors check = (use_nlf ? from.getNLF(src, unicode, bytes) : from.get(src, unicode, bytes));
+        bool replace = false;
+        if (check.any(cp_errors::bits::ReadTruncated))
+        {   //  never repaired: more data may follow
+            errors |= check;
+            break;
+        }
+        if (check.error() || (use_repair && check.use_replacement_character()))
+        {
+            if (!use_repair)
+            {
+                errors |= check;
+                break;
+            }
+            check = check.warnings_only();
+            unicode = 0xfffd;
+            replace = true;
+        }
+        uint32_t written = 0;
+        cp_errors status = to.set(dst, unicode, written);
+        if (status.error() && use_repair && status.none(cp_errors::bits::WriteOverflow))
+        {   //  not encodable by the 'to' handler
+            status = to.set(dst, 0xfffd, written);
+            if (status.error() && status.none(cp_errors::bits::WriteOverflow))
+            {
+                status = to.set(dst, 0x003f, written);
+            }
+            replace = true;
+        }
+        if (status.error())
+        {
+            errors |= status;
+            break;
+        }
+        errors |= (check | status);
+        src.offset += bytes;
+        dst.offset += written;
+        if (replace)
+        {
+            ++repairs;
+        }
+    }
+    return errors;
+}
+
+/// internal transcoding function shared by transcode() and repair()
+///
+///     Non-temporal output is transcoded through a small cached staging block which is then streamed to the
+///     destination, so the transcoding loop itself is unchanged. The input is prefetched one block ahead.
+///
+[[nodiscard]] cp_errors transcodeText(const IUTFTK& from, utf_text& src, const IUTFTK& to, utf_text& dst, uint32_t& repairs, const bool use_repair, const bool use_nlf, const StoreMode store) noexcept
+{
+    repairs = 0;
+    cp_errors errors = (toolkit::get_errors(src, from.unitSize() - 1) | toolkit::get_errors(dst, to.unitSize() - 1));
+    if (errors.no_error())
+    {
+        if (!useNonTemporal(store, src))
+        {
+            errors |= transcodeBlock(from, src, to, dst, repairs, use_repair, use_nlf);
+        }
+        else
+        {
+            alignas(64) uint8_t staging[4096];
+            for (;;)
+            {
+                const uint32_t space = (dst.length - dst.offset);
+                utf_text block = { ((space < sizeof(staging)) ? space : static_cast<uint32_t>(sizeof(staging))), 0, staging };
+                prefetchText(src, (src.offset + static_cast<uint32_t>(sizeof(staging))), static_cast<uint32_t>(sizeof(staging)));
+                const cp_errors status = transcodeBlock(from, src, to, block, repairs, use_repair, use_nlf);
+                streamCopy(&dst.buffer[dst.offset], staging, block.offset);
+                dst.offset += block.offset;
+                if (status.any(cp_errors::bits::WriteOverflow) && (block.length < space))
+                {   //  only the staging block is full
+                    errors |= status.warnings_only();
+                    continue;
+                }
+                errors |= status;
+                break;
+            }
+            simd::fence();
+        }
+    }
+    return errors;
+}
+
+/// internal width needed to store a set of code-points given their accumulated bits
+inline [[nodiscard]] uint32_t compactWidth(const unicode_t bits) noexcept
+{
+    const uint32_t value = static_cast<uint32_t>(bits);
+    return ((value <= 0x000000ffu) ? 1 : ((value <= 0x0000ffffu) ? 2 : 4));
+}
+
+/// internal check for a valid compact_text width
+inline [[nodiscard]] bool isCompactWidth(const uint32_t width) noexcept
+{
+    return ((width == 1) || (width == 2) || (width == 4));
+}
+
+/// internal scan returning the length in bytes of a run of UTF16 or UTF32 code-units in the range U+0001 to U+D7FF
+///
+///     These code-units decode as themselves without warnings for all of the UTF16 and UTF32 family handlers. The
+///     bits of the code-units scanned are accumulated into bits.
+///
+uint32_t scanPlainWide(const uint8_t* const buffer, const uint32_t size, const uint32_t unit, const bool le, unicode_t& bits) noexcept
+{
+    uint32_t index = 0;
+    simd::v128 accumulated = simd::zero();
+    if (unit == 2)
+    {
+        while ((size - index) >= 16)
+        {
+            simd::v128 units = simd::loadu(&buffer[index]);
+            if (!le)
+            {
+                units = simd::swapBytes16(units);
+            }
+            if (simd::moveMask8(simd::greater16(simd::bitXor(simd::sub16(units, simd::splat16(1)), simd::splat16(0x8000)), simd::splat16(0x57fe))))
+            {
+                break;
+            }
+            accumulated = simd::bitOr(accumulated, units);
+            index += 16;
+        }
+    }
+    else
+    {
+        while ((size - index) >= 16)
+        {
+            simd::v128 units = simd::loadu(&buffer[index]);
+            if (!le)
+            {
+                units = simd::swapBytes32(units);
+            }
+            if (simd::moveMask8(simd::greater32(simd::bitXor(simd::sub32(units, simd::splat32(1)), simd::splat32(0x80000000u)), simd::splat32(0x8000d7feu))))
+            {
+                break;
+            }
+            accumulated = simd::bitOr(accumulated, units);
+            index += 16;
+        }
+    }
+    const unicode_t lanes = static_cast<unicode_t>(simd::orLanes32(accumulated));
+    bits |= ((unit == 2) ? ((lanes | (lanes >> 16)) & 0x0000ffffu) : lanes);
+    while ((size - index) >= unit)
+    {
+        const unicode_t unicode = ((unit == 2) ? loadWide16(&buffer[index], le) : loadWide32(&buffer[index], le));
+        if ((static_cast<uint32_t>(unicode) - 1u) >= 0xd7ffu)
+        {
+            break;
+        }
+        bits |= unicode;
+        index += unit;
+    }
+    return index;
+}
+
+/// internal store of a run of plain ASCII bytes as compact code-points of the given width
+void widenAscii(const uint8_t* const src, const uint32_t count, uint8_t* const dst, const uint32_t width) noexcept
+{
+    uint32_t index = 0;
+    if (width == 1)
+    {
+        memcpy(dst, src, count);
+        return;
+    }
+    const simd::v128 zero = simd::zero();
+    while (((count - index) >= 16) && isHostLE())
+    {   //  the vector lanes are little endian
+        const simd::v128 bytes = simd::loadu(&src[index]);
+        const simd::v128 lo = simd::interleaveLow8(bytes, zero);
+        const simd::v128 hi = simd::interleaveHigh8(bytes, zero);
+        uint8_t* const out = &dst[index * width];
+        if (width == 2)
+        {
+            simd::storeu(&out[0], lo);
+            simd::storeu(&out[16], hi);
+        }
+        else
+        {
+            simd::storeu(&out[0], simd::interleaveLow16(lo, zero));
+            simd::storeu(&out[16], simd::interleaveHigh16(lo, zero));
+            simd::storeu(&out[32], simd::interleaveLow16(hi, zero));
+            simd::storeu(&out[48], simd::interleaveHigh16(hi, zero));
+        }
+        index += 16;
+    }
+    for (; index < count; ++index)
+    {
+        if (width == 2)
+        {
+            reinterpret_cast<uint16_t*>(dst)[index] = src[index];
+        }
+        else
+        {
+            reinterpret_cast<unicode_t*>(dst)[index] = src[index];
+        }
+    }
+}
+
+/// internal store of a run of plain UTF16 or UTF32 code-units as compact code-points of the given width (2 or 4)
+void widenPlainWide(const uint8_t* const src, const uint32_t count, const uint32_t unit, const bool le, uint8_t* const dst, const uint32_t width) noexcept
+{
+    if ((unit == width) && (le == isHostLE()))
+    {
+        memcpy(dst, src, (count * unit));
+        return;
+    }
+    for (uint32_t index = 0; index < count; ++index)
+    {
+        const unicode_t unicode = ((unit == 2) ? loadWide16(&src[index * 2], le) : loadWide32(&src[index * 4], le));
+        if (width == 2)
+        {
+            reinterpret_cast<uint16_t*>(dst)[index] = static_cast<uint16_t>(unicode);
+        }
+        else
+        {
+            reinterpret_cast<unicode_t*>(dst)[index] = unicode;
+        }
+    }
+}
+
+/// internal scan and store of a run of compact code-points in the range U+0001 to U+007F as bytes (returns the code-points stored)
+uint32_t narrowAscii(const compact_text& compact, const uint32_t first, const uint32_t size, uint8_t* const dst) noexcept
+{
+    if (compact.width == 1)
+    {
+        const uint32_t run = scanAsciiRun(&compact.buffer[first], size, false);
+        memcpy(dst, &compact.buffer[first], run);
+        return run;
+    }
+    uint32_t index = 0;
+    if ((compact.width == 2) && isHostLE())
+    {   //  the vector lanes are little endian
+        const uint16_t* const src = &reinterpret_cast<const uint16_t*>(compact.buffer)[first];
+        while ((size - index) >= 8)
+        {
+            const simd::v128 units = simd::loadu(&src[index]);
+            if (simd::moveMask8(simd::greater16(simd::bitXor(simd::sub16(units, simd::splat16(1)), simd::splat16(0x8000)), simd::splat16(0x807e))))
+            {
+                break;
+            }
+            simd::storeLow64(&dst[index], simd::packUnsigned16(units, units));
+            index += 8;
+        }
+    }
+    for (; index < size; ++index)
+    {
+        const unicode_t unicode = compactAt(compact, (first + index));
+        if ((static_cast<uint32_t>(unicode) - 1u) >= 0x7fu)
+        {
+            break;
+        }
+        dst[index] = static_cast<uint8_t>(unicode);
+    }
+    return index;
+}
+
+/// internal per code-point position update
+inline void trackPosition(text_position& position, const unicode_t unicode) noexcept
+{
+    if (unicode == 0x000au)
+    {
+        ++position.line;
+        position.column = 0;
+        position.units = 0;
+    }
+    else
+    {
+        ++position.column;
+        position.units += ((static_cast<uint32_t>(unicode) > 0xffffu) ? 2 : 1);
+    }
+}
+
+/// internal word-at-a-time position update over plain ASCII, returns the number of bytes counted
+///
+///     Words of 8 bytes in the range 0x01 to 0x7f are counted at once. The line-feeds (0x0a) in a word are counted
+///     with a population count of the match mask, words containing the other line-feed variants (0x0b to 0x0d) or
+///     followed by a possible { 0x0a, 0x0d } pairing are left to the caller.
+///
+uint32_t trackAsciiWords(text_position& position, const uint8_t* const buffer, const uint32_t size, const uint32_t available) noexcept
+{
+    const uint64_t ones = 0x0101010101010101ull;
+    const uint64_t high = 0x8080808080808080ull;
+    uint32_t index = 0;
+    while ((size - index) >= 8)
+    {
+        uint64_t word;
+        memcpy(&word, &buffer[index], 8);
+        if (((word | (word - ones)) & high) != 0)
+        {   //  not plain ASCII
+            break;
+        }
+        const uint64_t variants = ((word + (ones * 0x76u)) & ~(word + (ones * 0x72u)) & high);    //  bytes 0x0a to 0x0d
+        const uint64_t feeds = (~((word ^ (ones * 0x0au)) + (ones * 0x7fu)) & high);           //  bytes 0x0a
+        if (variants != feeds)
+        {
+            break;
+        }
+        if (feeds == 0)
+        {
+            position.column += 8;
+            position.units += 8;
+        }
+        else
+        {
+            if (((index + 8) < available) && (buffer[index + 8] == 0x0du))
+            {   //  possible { 0x0a, 0x0d } pairing
+                break;
+            }
+            uint32_t last = 7;
+            while (buffer[index + last] != 0x0au)
+            {
+                --last;
+            }
+            position.line += static_cast<uint32_t>(((feeds >> 7) * ones) >> 56);
+            position.column = (7 - last);
+            position.units = (7 - last);
+        }
+        index += 8;
+    }
+    return index;
+}
+
+/// internal structural character bit masks of a 64 byte block (bit n corresponds to byte n)
+struct block_masks
+{
+    uint64_t    quote;
+    uint64_t    delimiter;
+    uint64_t    feed;       //  bytes 0x0a to 0x0d
+    uint64_t    special;    //  possible first bytes of other line-feed variants
+};
+
+/// internal structural character search (quote and special bytes of 0 are disabled)
+void getBlockMasks(const uint8_t* const data, const uint32_t size, const uint8_t delimiter, const uint8_t quote, const uint8_t special0, const uint8_t special1, block_masks& masks) noexcept
+{
+    alignas(16) uint8_t block[64];
+    const uint8_t* source = data;
+    if (size < 64)
+    {
+        memset(block, 0, sizeof(block));
+        memcpy(block, data, size);
+        source = block;
+    }
+    const simd::block64 bytes = simd::loadBlock(source);
+    masks.quote = simd::equalMask(bytes, quote);
+    masks.delimiter = simd::equalMask(bytes, delimiter);
+    masks.feed = simd::rangeMask(bytes, 0x0a, 3);
+    masks.special = (simd::equalMask(bytes, special0) | simd::equalMask(bytes, special1));
+    const uint64_t valid = ((size < 64) ? ((1ull << size) - 1) : ~0ull);
+    masks.quote &= ((quote != 0) ? valid : 0);
+    masks.delimiter &= valid;
+    masks.feed &= valid;
+    masks.special &= ((special0 != 0) ? valid : 0);
+}
+
+/// internal record field setup, fields containing quotes are classified by decoding (the field is [start, end) of the buffer)
+void setField(const IUTFTK& handler, uint8_t* const buffer, const uint32_t start, const uint32_t end, const unicode_t quote, const bool bytewise, record_field& field, cp_errors& errors) noexcept
+{
+    field.text = { (end - start), 0, &buffer[start] };
+    field.quoted = false;
+    if ((quote == 0) || (start == end) || (bytewise && (memchr(&buffer[start], static_cast<int>(quote), (end - start)) == nullptr)))
+    {
+        return;
+    }
+    utf_text scan = { end, start, buffer };
+    unicode_t unicode = 0;
+    uint32_t bytes = 0;
+    bool opening = false;
+    bool pending = false;
+    bool irregular = false;
+    uint32_t first = 0;
+    uint32_t closing = 0;
+    while ((scan.offset < end) && handler.get(scan, unicode, bytes).no_error())
+    {
+        if (scan.offset == start)
+        {
+            opening = (unicode == quote);
+            first = bytes;
+        }
+        else if (unicode == quote)
+        {
+            closing = (pending ? closing : scan.offset);
+            pending = !pending;
+            irregular = (irregular || !opening);
+        }
+        else if (pending)
+        {   //  text after a closing quote
+            irregular = true;
+        }
+        scan.offset += bytes;
+    }
+    if (opening && pending && !irregular)
+    {
+        field.text = { (closing - (start + first)), 0, &buffer[start + first] };
+        field.quoted = true;
+    }
+    else if (opening || irregular)
+    {
+        errors |= cp_errors::bits::IrregularForm;
+    }
+}
+
+/// internal reference record splitter (decodes every code-point)
+[[nodiscard]] cp_errors scanRecord(const IUTFTK& handler, uint8_t* const buffer, const uint32_t length, const record_format& format, record_field* const fields, const uint32_t capacity, uint32_t& count, uint32_t& bytes) noexcept
+{
+    cp_errors errors;
+    utf_text scan = { length, 0, buffer };
+    uint32_t start = 0;
+    bool quoted = false;
+    for (;;)
+    {
+        unicode_t unicode = 0;
+        uint32_t size = 0;
+        const cp_errors check = handler.getNLF(scan, unicode, size);
+        errors |= check;
+        if (check.error())
+        {
+            return errors;
+        }
+        const uint32_t position = scan.offset;
+        const bool exhausted = check.any(cp_errors::bits::ReadExhausted);
+        if (exhausted && quoted)
+        {
+            errors |= (cp_errors::bits::Failed | cp_errors::bits::ReadTruncated);
+            return errors;
+        }
+        if ((format.quote != 0) && (unicode == format.quote) && !exhausted)
+        {
+            quoted = !quoted;
+        }
+        else if (!quoted && (exhausted || (unicode == format.delimiter) || (unicode == 0x000au)))
+        {
+            if (count < capacity)
+            {
+                setField(handler, buffer, start, position, format.quote, false, fields[count], errors);
+            }
+            ++count;
+            start = (position + size);
+            if (unicode != format.delimiter)
+            {
+                bytes = start;
+                return errors;
+            }
+        }
+        scan.offset += size;
+    }
+}
+
+/// internal fast record splitter for ASCII compatible sub-types (returns false if the reference splitter must be used)
+bool scanRecordBlocks(const IUTFTK& handler, uint8_t* const buffer, const uint32_t length, const record_format& format, record_field* const fields, const uint32_t capacity, uint32_t& count, uint32_t& bytes, cp_errors& errors) noexcept
+{
+    const uint8_t delimiter = static_cast<uint8_t>(format.delimiter);
+    const uint8_t quote = static_cast<uint8_t>(format.quote);
+    const uint32_t index = static_cast<uint32_t>(handler.utfSubType());
+    const bool utf8 = (index <= static_cast<uint32_t>(UTF_SUB_TYPE::JCESU8st));
+    const bool byte = ((index == static_cast<uint32_t>(UTF_SUB_TYPE::BYTE)) || (index == static_cast<uint32_t>(UTF_SUB_TYPE::BYTEns)));
+    const uint8_t special0 = (utf8 ? 0xc2u : (byte ? 0x85u : 0));   //  U+0085 (UTF8 and ISO-8859-1)
+    const uint8_t special1 = (utf8 ? 0xe2u : (byte ? 0x85u : 0));   //  U+2028 and U+2029 (UTF8)
+    uint64_t carry = 0;
+    uint32_t start = 0;
+    uint32_t end = 0;
+    bool done = false;
+    for (uint32_t position = 0; !done && (position < length); position += 64)
+    {
+        const uint32_t size = (((length - position) < 64) ? (length - position) : 64);
+        block_masks masks;
+        getBlockMasks(&buffer[position], size, delimiter, quote, special0, special1, masks);
+        const uint64_t quoted = (simd::prefixXor(masks.quote) ^ carry);
+        uint64_t structural = ((masks.delimiter | masks.feed | masks.special) & ~quoted);
+        while (structural != 0)
+        {
+            const uint32_t offset = (position + simd::lowestBit(structural));
+            structural &= (structural - 1);
+            if (buffer[offset] != delimiter)
+            {   //  possible line-feed
+                const utf_text at = { length, offset, buffer };
+                unicode_t unicode = 0;
+                uint32_t size = 0;
+                if (handler.getNLF(at, unicode, size).error())
+                {
+                    return false;
+                }
+                if (unicode != 0x000au)
+                {
+                    continue;
+                }
+                end = (offset + size);
+                done = true;
+            }
+            if (count < capacity)
+            {
+                setField(handler, buffer, start, offset, format.quote, true, fields[count], errors);
+            }
+            ++count;
+            start = (offset + 1);
+            if (done)
+            {
+                break;
+            }
+        }
+        carry = (((quoted >> 63) != 0) ? ~0ull : 0);
+    }
+    if (!done)
+    {
+        if (carry != 0)
+        {   //  the reference splitter reports the open quote
+            return false;
+        }
+        if (count < capacity)
+        {
+            setField(handler, buffer, start, length, format.quote, true, fields[count], errors);
+        }
+        ++count;
+        end = length;
+        const utf_text at = { length, length, buffer };
+        unicode_t unicode = 0;
+        uint32_t size = 0;
+        errors |= handler.get(at, unicode, size);   //  ReadExhausted (and any warnings the handler reports with it)
+    }
+    utf_text record = { end, 0, buffer };
+    const cp_errors check = validate(handler, record);
+    if (check.error() || check.any(cp_errors::bits::OverlongUTF8 | cp_errors::bits::ModifiedUTF8))
+    {   //  the reference splitter reports the decode error (and decodes overlong delimiter, quote and line-feed encodings)
+        return false;
+    }
+    errors |= check;
+    bytes = end;
+    return true;
+}
+
+/// internal white space scanning modes
+enum class WhiteScan : uint8_t
+{
+    Decode = 0, //  decode every code-point
+    UTF8,       //  UTF8 family: decode the lead bytes of multi-byte (including overlong) white space encodings
+    BYTE,       //  ISO-8859-1: decode 0x85
+    Other       //  other ASCII compatible sub-types: decode every byte above 0x7f
+};
+
+inline [[nodiscard]] WhiteScan getWhiteScan(const IUTFTK& handler) noexcept
+{
+    const UTF_SUB_TYPE utfSubType = handler.utfSubType();
+    const uint32_t index = static_cast<uint32_t>(utfSubType);
+    if ((handler.unitSize() != 1) || !isAsciiCompatible(utfSubType))
+    {
+        return WhiteScan::Decode;
+    }
+    if (index <= static_cast<uint32_t>(UTF_SUB_TYPE::JCESU8st))
+    {
+        return WhiteScan::UTF8;
+    }
+    return (((utfSubType == UTF_SUB_TYPE::BYTE) || (utfSubType == UTF_SUB_TYPE::BYTEns)) ? WhiteScan::BYTE : WhiteScan::Other);
+}
+
+/// internal white space byte masks of a 16 byte block (bit n corresponds to byte n)
+struct white_masks
+{
+    uint32_t    white;      //  ASCII white space bytes
+    uint32_t    candidate;  //  bytes which must be decoded
+    uint32_t    trailing;   //  UTF8 continuation bytes
+};
+
+void getWhiteMasks(const uint8_t* const data, const uint32_t size, const WhiteScan scan, white_masks& masks) noexcept
+{
+    alignas(16) uint8_t block[16];
+    const uint8_t* source = data;
+    if (size < 16)
+    {
+        memset(block, 0, sizeof(block));
+        memcpy(block, data, size);
+        source = block;
+    }
+    const simd::v128 bytes = simd::loadu(source);
+    const simd::v128 controls = simd::sub8(bytes, simd::splat8(0x09));
+    const simd::v128 white = simd::bitOr(simd::equal8(simd::min8u(controls, simd::splat8(4)), controls), simd::equal8(bytes, simd::splat8(0x20)));
+    masks.white = simd::moveMask8(white);
+    masks.candidate = 0;
+    masks.trailing = 0;
+    if (scan == WhiteScan::UTF8)
+    {   //  0xc0, 0xe0 (overlong), 0xc2, 0xe1 to 0xe3, 0xf0, 0xf4, 0xf8 and 0xfc (overlong)
+        const simd::v128 leads = simd::sub8(bytes, simd::splat8(0xe1));
+        const simd::v128 trails = simd::sub8(bytes, simd::splat8(0x80));
+        simd::v128 candidate = simd::equal8(simd::bitAnd(bytes, simd::splat8(0xdf)), simd::splat8(0xc0));
+        candidate = simd::bitOr(candidate, simd::equal8(simd::bitAnd(bytes, simd::splat8(0xf3)), simd::splat8(0xf0)));
+        candidate = simd::bitOr(candidate, simd::equal8(bytes, simd::splat8(0xc2)));
+        candidate = simd::bitOr(candidate, simd::equal8(simd::min8u(leads, simd::splat8(2)), leads));
+        masks.candidate = simd::moveMask8(candidate);
+        masks.trailing = simd::moveMask8(simd::equal8(simd::min8u(trails, simd::splat8(0x3f)), trails));
+    }
+    else if (scan == WhiteScan::BYTE)
+    {
+        masks.candidate = simd::moveMask8(simd::equal8(bytes, simd::splat8(0x85)));
+    }
+    else
+    {
+        masks.candidate = simd::moveMask8(bytes);
+    }
+    const uint32_t valid = ((1u << size) - 1);
+    masks.white &= valid;
+    masks.candidate &= valid;
+    masks.trailing &= valid;
+}
+
+/// internal breaking white space check of the code-point at offset (size is set to the code-point size, at least one code-unit)
+[[nodiscard]] bool decodeWhite(const IUTFTK& handler, uint8_t* const buffer, const uint32_t offset, const uint32_t length, uint32_t& size) noexcept
+{   //  code-points which fail to decode are not white space
+    const utf_text at = { length, offset, buffer };
+    unicode_t unicode = 0;
+    size = 0;
+    const bool white = (handler.get(at, unicode, size).no_error() && isBreakingWhite(unicode));
+    const uint32_t remaining = (length - offset);
+    size = ((size < handler.unitSize()) ? handler.unitSize() : ((size > remaining) ? remaining : size));
+    return white;
+}
+
+/// internal search for the first code-point at or after offset which is (or is not) breaking white space
+[[nodiscard]] uint32_t findWhite(const IUTFTK& handler, const WhiteScan scan, uint8_t* const buffer, uint32_t offset, const uint32_t length, const bool white) noexcept
+{
+    while (offset < length)
+    {
+        if (scan != WhiteScan::Decode)
+        {
+            const uint32_t count = (((length - offset) < 16) ? (length - offset) : 16);
+            white_masks masks;
+            getWhiteMasks(&buffer[offset], count, scan, masks);
+            const uint32_t stops = (white ? (masks.white | masks.candidate) : (~masks.white & ((1u << count) - 1)));
+            if (stops == 0)
+            {
+                offset += count;
+                continue;
+            }
+            const uint32_t index = simd::lowestBit(stops);
+            offset += index;
+            if (((masks.candidate >> index) & 1) == 0)
+            {   //  ASCII white space or a byte which cannot start a white space code-point
+                return offset;
+            }
+        }
+        uint32_t size = 0;
+        if (decodeWhite(handler, buffer, offset, length, size) == white)
+        {
+            return offset;
+        }
+        offset += size;
+    }
+    return length;
+}
+
+/// internal search for the end of the last code-point which is not breaking white space (returns start if there is none)
+[[nodiscard]] uint32_t findTextEnd(const IUTFTK& handler, const WhiteScan scan, uint8_t* const buffer, const uint32_t start, const uint32_t length) noexcept
+{   //  the reverse scan finds the last byte which cannot be part of a white space code-point, the remainder is decoded forwards from it
+    uint32_t from = start;
+    if (scan != WhiteScan::Decode)
+    {
+        for (uint32_t end = length; end > start;)
+        {
+            const uint32_t count = (((end - start) < 16) ? (end - start) : 16);
+            end -= count;
+            white_masks masks;
+            getWhiteMasks(&buffer[end], count, scan, masks);
+            const uint32_t text = (~(masks.white | masks.candidate | masks.trailing) & ((1u << count) - 1));
+            if (text != 0)
+            {
+                from = (end + simd::highestBit(text));
+                break;
+            }
+        }
+    }
+    uint32_t last = start;
+    while (from < length)
+    {
+        const uint32_t stop = findWhite(handler, scan, buffer, from, length, true);
+        last = ((stop > from) ? stop : last);
+        from = findWhite(handler, scan, buffer, stop, length, false);
+    }
+    return last;
+}
+
+/// internal log sanitizing scanning modes
+enum class LogScan : uint8_t
+{
+    Decode = 0, //  decode every code-point
+    UTF8,       //  UTF8 family: skip printable ASCII and decode well-formed 2 and 3 byte sequences inline
+    Byte        //  other ASCII compatible sub-types: skip printable ASCII
+};
+
+inline [[nodiscard]] LogScan getLogScan(const IUTFTK& handler) noexcept
+{
+    const UTF_SUB_TYPE utfSubType = handler.utfSubType();
+    if ((handler.unitSize() != 1) || !isAsciiCompatible(utfSubType))
+    {
+        return LogScan::Decode;
+    }
+    return ((utfSubType <= UTF_SUB_TYPE::JCESU8st) ? LogScan::UTF8 : LogScan::Byte);
+}
+
+/// internal classification of a code-point for sanitizeForLog()
+enum class LogHit : uint8_t
+{
+    Clean = 0,  //  copied unchanged
+    Flagged,    //  a control, non-character, surrogate or bidi control code-point
+    Malformed   //  a sequence which failed to decode, an irregular or overlong encoding or a code-point above U+10FFFF
+};
+
+/// internal check for the code-points which sanitizeForLog() flags
+inline [[nodiscard]] bool isLogFlagged(const unicode_t unicode) noexcept
+{
+    if (static_cast<uint32_t>(unicode) < 0x061cu)
+    {
+        return isCC(unicode);
+    }
+    if (static_cast<uint32_t>(unicode) < 0xd800u)
+    {
+        return isBidiControl(unicode);
+    }
+    return (isSurrogate(unicode) || isNonCharacter(unicode));
+}
+
+/// internal mask of the bytes of a 16 byte block which are not printable ASCII (bit n corresponds to byte n)
+uint32_t getLogMask(const uint8_t* const data, const uint32_t size) noexcept
+{
+    alignas(16) uint8_t block[16];
+    const uint8_t* source = data;
+    if (size < 16)
+    {
+        memset(block, 0, sizeof(block));
+        memcpy(block, data, size);
+        source = block;
+    }
+    //  0x20 to 0x7e are biased to 0x80 to 0xde, the only signed values below 0xdf
+    const simd::v128 biased = simd::add8(simd::loadu(source), simd::splat8(0x60));
+    const uint32_t mask = ~simd::moveMask8(simd::less8(biased, simd::splat8(0xdf)));
+    return (mask & ((1u << size) - 1));
+}
+
+/// internal inline decode of a well-formed 2 or 3 byte UTF8 sequence (returns 0 if the sequence must be decoded by the handler)
+inline [[nodiscard]] uint32_t decodeLogUTF8(const uint8_t* const data, const uint32_t remaining, unicode_t& unicode) noexcept
+{
+    const uint32_t lead = data[0];
+    if ((lead >= 0xc2u) && (lead <= 0xdfu) && (remaining >= 2) && ((data[1] & 0xc0u) == 0x80u))
+    {
+        unicode = static_cast<unicode_t>(((lead & 0x1fu) << 6) | (data[1] & 0x3fu));
+        return 2;
+    }
+    if (((lead & 0xf0u) == 0xe0u) && (remaining >= 3) && ((data[1] & 0xc0u) == 0x80u) && ((data[2] & 0xc0u) == 0x80u))
+    {
+        const uint32_t value = (((lead & 0x0fu) << 12) | ((data[1] & 0x3fu) << 6) | (data[2] & 0x3fu));
+        if ((value >= 0x0800u) && ((value & 0xf800u) != 0xd800u))
+        {
+            unicode = static_cast<unicode_t>(value);
+            return 3;
+        }
+    }
+    return 0;
+}
+
+/// internal classification of the code-point at offset (size is set to the code-point size, at least one code-unit)
+[[nodiscard]] LogHit classifyForLog(const IUTFTK& handler, uint8_t* const buffer, const uint32_t offset, const uint32_t length, unicode_t& unicode, uint32_t& size) noexcept
+{
+    const utf_text at = { length, offset, buffer };
+    unicode = 0;
+    size = 0;
+    const cp_errors errors = handler.get(at, unicode, size);
+    const uint32_t remaining = (length - offset);
+    size = ((size < handler.unitSize()) ? handler.unitSize() : ((size > remaining) ? remaining : size));
+    if (errors.error() || errors.any(cp_errors::bits::IrregularForm | cp_errors::bits::OverlongUTF8 | cp_errors::bits::ExtendedUTF8) || (static_cast<uint32_t>(unicode) > 0x0010ffffu))
+    {
+        return LogHit::Malformed;
+    }
+    return (isLogFlagged(unicode) ? LogHit::Flagged : LogHit::Clean);
+}
+
+/// internal search for the first code-point at or after offset which is not clean (returns the end of the clean code-points which end by limit)
+[[nodiscard]] uint32_t findLogHit(const IUTFTK& handler, const LogScan scan, uint8_t* const buffer, uint32_t offset, const uint32_t limit, const uint32_t length) noexcept
+{
+    while (offset < limit)
+    {
+        if (scan != LogScan::Decode)
+        {
+            const uint32_t count = (((limit - offset) < 16) ? (limit - offset) : 16);
+            const uint32_t mask = getLogMask(&buffer[offset], count);
+            if (mask == 0)
+            {
+                offset += count;
+                continue;
+            }
+            offset += simd::lowestBit(mask);
+            if ((scan == LogScan::UTF8) && (buffer[offset] >= 0x80u))
+            {
+                unicode_t unicode = 0;
+                const uint32_t size = decodeLogUTF8(&buffer[offset], (length - offset), unicode);
+                if (size != 0)
+                {
+                    if (isLogFlagged(unicode) || (size > (limit - offset)))
+                    {
+                        return offset;
+                    }
+                    offset += size;
+                    continue;
+                }
+            }
+        }
+        unicode_t unicode = 0;
+        uint32_t size = 0;
+        if ((classifyForLog(handler, buffer, offset, length, unicode, size) != LogHit::Clean) || (size > (limit - offset)))
+        {
+            return offset;
+        }
+        offset += size;
+    }
+    return offset;
+}
+
+/// internal encoding of an ASCII string (returns false if it does not fit)
+[[nodiscard]] bool writeLogAscii(const IUTFTK& handler, const char* const ascii, const uint32_t count, utf_text& dst) noexcept
+{
+    if ((static_cast<uint64_t>(count) * handler.len(0x005cu)) > (dst.length - dst.offset))
+    {
+        return false;
+    }
+    for (uint32_t index = 0; index < count; ++index)
+    {
+        uint32_t bytes = 0;
+        (void)handler.set(dst, static_cast<unicode_t>(ascii[index]), bytes);
+        dst.offset += bytes;
+    }
+    return true;
+}
+
+/// internal escape of a flagged code-point (\u{...}) or of each byte of a malformed sequence (\xNN)
+[[nodiscard]] bool writeLogEscape(const IUTFTK& handler, const LogHit hit, const unicode_t unicode, const uint8_t* const data, const uint32_t size, utf_text& dst) noexcept
+{
+    static const char digits[] = "0123456789ABCDEF";
+    char ascii[64];
+    uint32_t count = 0;
+    if (hit == LogHit::Flagged)
+    {
+        const uint32_t value = static_cast<uint32_t>(unicode);
+        ascii[count++] = '\\';
+        ascii[count++] = 'u';
+        ascii[count++] = '{';
+        uint32_t shift = 28;
+        while ((shift != 0) && ((value >> shift) == 0))
+        {
+            shift -= 4;
+        }
+        for (;; shift -= 4)
+        {
+            ascii[count++] = digits[(value >> shift) & 15];
+            if (shift == 0)
+            {
+                break;
+            }
+        }
+        ascii[count++] = '}';
+    }
+    else
+    {   //  malformed sequences can be runs of any length (the coalescing and skipping sub-types), so the escape is
+        //  written in pieces once the whole of it is known to fit (the escape of a sequence is never split)
+        if ((static_cast<uint64_t>(size) * 4 * handler.len(0x005cu)) > (dst.length - dst.offset))
+        {
+            return false;
+        }
+        uint32_t index = 0;
+        while (index < size)
+        {
+            count = 0;
+            for (; (index < size) && (count < sizeof(ascii)); ++index)
+            {
+                ascii[count++] = '\\';
+                ascii[count++] = 'x';
+                ascii[count++] = digits[data[index] >> 4];
+                ascii[count++] = digits[data[index] & 15];
+            }
+            (void)writeLogAscii(handler, ascii, count, dst);
+        }
+        return true;
+    }
+    return writeLogAscii(handler, ascii, count, dst);
+}
+
+/// internal distance before an edit which a code-point decode may read beyond the end of the code-point
+constexpr uint32_t kValidationLookahead = 16;
+
+/// internal block summary update decoding from a code-point boundary in the first block
+///
+///     When resynchronise is true the update stops at the first block starting at or after 'limit' whose recorded
+///     start matches the decoding (the remaining summaries are unchanged).
+///
+void decodeBlocks(const IUTFTK& handler, uint8_t* const buffer, const uint32_t length, validation_state& state, const uint32_t first, const bool resynchronise, const uint32_t limit) noexcept
+{
+    validation_block* const blocks = state.blocks;
+    const uint32_t unit = handler.unitSize();
+    uint32_t current = first;
+    uint32_t position = blocks[current].start;
+    blocks[current].errors = cp_errors();
+    while (position < length)
+    {
+        const uint32_t index = (position >> state.shift);
+        if (index != current)
+        {
+            for (uint32_t fill = (current + 1); fill < index; ++fill)
+            {   //  blocks inside a long code-point
+                blocks[fill] = { cp_errors(), position };
+            }
+            if (resynchronise && ((static_cast<uint64_t>(index) << state.shift) >= limit) && (blocks[index].start == position))
+            {
+                return;
+            }
+            current = index;
+            blocks[current] = { cp_errors(), position };
+        }
+        const utf_text at = { length, position, buffer };
+        unicode_t unicode = 0;
+        uint32_t bytes = 0;
+        blocks[current].errors |= handler.get(at, unicode, bytes);
+        const uint32_t remaining = (length - position);
+        position += ((bytes < unit) ? unit : ((bytes > remaining) ? remaining : bytes));
+    }
+    for (uint32_t fill = (current + 1); fill < state.count; ++fill)
+    {
+        blocks[fill] = { cp_errors(), length };
+    }
+}
+
+/// internal block summary accumulation
+[[nodiscard]] cp_errors accumulateBlocks(validation_state& state) noexcept
+{
+    cp_errors errors;
+    for (uint32_t index = 0; index < state.count; ++index)
+    {
+        errors |= state.blocks[index].errors;
+    }
+    state.errors = errors;
+    return errors;
+}
+
+/// internal validation state checks, sets the block count for the text length
+[[nodiscard]] cp_errors prepareBlocks(const IUTFTK& handler, const utf_text& text, validation_state& state) noexcept
+{
+    cp_errors errors = toolkit::get_errors(text, handler.unitSize() - 1);
+    if (errors.no_error())
+    {
+        if ((state.blocks == nullptr) || (state.shift < 6) || (state.shift > 31))
+        {
+            errors |= (cp_errors::bits::Failed | cp_errors::bits::InvalidBuffer);
+        }
+        else
+        {
+            const uint32_t length = (text.length - text.offset);
+            const uint64_t count = ((static_cast<uint64_t>(length) + ((1ull << state.shift) - 1)) >> state.shift);
+            if (count > state.capacity)
+            {
+                errors |= (cp_errors::bits::Failed | cp_errors::bits::WriteOverflow);
+            }
+            else
+            {
+                state.count = static_cast<uint32_t>(count);
+                state.length = length;
+            }
+        }
+    }
+    if (errors.error())
+    {
+        state.count = 0;
+        state.length = 0;
+        state.errors = errors;
+    }
+    return errors;
+}
+
+/// internal safe chunk boundary search
+///
+///     Returns the first offset in [start, limit) at which the buffer can be split, or limit if there is none.
+///     A split is safe if the units either side of it are always decoded independently of each other.
+///
+uint32_t findBoundary(const IUTFTK& handler, const uint8_t* const buffer, const uint32_t start, const uint32_t limit) noexcept
+{
+    const uint32_t size = handler.unitSize();
+    const uint32_t index = static_cast<uint32_t>(handler.utfSubType());
+    if (toolkit::isCustomSubType(handler.utfSubType()))
+    {   //  custom encodings are decoded from the start of the chunk to find the code-point boundaries
+        utf_text scan = { limit, 0, const_cast<uint8_t*>(buffer) };
+        unicode_t prior = 0;
+        while (scan.offset < limit)
+        {
+            if ((scan.offset >= start) && (prior != 0x0au) && (prior != 0x0du) && ((prior & 0xfffffc00u) != 0x0000d800u))
+            {   //  not a possible line-feed pairing or leading high surrogate
+                return scan.offset;
+            }
+            uint32_t bytes = 0;
+            const cp_errors check = handler.get(scan, prior, bytes);
+            if (check.any(cp_errors::bits::ReadTruncated) || (bytes == 0))
+            {
+                break;
+            }
+            scan.offset += bytes;
+        }
+    }
+    else if (size == 1)
+    {
+        const bool utf8 = (index <= static_cast<uint32_t>(UTF_SUB_TYPE::JCESU8st));
+        const bool byte = ((index == static_cast<uint32_t>(UTF_SUB_TYPE::BYTE)) || (index == static_cast<uint32_t>(UTF_SUB_TYPE::BYTEns)));
+        for (uint32_t offset = start; offset < limit; ++offset)
+        {
+            const uint8_t prior = buffer[offset - 1];
+            if ((prior == 0x0au) || (prior == 0x0du))
+            {   //  possible line-feed pairing
+                continue;
+            }
+            if ((prior < 0x80u) || byte)
+            {   //  ASCII bytes are always single byte code-points and ISO-8859-1 bytes never coalesce
+                return offset;
+            }
+            if (utf8)
+            {   //  a legal lead byte terminates any preceding sequence, 0xed is excluded to keep CESU surrogate pairs together
+                const uint8_t next = buffer[offset];
+                if (((next & 0xc0u) != 0x80u) && (next < 0xfeu) && (next != 0xedu))
+                {   //  the preceding sequence must not be cut short (a truncated sequence is reported differently)
+                    uint32_t count = 1;
+                    while ((count < 6) && (count < offset) && ((buffer[offset - count] & 0xc0u) == 0x80u))
+                    {
+                        ++count;
+                    }
+                    const uint8_t lead = buffer[offset - count];
+                    const uint32_t expected = ((lead < 0xc0u) || (lead >= 0xfeu)) ? 1 : ((lead < 0xe0u) ? 2 : ((lead < 0xf0u) ? 3 : ((lead < 0xf8u) ? 4 : ((lead < 0xfcu) ? 5 : 6))));
+                    if ((expected <= count) && !((count == 3) && (lead == 0xedu) && ((buffer[offset - 2] & 0xf0u) == 0xa0u)))
+                    {   //  not a truncated sequence or a leading high surrogate
+                        return offset;
+                    }
+                }
+            }
+        }
+    }
+    else
+    {
+        const bool le = ((handler.utfType() == UTF_TYPE::UTF16le) || (handler.utfType() == UTF_TYPE::UTF32le));
+        for (uint32_t offset = start; offset < limit; offset += size)
+        {
+            const uint8_t* const unit = &buffer[offset - size];
+            const uint32_t value = ((size == 2) ? simd::load16(unit, le) : simd::load32(unit, le));
+            if ((value != 0x0au) && (value != 0x0du) && ((value & 0xfffffc00u) != 0x0000d800u))
+            {   //  not a possible line-feed pairing or leading high surrogate
+                return offset;
+            }
+        }
+    }
+    return limit;
+}
+
+/// internal size of the temporary buffers for a code-point which spans fragments (longer than any encoded code-point or CR LF pair)
+constexpr uint32_t kFragmentBridge = 16;
+
+/// internal limit of the trailing code-points excluded from a fragment view
+constexpr uint32_t kFragmentExclusions = 8;
+
+/// internal check of the fragments from the current fragment (empty fragments may have a null buffer)
+[[nodiscard]] cp_errors getFragmentErrors(const text_fragments& list) noexcept
+{
+    cp_errors errors;
+    if ((list.fragments == nullptr) && (list.count != 0))
+    {
+        errors |= (cp_errors::bits::Failed | cp_errors::bits::InvalidBuffer);
+    }
+    else
+    {
+        for (uint32_t index = list.index; index < list.count; ++index)
+        {
+            const utf_text& fragment = list.fragments[index];
+            if ((fragment.length != 0) || (fragment.offset != 0))
+            {
+                errors |= toolkit::get_errors(fragment);
+            }
+        }
+    }
+    return errors;
+}
+
+/// internal skip of the exhausted fragments
+inline void skipFragments(text_fragments& list) noexcept
+{
+    while ((list.index < list.count) && (list.fragments[list.index].offset >= list.fragments[list.index].length))
+    {
+        ++list.index;
+    }
+}
+
+/// internal copy of up to size bytes from the current fragment onwards (returns the number of bytes copied)
+[[nodiscard]] uint32_t gatherFragments(const text_fragments& list, uint8_t* const data, const uint32_t size) noexcept
+{
+    uint32_t gathered = 0;
+    for (uint32_t index = list.index; (index < list.count) && (gathered < size); ++index)
+    {
+        const utf_text& fragment = list.fragments[index];
+        if (fragment.offset >= fragment.length)
+        {   //  exhausted (including empty fragments with a null buffer)
+            continue;
+        }
+        const uint32_t available = (fragment.length - fragment.offset);
+        const uint32_t bytes = (((size - gathered) < available) ? (size - gathered) : available);
+        memcpy(&data[gathered], &fragment.buffer[fragment.offset], bytes);
+        gathered += bytes;
+    }
+    return gathered;
+}
+
+/// internal advance of the fragment offsets by bytes
+void advanceFragments(text_fragments& list, uint32_t bytes) noexcept
+{
+    while ((bytes != 0) && (list.index < list.count))
+    {
+        utf_text& fragment = list.fragments[list.index];
+        if (fragment.offset >= fragment.length)
+        {
+            ++list.index;
+            continue;
+        }
+        const uint32_t available = (fragment.length - fragment.offset);
+        const uint32_t step = ((bytes < available) ? bytes : available);
+        fragment.offset += step;
+        bytes -= step;
+        if (bytes != 0)
+        {
+            ++list.index;
+        }
+    }
+}
+
+/// internal free space of the fragments from the current fragment onwards (counted up to limit)
+[[nodiscard]] uint32_t getFragmentSpace(const text_fragments& list, const uint32_t limit) noexcept
+{
+    uint32_t space = 0;
+    for (uint32_t index = list.index; (index < list.count) && (space < limit); ++index)
+    {
+        if (list.fragments[index].offset < list.fragments[index].length)
+        {
+            space += (list.fragments[index].length - list.fragments[index].offset);
+        }
+    }
+    return ((space < limit) ? space : limit);
+}
+
+/// internal copy of size bytes to the fragments from the current fragment onwards (the space must be available)
+void scatterFragments(text_fragments& list, const uint8_t* const data, const uint32_t size) noexcept
+{
+    for (uint32_t written = 0; written < size;)
+    {
+        skipFragments(list);
+        utf_text& fragment = list.fragments[list.index];
+        const uint32_t available = (fragment.length - fragment.offset);
+        const uint32_t bytes = (((size - written) < available) ? (size - written) : available);
+        memcpy(&fragment.buffer[fragment.offset], &data[written], bytes);
+        fragment.offset += bytes;
+        written += bytes;
+    }
+}
+
+/// internal zero offset view of the whole code-units of the current fragment
+///
+///     If another fragment follows, the trailing code-points which may decode differently when followed by more data
+///     (truncated sequences, high surrogates which may pair with the next code-point and, when use_nlf is true, CRs
+///     and LFs which may pair with a LF or CR) are excluded from the view and left for the bridge.
+///
+[[nodiscard]] utf_text getFragmentView(const IUTFTK& handler, const text_fragments& list, const bool use_nlf) noexcept
+{
+    const utf_text& fragment = list.fragments[list.index];
+    utf_text view = { ((fragment.length - fragment.offset) & ~(handler.unitSize() - 1)), 0, &fragment.buffer[fragment.offset] };
+    if ((list.index + 1) < list.count)
+    {   //  a longer run of such code-points is bridged one code-point at a time
+        for (uint32_t excluded = 0;; ++excluded)
+        {
+            utf_text last = { view.length, view.length, view.buffer };
+            if (excluded == kFragmentExclusions)
+            {
+                view.length = 0;
+                break;
+            }
+            if (handler.back(last, 1) == 0)
+            {
+                break;
+            }
+            unicode_t unicode = 0;
+            uint32_t bytes = 0;
+            if (handler.get(last, unicode, bytes).no_error() && !isHighSurrogate(unicode) && !(use_nlf && ((unicode == 0x000au) || (unicode == 0x000du))))
+            {
+                break;
+            }
+            view.length = last.offset;
+        }
+    }
+    return view;
+}
+
+/// internal decode of the code-point at the current fragment position (which may span fragments)
+[[nodiscard]] cp_errors bridgeDecode(const IUTFTK& handler, const text_fragments& list, const bool use_nlf, unicode_t& unicode, uint32_t& bytes) noexcept
+{
+    uint8_t data[kFragmentBridge];
+    const utf_text gathered = { gatherFragments(list, data, sizeof(data)), 0, data };
+    unicode = 0;
+    bytes = 0;
+    return (use_nlf ? handler.getNLF(gathered, unicode, bytes) : handler.get(gathered, unicode, bytes));
+}
+
+};  //  namespace internal
+
+// ==== bulk transcoding functions ====
+
+[[nodiscard]] toolkit::cp_errors transcode(const toolkit::IUTFTK& from, utf_text& src, const toolkit::IUTFTK& to, utf_text& dst, const bool use_nlf, const StoreMode store) noexcept
+{
+    uint32_t repairs = 0;
+    return internal::transcodeText(from, src, to, dst, repairs, false, use_nlf, store);
+}
+
+[[nodiscard]] toolkit::cp_errors repair(const toolkit::IUTFTK& from, utf_text& src, const toolkit::IUTFTK& to, utf_text& dst, uint32_t& repairs, const bool use_nlf, const StoreMode store) noexcept
+{
+    return internal::transcodeText(from, src, to, dst, repairs, true, use_nlf, store);
+}
+
+[[nodiscard]] toolkit::cp_errors readCodePoints(const toolkit::IUTFTK& handler, utf_text& src, unicode_t* const dst, const uint32_t capacity, uint32_t& count) noexcept
+{
+    count = 0;
+    toolkit::cp_errors errors = toolkit::get_errors(src, (handler.unitSize() - 1));
+    if ((dst == nullptr) && capacity)
+    {
+        errors |= (toolkit::cp_errors::bits::Failed | toolkit::cp_errors::bits::InvalidBuffer);
+    }
+    if (errors.no_error())
+    {
+        const toolkit::UTF_SUB_TYPE utfSubType = handler.utfSubType();
+        const bool wide = internal::isWide16(utfSubType);
+        const internal::wide_kernel kernel = { internal::isWideLE(utfSubType), internal::isHostLE(), (utfSubType <= toolkit::UTF_SUB_TYPE::UTF16be), false };
+        const toolkit::custom_kernels* const kernels = toolkit::getCustomKernels(handler);
+        const bool custom = ((kernels != nullptr) && (kernels->decode != nullptr));
+        while (src.offset < src.length)
+        {
+            if (custom)
+            {
+                uint32_t decoded = 0;
+                const uint32_t run = kernels->decode(&src.buffer[src.offset], (src.length - src.offset), &dst[count], (capacity - count), decoded);
+                if (run)
+                {
+                    src.offset += run;
+                    count += decoded;
+                    continue;
+                }
+            }
+            else if (wide)
+            {
+                const uint32_t space = (((capacity - count) < 0x3fffffffu) ? (capacity - count) : 0x3fffffffu);
+                uint32_t written = 0;
+                const uint32_t run = internal::widenUTF16(&src.buffer[src.offset], (src.length - src.offset), reinterpret_cast<uint8_t*>(&dst[count]), (space << 2), written, kernel, false, errors);
+                if (run)
+                {
+                    src.offset += run;
+                    count += (written >> 2);
+                    continue;
+                }
+            }
+            if (count == capacity)
+            {
+                errors |= (toolkit::cp_errors::bits::Failed | toolkit::cp_errors::bits::WriteOverflow);
+                break;
+            }
+            unicode_t unicode = 0;
+            uint32_t bytes = 0;
+            const toolkit::cp_errors check = handler.get(src, unicode, bytes);
+            errors |= check;
+            if (check.error())
+            {
+                break;
+            }
+            dst[count++] = unicode;
+            src.offset += bytes;
+        }
+    }
+    return errors;
+}
+
+[[nodiscard]] toolkit::cp_errors writeCodePoints(const toolkit::IUTFTK& handler, const unicode_t* const src, const uint32_t count, uint32_t& consumed, utf_text& dst) noexcept
+{
+    consumed = 0;
+    toolkit::cp_errors errors = toolkit::get_errors(dst, (handler.unitSize() - 1));
+    if ((src == nullptr) && count)
+    {
+        errors |= (toolkit::cp_errors::bits::Failed | toolkit::cp_errors::bits::InvalidBuffer);
+    }
+    if (errors.no_error())
+    {
+        const toolkit::UTF_SUB_TYPE utfSubType = handler.utfSubType();
+        const bool wide = internal::isWide16(utfSubType);
+        const internal::wide_kernel kernel = { internal::isHostLE(), internal::isWideLE(utfSubType), (utfSubType <= toolkit::UTF_SUB_TYPE::UTF16be), false };
+        const toolkit::custom_kernels* const kernels = toolkit::getCustomKernels(handler);
+        const bool custom = ((kernels != nullptr) && (kernels->encode != nullptr));
+        while (consumed < count)
+        {
+            if (custom)
+            {
+                uint32_t written = 0;
+                const uint32_t run = kernels->encode(&src[consumed], (count - consumed), &dst.buffer[dst.offset], (dst.length - dst.offset), written);
+                if (run)
+                {
+                    consumed += run;
+                    dst.offset += written;
+                    continue;
+                }
+            }
+            else if (wide)
+            {
+                const uint32_t remaining = (((count - consumed) < 0x3fffffffu) ? (count - consumed) : 0x3fffffffu);
+                uint32_t written = 0;
+                const uint32_t run = internal::narrowUTF32(reinterpret_cast<const uint8_t*>(&src[consumed]), (remaining << 2), &dst.buffer[dst.offset], (dst.length - dst.offset), written, kernel, errors);
+                if (run)
+                {
+                    consumed += (run >> 2);
+                    dst.offset += written;
+                    continue;
+                }
+            }
+            uint32_t written = 0;
+            const toolkit::cp_errors status = handler.set(dst, src[consumed], written);
+            errors |= status;
+            if (status.error())
+            {
+                break;
+            }
+            dst.offset += written;
+            ++consumed;
+        }
+    }
+    return errors;
+}
+
+[[nodiscard]] toolkit::cp_errors decodePermissive(const toolkit::IUTFTK& handler, utf_text& src, unicode_t* const dst, uint32_t* const offsets, const uint32_t capacity, uint32_t& count, uint32_t& failures) noexcept
+{
+    count = 0;
+    failures = 0;
+    toolkit::cp_errors errors = toolkit::get_errors(src, (handler.unitSize() - 1));
+    if ((dst == nullptr) && capacity)
+    {
+        errors |= (toolkit::cp_errors::bits::Failed | toolkit::cp_errors::bits::InvalidBuffer);
+    }
+    if (errors.no_error())
+    {
+        const bool utf8 = (static_cast<uint32_t>(handler.utfSubType()) <= static_cast<uint32_t>(toolkit::UTF_SUB_TYPE::JCESU8st));
+        const internal::utf8_family family = internal::getUTF8Family(handler.utfSubType());
+        uint32_t blocks = src.offset;   //  offset at which to resume the block scan (backs off after short block runs)
+        while (src.offset < src.length)
+        {
+            if (utf8 && (src.offset >= blocks))
+            {   //  decode clean blocks directly (limited so that every code-point of the run fits in dst)
+                const uint32_t remaining = (src.length - src.offset);
+                const uint32_t space = (capacity - count);
+                const uint32_t run = internal::scanBlocksUTF8(&src.buffer[src.offset], ((remaining < space) ? remaining : space), family, errors);
+                if (run < internal::kShortBlockRun)
+                {
+                    blocks = (src.offset + run + internal::kBlockBackoff);
+                }
+                if (run)
+                {
+                    count += internal::decodeBlocksUTF8(&src.buffer[src.offset], run, &dst[count], ((offsets != nullptr) ? &offsets[count] : offsets), src.offset);
+                    src.offset += run;
+                    continue;
+                }
+            }
+            if (count == capacity)
+            {
+                errors |= (toolkit::cp_errors::bits::Failed | toolkit::cp_errors::bits::WriteOverflow);
+                break;
+            }
+            unicode_t unicode = 0;
+            uint32_t bytes = 0;
+            toolkit::cp_errors check = handler.get(src, unicode, bytes);
+            if (check.any(toolkit::cp_errors::bits::ReadTruncated))
+            {   //  never skipped: more data may follow
+                errors |= check;
+                break;
+            }
+            if (check.error())
+            {
+                check = check.warnings_only();
+                ++failures;
+            }
+            errors |= check;
+            dst[count] = unicode;
+            if (offsets != nullptr)
+            {
+                offsets[count] = src.offset;
+            }
+            ++count;
+            src.offset += bytes;
+        }
+    }
+    return errors;
+}
+
+[[nodiscard]] uint64_t encodedSize(const toolkit::IUTFTK& handler, const unicode_t* const src, const uint32_t count, uint32_t& unencodable, uint8_t* const mask) noexcept
+{
+    unencodable = 0;
+    if ((src == nullptr) || (count == 0))
+    {
+        return 0;
+    }
+    if (mask != nullptr)
+    {
+        memset(mask, 0, ((static_cast<size_t>(count) + 7) >> 3));
+    }
+    internal::length_steps table;
+    if (internal::getLengthSteps(handler.utfSubType(), table))
+    {
+        return internal::sumStepLengths(table, src, count, unencodable, mask);
+    }
+    uint64_t size = 0;
+    for (uint32_t index = 0; index < count; ++index)
+    {
+        const uint32_t bytes = handler.len(src[index]);
+        if (bytes == 0)
+        {
+            ++unencodable;
+            if (mask != nullptr)
+            {
+                mask[index >> 3] |= static_cast<uint8_t>(1u << (index & 7));
+            }
+        }
+        size += bytes;
+    }
+    return size;
+}
+
+// ==== compact storage functions ====
+
+[[nodiscard]] toolkit::cp_errors measureCompact(const toolkit::IUTFTK& handler, const utf_text& text, uint32_t& count, uint32_t& width) noexcept
+{
+    count = 0;
+    width = 1;
+    toolkit::cp_errors errors = toolkit::get_errors(text, (handler.unitSize() - 1));
+    if (errors.no_error())
+    {
+        const toolkit::UTF_SUB_TYPE utfSubType = handler.utfSubType();
+        const bool ascii = internal::isAsciiCompatible(utfSubType);
+        const bool wide = (internal::isWide16(utfSubType) || internal::isWide32(utfSubType));
+        const bool le = internal::isWideLE(utfSubType);
+        const uint32_t unit = handler.unitSize();
+        utf_text src = text;
+        unicode_t bits = 0;
+        while (src.offset < src.length)
+        {
+            if (ascii)
+            {   //  plain ASCII never needs more than 1 byte
+                const uint32_t run = internal::scanAsciiRun(&src.buffer[src.offset], (src.length - src.offset), false);
+                if (run)
+                {
+                    src.offset += run;
+                    count += run;
+                    continue;
+                }
+            }
+            else if (wide)
+            {
+                const uint32_t run = internal::scanPlainWide(&src.buffer[src.offset], (src.length - src.offset), unit, le, bits);
+                if (run)
+                {
+                    src.offset += run;
+                    count += (run / unit);
+                    continue;
+                }
+            }
+            unicode_t unicode = 0;
+            uint32_t bytes = 0;
+            const toolkit::cp_errors check = handler.get(src, unicode, bytes);
+            errors |= check;
+            if (check.error())
+            {
+                break;
+            }
+            bits |= unicode;
+            ++count;
+            src.offset += bytes;
+        }
+        width = internal::compactWidth(bits);
+    }
+    return errors;
+}
+
+[[nodiscard]] toolkit::cp_errors makeCompact(const toolkit::IUTFTK& handler, const utf_text& text, const uint32_t width, uint8_t* const buffer, const uint32_t capacity, compact_text& compact) noexcept
+{
+    compact = { buffer, 0, width };
+    toolkit::cp_errors errors = toolkit::get_errors(text, (handler.unitSize() - 1));
+    if (!internal::isCompactWidth(width))
+    {
+        errors |= (toolkit::cp_errors::bits::Failed | toolkit::cp_errors::bits::MisalignedLength);
+    }
+    else if ((buffer == nullptr) && capacity)
+    {
+        errors |= (toolkit::cp_errors::bits::Failed | toolkit::cp_errors::bits::InvalidBuffer);
+    }
+    else if ((reinterpret_cast<uintptr_t>(buffer) & (width - 1)) != 0)
+    {
+        errors |= (toolkit::cp_errors::bits::Failed | toolkit::cp_errors::bits::MisalignedOffset);
+    }
+    if (errors.no_error())
+    {
+        const toolkit::UTF_SUB_TYPE utfSubType = handler.utfSubType();
+        const bool ascii = internal::isAsciiCompatible(utfSubType);
+        const bool wide = (internal::isWide16(utfSubType) || internal::isWide32(utfSubType));
+        const bool le = internal::isWideLE(utfSubType);
+        const uint32_t unit = handler.unitSize();
+        const uint32_t limit = (capacity / width);
+        const uint32_t maximum = ((width == 1) ? 0x000000ffu : ((width == 2) ? 0x0000ffffu : 0xffffffffu));
+        const internal::wide_kernel kernel = { le, internal::isHostLE(), (utfSubType <= toolkit::UTF_SUB_TYPE::UTF16be), false };
+        utf_text src = text;
+        while (src.offset < src.length)
+        {
+            const uint32_t space = (limit - compact.count);
+            if (ascii)
+            {
+                const uint32_t available = (src.length - src.offset);
+                const uint32_t run = internal::scanAsciiRun(&src.buffer[src.offset], ((available < space) ? available : space), false);
+                if (run)
+                {
+                    internal::widenAscii(&src.buffer[src.offset], run, &buffer[compact.count * width], width);
+                    src.offset += run;
+                    compact.count += run;
+                    continue;
+                }
+            }
+            else if (wide && (width == 4) && internal::isWide16(utfSubType))
+            {   //  the readCodePoints() kernel (including surrogate pairs)
+                uint32_t written = 0;
+                const uint32_t run = internal::widenUTF16(&src.buffer[src.offset], (src.length - src.offset), &buffer[compact.count * 4], (((space < 0x3fffffffu) ? space : 0x3fffffffu) << 2), written, kernel, false, errors);
+                if (run)
+                {
+                    src.offset += run;
+                    compact.count += (written >> 2);
+                    continue;
+                }
+            }
+            else if (wide && (width != 1))
+            {
+                const uint32_t available = (src.length - src.offset);
+                const uint32_t bytes = ((space < (available / unit)) ? (space * unit) : available);
+                unicode_t bits = 0;
+                const uint32_t run = internal::scanPlainWide(&src.buffer[src.offset], bytes, unit, le, bits);
+                if (run)
+                {
+                    internal::widenPlainWide(&src.buffer[src.offset], (run / unit), unit, le, &buffer[compact.count * width], width);
+                    src.offset += run;
+                    compact.count += (run / unit);
+                    continue;
+                }
+            }
+            if (space == 0)
+            {
+                errors |= (toolkit::cp_errors::bits::Failed | toolkit::cp_errors::bits::WriteOverflow);
+                break;
+            }
+            unicode_t unicode = 0;
+            uint32_t bytes = 0;
+            const toolkit::cp_errors check = handler.get(src, unicode, bytes);
+            errors |= check;
+            if (check.error())
+            {
+                break;
+            }
+            if (static_cast<uint32_t>(unicode) > maximum)
+            {
+                errors |= (toolkit::cp_errors::bits::Failed | toolkit::cp_errors::bits::NotEncodable | toolkit::cp_errors::bits::NotEnoughBits);
+                break;
+            }
+            if (width == 1)
+            {
+                buffer[compact.count] = static_cast<uint8_t>(unicode);
+            }
+            else if (width == 2)
+            {
+                reinterpret_cast<uint16_t*>(buffer)[compact.count] = static_cast<uint16_t>(unicode);
+            }
+            else
+            {
+                reinterpret_cast<unicode_t*>(buffer)[compact.count] = unicode;
+            }
+            ++compact.count;
+            src.offset += bytes;
+        }
+    }
+    return errors;
+}
+
+[[nodiscard]] toolkit::cp_errors writeCompact(const compact_text& compact, uint32_t& index, const toolkit::IUTFTK& handler, utf_text& dst) noexcept
+{
+    toolkit::cp_errors errors = toolkit::get_errors(dst, (handler.unitSize() - 1));
+    if (!internal::isCompactWidth(compact.width))
+    {
+        errors |= (toolkit::cp_errors::bits::Failed | toolkit::cp_errors::bits::MisalignedLength);
+    }
+    else if ((compact.buffer == nullptr) && compact.count)
+    {
+        errors |= (toolkit::cp_errors::bits::Failed | toolkit::cp_errors::bits::InvalidBuffer);
+    }
+    else if (index > compact.count)
+    {
+        errors |= (toolkit::cp_errors::bits::Failed | toolkit::cp_errors::bits::InvalidOffset);
+    }
+    if (errors.no_error())
+    {
+        if (compact.width == 4)
+        {
+            uint32_t consumed = 0;
+            errors |= writeCodePoints(handler, &reinterpret_cast<const unicode_t*>(compact.buffer)[index], (compact.count - index), consumed, dst);
+            index += consumed;
+            return errors;
+        }
+        const bool ascii = internal::isAsciiCompatible(handler.utfSubType());
+        while (index < compact.count)
+        {
+            if (ascii)
+            {
+                const uint32_t space = (dst.length - dst.offset);
+                const uint32_t remaining = (compact.count - index);
+                const uint32_t run = internal::narrowAscii(compact, index, ((remaining < space) ? remaining : space), &dst.buffer[dst.offset]);
+                if (run)
+                {
+                    index += run;
+                    dst.offset += run;
+                    continue;
+                }
+            }
+            uint32_t written = 0;
+            const toolkit::cp_errors status = handler.set(dst, compactAt(compact, index), written);
+            errors |= status;
+            if (status.error())
+            {
+                break;
+            }
+            dst.offset += written;
+            ++index;
+        }
+    }
+    return errors;
+}
+
+// ==== bulk validation functions ====
+
+[[nodiscard]] toolkit::cp_errors validate(const toolkit::IUTFTK& handler, utf_text& text, const toolkit::cp_errors diagnostics) noexcept
+{
+    toolkit::cp_errors errors = toolkit::get_errors(text, handler.unitSize() - 1);
+    if (errors.no_error())
+    {
+        const bool ascii = internal::isAsciiCompatible(handler.utfSubType());
+        const bool utf8 = (static_cast<uint32_t>(handler.utfSubType()) <= static_cast<uint32_t>(toolkit::UTF_SUB_TYPE::JCESU8st));
+        const internal::utf8_family family = internal::getUTF8Family(handler.utfSubType());
+        const toolkit::custom_kernels* const kernels = toolkit::getCustomKernels(handler);
+        const bool custom = ((kernels != nullptr) && (kernels->validate != nullptr));
+        uint32_t blocks = text.offset;  //  offset at which to resume the block scan (backs off after short block runs)
+        while (text.offset < text.length)
+        {
+            if (custom)
+            {   //  skip runs which the custom sub-type kernel has validated
+                const uint32_t run = kernels->validate(&text.buffer[text.offset], (text.length - text.offset));
+                if (run)
+                {
+                    text.offset += run;
+                    continue;
+                }
+            }
+            if (ascii)
+            {   //  skip runs of plain ASCII (these bytes are always valid single byte code-points without warnings)
+                const uint32_t run = internal::scanAsciiRun(&text.buffer[text.offset], (text.length - text.offset), false);
+                if (run)
+                {
+                    text.offset += run;
+                    continue;
+                }
+            }
+            if (utf8)
+            {   //  skip blocks of mixed text and then runs of well-formed multi-byte sequences
+                uint32_t run = 0;
+                if (text.offset >= blocks)
+                {
+                    run = internal::scanBlocksUTF8(&text.buffer[text.offset], (text.length - text.offset), family, errors);
+                    if (run < internal::kShortBlockRun)
+                    {   //  text which is dense with sequences the block scan cannot take is left to the scalar scan for a while
+                        blocks = (text.offset + run + internal::kBlockBackoff);
+                    }
+                }
+                if (run == 0)
+                {
+                    run = internal::scanWellFormedUTF8(&text.buffer[text.offset], (text.length - text.offset), diagnostics, errors);
+                }
+                if (run)
+                {
+                    text.offset += run;
+                    continue;
+                }
+            }
+            unicode_t unicode = 0;
+            uint32_t bytes = 0;
+            const toolkit::cp_errors check = handler.get(text, unicode, bytes, diagnostics);
+            errors |= check;
+            if (check.error())
+            {
+                break;
+            }
+            text.offset += bytes;
+        }
+    }
+    return (errors ^ (errors.warnings_only() & ~diagnostics));
+}
+
+// ==== scatter/gather functions ====
+
+[[nodiscard]] toolkit::cp_errors transcode(const toolkit::IUTFTK& from, text_fragments& src, const toolkit::IUTFTK& to, text_fragments& dst, const bool use_nlf, const StoreMode store) noexcept
+{
+    toolkit::cp_errors errors = (internal::getFragmentErrors(src) | internal::getFragmentErrors(dst));
+    while (errors.no_error())
+    {
+        internal::skipFragments(src);
+        internal::skipFragments(dst);
+        if (src.index == src.count)
+        {
+            break;
+        }
+        utf_text view = internal::getFragmentView(from, src, use_nlf);
+        if ((view.length != 0) && (dst.index < dst.count))
+        {
+            utf_text& output = dst.fragments[dst.index];
+            utf_text target = { ((output.length - output.offset) & ~(to.unitSize() - 1)), 0, &output.buffer[output.offset] };
+            const toolkit::cp_errors check = transcode(from, view, to, target, use_nlf, store);
+            src.fragments[src.index].offset += view.offset;
+            output.offset += target.offset;
+            errors |= check.warnings_only();
+            if (check.no_error())
+            {
+                continue;
+            }
+        }
+        //  the code-point at which the fragment transcode stopped is decoded from the gathered fragments
+        unicode_t unicode = 0;
+        uint32_t bytes = 0;
+        const toolkit::cp_errors check = internal::bridgeDecode(from, src, use_nlf, unicode, bytes);
+        if (check.error())
+        {
+            errors |= check;
+            break;
+        }
+        //  the code-point is encoded to a temporary buffer limited to the free space of the destination fragments
+        uint8_t data[internal::kFragmentBridge];
+        utf_text encoded = { (internal::getFragmentSpace(dst, sizeof(data)) & ~(to.unitSize() - 1)), 0, data };
+        uint32_t size = 0;
+        const toolkit::cp_errors status = to.set(encoded, unicode, size);
+        if (status.error())
+        {
+            errors |= status;
+            break;
+        }
+        errors |= (check | status);
+        internal::scatterFragments(dst, data, size);
+        internal::advanceFragments(src, bytes);
+    }
+    return errors;
+}
+
+[[nodiscard]] toolkit::cp_errors readCodePoints(const toolkit::IUTFTK& handler, text_fragments& src, unicode_t* const dst, const uint32_t capacity, uint32_t& count) noexcept
+{
+    count = 0;
+    toolkit::cp_errors errors = internal::getFragmentErrors(src);
+    if ((dst == nullptr) && capacity)
+    {
+        errors |= (toolkit::cp_errors::bits::Failed | toolkit::cp_errors::bits::InvalidBuffer);
+    }
+    while (errors.no_error())
+    {
+        internal::skipFragments(src);
+        if (src.index == src.count)
+        {
+            break;
+        }
+        utf_text view = internal::getFragmentView(handler, src, false);
+        if (view.length != 0)
+        {
+            uint32_t stored = 0;
+            const toolkit::cp_errors check = readCodePoints(handler, view, ((dst != nullptr) ? &dst[count] : dst), (capacity - count), stored);
+            src.fragments[src.index].offset += view.offset;
+            count += stored;
+            errors |= check.warnings_only();
+            if (check.no_error())
+            {
+                continue;
+            }
+        }
+        if (count == capacity)
+        {
+            errors |= (toolkit::cp_errors::bits::Failed | toolkit::cp_errors::bits::WriteOverflow);
+            break;
+        }
+        unicode_t unicode = 0;
+        uint32_t bytes = 0;
+        const toolkit::cp_errors check = internal::bridgeDecode(handler, src, false, unicode, bytes);
+        errors |= check;
+        if (check.no_error())
+        {
+            dst[count++] = unicode;
+            internal::advanceFragments(src, bytes);
+        }
+    }
+    return errors;
+}
+
+[[nodiscard]] toolkit::cp_errors validate(const toolkit::IUTFTK& handler, text_fragments& text, const toolkit::cp_errors diagnostics) noexcept
+{
+    toolkit::cp_errors errors = internal::getFragmentErrors(text);
+    while (errors.no_error())
+    {
+        internal::skipFragments(text);
+        if (text.index == text.count)
+        {
+            break;
+        }
+        utf_text view = internal::getFragmentView(handler, text, false);
+        if (view.length != 0)
+        {
+            const toolkit::cp_errors check = validate(handler, view, diagnostics);
+            text.fragments[text.index].offset += view.offset;
+            errors |= check.warnings_only();
+            if (check.no_error())
+            {
+                continue;
+            }
+        }
+        unicode_t unicode = 0;
+        uint32_t bytes = 0;
+        const toolkit::cp_errors check = internal::bridgeDecode(handler, text, false, unicode, bytes);
+        errors |= check;
+        if (check.no_error())
+        {
+            internal::advanceFragments(text, bytes);
+        }
+    }
+    return (errors ^ (errors.warnings_only() & ~diagnostics));
+}
+
+// ==== incremental validation functions ====
+
+[[nodiscard]] toolkit::cp_errors validateBlocks(const toolkit::IUTFTK& handler, const utf_text& text, validation_state& state) noexcept
+{
+    const toolkit::cp_errors errors = internal::prepareBlocks(handler, text, state);
+    if (errors.error())
+    {
+        return errors;
+    }
+    if (state.count != 0)
+    {
+        state.blocks[0].start = 0;
+        internal::decodeBlocks(handler, &text.buffer[text.offset], state.length, state, 0, false, 0);
+    }
+    return internal::accumulateBlocks(state);
+}
+
+[[nodiscard]] toolkit::cp_errors revalidateRange(const toolkit::IUTFTK& handler, const utf_text& text, const uint32_t editStart, const uint32_t editEnd, validation_state& state) noexcept
+{
+    const uint32_t count = state.count;
+    const uint32_t length = state.length;
+    if ((count == 0) || (editStart > editEnd) || (editStart > length) || (editStart > (text.length - text.offset)))
+    {   //  no usable recorded boundary before the edit
+        return validateBlocks(handler, text, state);
+    }
+    const toolkit::cp_errors errors = internal::prepareBlocks(handler, text, state);
+    if (errors.error() || (state.count == 0))
+    {
+        return (errors.error() ? errors : internal::accumulateBlocks(state));
+    }
+    const uint32_t last = (((count < state.count) ? count : state.count) - 1);
+    uint32_t first = (((editStart >> state.shift) < last) ? (editStart >> state.shift) : last);
+    while ((first > 0) && ((static_cast<uint64_t>(state.blocks[first].start) + internal::kValidationLookahead) > editStart))
+    {   //  restart from a boundary which no earlier code-point can have read beyond
+        --first;
+    }
+    internal::decodeBlocks(handler, &text.buffer[text.offset], state.length, state, first, (state.length == length), editEnd);
+    return internal::accumulateBlocks(state);
+}
+
+// ==== position tracking reader ====
+
+[[nodiscard]] toolkit::cp_errors tracking_reader::read(unicode_t& unicode) noexcept
+{
+    uint32_t bytes = 0;
+    const toolkit::cp_errors errors = tk->getNLF(source, unicode, bytes);
+    if (bytes != 0)
+    {
+        internal::trackPosition(pos, (errors.error() ? 0xfffd : unicode));
+    }
+    source.offset += bytes;
+    pos.offset = source.offset;
+    return errors;
+}
+
+[[nodiscard]] toolkit::cp_errors tracking_reader::advance(const uint32_t offset) noexcept
+{
+    toolkit::cp_errors errors = toolkit::get_errors(source);
+    if (errors.no_error())
+    {
+        const uint32_t limit = ((offset < source.length) ? offset : source.length);
+        const bool ascii = internal::isAsciiCompatible(tk->utfSubType());
+        while (source.offset < limit)
+        {
+            if (ascii && (source.buffer[source.offset] < 0x80u))
+            {
+                const uint32_t count = internal::trackAsciiWords(pos, &source.buffer[source.offset], (limit - source.offset), (source.length - source.offset));
+                if (count)
+                {
+                    source.offset += count;
+                    continue;
+                }
+            }
+            unicode_t unicode = 0;
+            uint32_t bytes = 0;
+            const toolkit::cp_errors check = tk->getNLF(source, unicode, bytes);
+            errors |= check;
+            if (check.error())
+            {
+                break;
+            }
+            internal::trackPosition(pos, unicode);
+            source.offset += bytes;
+        }
+        pos.offset = source.offset;
+    }
+    return errors;
+}
+
+// ==== record splitting functions ====
+
+[[nodiscard]] toolkit::cp_errors getRecord(const toolkit::IUTFTK& handler, const utf_text& text, const record_format& format, record_field* const fields, const uint32_t capacity, uint32_t& count, uint32_t& bytes) noexcept
+{
+    count = 0;
+    bytes = 0;
+    toolkit::cp_errors errors = toolkit::get_errors(text, handler.unitSize() - 1);
+    if (errors.no_error())
+    {
+        uint8_t* const buffer = &text.buffer[text.offset];
+        const uint32_t length = (text.length - text.offset);
+        if (length == 0)
+        {
+            errors |= toolkit::cp_errors::bits::ReadExhausted;
+            return errors;
+        }
+        const bool blocks = ((handler.unitSize() == 1) && internal::isAsciiCompatible(handler.utfSubType()) &&
+                             (static_cast<uint32_t>(format.delimiter - 1) < 0x7fu) && (static_cast<uint32_t>(format.quote) < 0x80u) &&
+                             (format.delimiter != format.quote) && (static_cast<uint32_t>(format.delimiter - 0x0a) >= 4) && (static_cast<uint32_t>(format.quote - 0x0a) >= 4));
+        if (!blocks || !internal::scanRecordBlocks(handler, buffer, length, format, fields, capacity, count, bytes, errors))
+        {
+            count = 0;
+            bytes = 0;
+            errors = internal::scanRecord(handler, buffer, length, format, fields, capacity, count, bytes);
+        }
+        if (errors.error() || (count > capacity))
+        {
+            if (errors.no_error())
+            {
+                errors |= (toolkit::cp_errors::bits::Failed | toolkit::cp_errors::bits::WriteOverflow);
+            }
+            else
+            {
+                count = 0;
+            }
+            bytes = 0;
+        }
+    }
+    return errors;
+}
+
+[[nodiscard]] toolkit::cp_errors readRecord(const toolkit::IUTFTK& handler, utf_text& text, const record_format& format, record_field* const fields, const uint32_t capacity, uint32_t& count) noexcept
+{
+    uint32_t bytes = 0;
+    toolkit::cp_errors errors = getRecord(handler, text, format, fields, capacity, count, bytes);
+    text.offset += bytes;
+    return errors;
+}
+
+[[nodiscard]] toolkit::cp_errors unquoteField(const toolkit::IUTFTK& handler, const record_field& field, const unicode_t quote, utf_text& dst) noexcept
+{
+    utf_text scan = field.text;
+    toolkit::cp_errors errors = (toolkit::get_errors(scan, handler.unitSize() - 1) | toolkit::get_errors(dst, handler.unitSize() - 1));
+    bool skipped = false;
+    while (errors.no_error() && (scan.offset < scan.length))
+    {
+        unicode_t unicode = 0;
+        uint32_t bytes = 0;
+        const toolkit::cp_errors check = handler.get(scan, unicode, bytes);
+        errors |= check;
+        if (check.error())
+        {
+            break;
+        }
+        if (field.quoted && (unicode == quote) && !skipped)
+        {   //  the first quote of a doubled quote
+            skipped = true;
+        }
+        else
+        {
+            if ((dst.length - dst.offset) < bytes)
+            {
+                errors |= (toolkit::cp_errors::bits::Failed | toolkit::cp_errors::bits::WriteOverflow);
+                break;
+            }
+            memcpy(&dst.buffer[dst.offset], &scan.buffer[scan.offset], bytes);
+            dst.offset += bytes;
+            skipped = false;
+        }
+        scan.offset += bytes;
+    }
+    return errors;
+}
+
+// ==== white space functions ====
+
+[[nodiscard]] toolkit::cp_errors getToken(const toolkit::IUTFTK& handler, const utf_text& text, utf_text& token, uint32_t& bytes) noexcept
+{
+    bytes = 0;
+    token.length = 0;
+    token.offset = 0;
+    token.buffer = nullptr;
+    toolkit::cp_errors errors = toolkit::get_errors(text, handler.unitSize() - 1);
+    if (errors.no_error())
+    {
+        const internal::WhiteScan scan = internal::getWhiteScan(handler);
+        uint8_t* const buffer = &text.buffer[text.offset];
+        const uint32_t length = (text.length - text.offset);
+        const uint32_t start = internal::findWhite(handler, scan, buffer, 0, length, false);
+        if (start == length)
+        {   //  only white space remains
+            bytes = length;
+            errors |= toolkit::cp_errors::bits::ReadExhausted;
+        }
+        else
+        {
+            bytes = internal::findWhite(handler, scan, buffer, start, length, true);
+            token = { (bytes - start), 0, &buffer[start] };
+        }
+    }
+    return errors;
+}
+
+[[nodiscard]] toolkit::cp_errors readToken(const toolkit::IUTFTK& handler, utf_text& text, utf_text& token) noexcept
+{
+    uint32_t bytes = 0;
+    toolkit::cp_errors errors = getToken(handler, text, token, bytes);
+    text.offset += bytes;
+    return errors;
+}
+
+[[nodiscard]] toolkit::cp_errors splitOnWhite(const toolkit::IUTFTK& handler, const utf_text& text, utf_text* const tokens, const uint32_t capacity, uint32_t& count) noexcept
+{
+    count = 0;
+    toolkit::cp_errors errors = toolkit::get_errors(text, handler.unitSize() - 1);
+    if (errors.no_error())
+    {
+        const internal::WhiteScan scan = internal::getWhiteScan(handler);
+        uint8_t* const buffer = &text.buffer[text.offset];
+        const uint32_t length = (text.length - text.offset);
+        uint32_t start = internal::findWhite(handler, scan, buffer, 0, length, false);
+        while (start < length)
+        {
+            const uint32_t end = internal::findWhite(handler, scan, buffer, start, length, true);
+            if (count < capacity)
+            {
+                tokens[count] = { (end - start), 0, &buffer[start] };
+            }
+            ++count;
+            start = internal::findWhite(handler, scan, buffer, end, length, false);
+        }
+        if (count > capacity)
+        {
+            errors |= (toolkit::cp_errors::bits::Failed | toolkit::cp_errors::bits::WriteOverflow);
+        }
+    }
+    return errors;
+}
+
+[[nodiscard]] toolkit::cp_errors trim(const toolkit::IUTFTK& handler, const utf_text& text, utf_text& trimmed) noexcept
+{
+    trimmed.length = 0;
+    trimmed.offset = 0;
+    trimmed.buffer = nullptr;
+    toolkit::cp_errors errors = toolkit::get_errors(text, handler.unitSize() - 1);
+    if (errors.no_error())
+    {
+        const internal::WhiteScan scan = internal::getWhiteScan(handler);
+        uint8_t* const buffer = &text.buffer[text.offset];
+        const uint32_t length = (text.length - text.offset);
+        const uint32_t start = internal::findWhite(handler, scan, buffer, 0, length, false);
+        const uint32_t end = internal::findTextEnd(handler, scan, buffer, start, length);
+        trimmed = { (end - start), 0, &buffer[start] };
+    }
+    return errors;
+}
+
+[[nodiscard]] toolkit::cp_errors trimStart(const toolkit::IUTFTK& handler, const utf_text& text, utf_text& trimmed) noexcept
+{
+    trimmed.length = 0;
+    trimmed.offset = 0;
+    trimmed.buffer = nullptr;
+    toolkit::cp_errors errors = toolkit::get_errors(text, handler.unitSize() - 1);
+    if (errors.no_error())
+    {
+        uint8_t* const buffer = &text.buffer[text.offset];
+        const uint32_t length = (text.length - text.offset);
+        const uint32_t start = internal::findWhite(handler, internal::getWhiteScan(handler), buffer, 0, length, false);
+        trimmed = { (length - start), 0, &buffer[start] };
+    }
+    return errors;
+}
+
+[[nodiscard]] toolkit::cp_errors trimEnd(const toolkit::IUTFTK& handler, const utf_text& text, utf_text& trimmed) noexcept
+{
+    trimmed.length = 0;
+    trimmed.offset = 0;
+    trimmed.buffer = nullptr;
+    toolkit::cp_errors errors = toolkit::get_errors(text, handler.unitSize() - 1);
+    if (errors.no_error())
+    {
+        uint8_t* const buffer = &text.buffer[text.offset];
+        const uint32_t length = (text.length - text.offset);
+        const uint32_t end = internal::findTextEnd(handler, internal::getWhiteScan(handler), buffer, 0, length);
+        trimmed = { end, 0, buffer };
+    }
+    return errors;
+}
+
+[[nodiscard]] toolkit::cp_errors collapseWhite(const toolkit::IUTFTK& handler, utf_text& src, utf_text& dst) noexcept
+{
+    toolkit::cp_errors errors = (toolkit::get_errors(src, handler.unitSize() - 1) | toolkit::get_errors(dst, handler.unitSize() - 1));
+    uint8_t space[4];
+    utf_text encoded = { sizeof(space), 0, space };
+    uint32_t spaceSize = 0;
+    if (errors.no_error() && handler.set(encoded, 0x0020u, spaceSize).no_error())
+    {
+        const internal::WhiteScan scan = internal::getWhiteScan(handler);
+        while (src.offset < src.length)
+        {
+            const uint32_t stop = internal::findWhite(handler, scan, src.buffer, src.offset, src.length, true);
+            uint32_t size = (stop - src.offset);
+            const uint32_t available = (dst.length - dst.offset);
+            if (size > available)
+            {   //  copy the whole code-points which fit
+                size = 0;
+                for (;;)
+                {
+                    uint32_t next = 0;
+                    (void)internal::decodeWhite(handler, src.buffer, (src.offset + size), src.length, next);
+                    if ((size + next) > available)
+                    {
+                        break;
+                    }
+                    size += next;
+                }
+                errors |= (toolkit::cp_errors::bits::Failed | toolkit::cp_errors::bits::WriteOverflow);
+            }
+            memcpy(&dst.buffer[dst.offset], &src.buffer[src.offset], size);
+            dst.offset += size;
+            src.offset += size;
+            if (errors.error() || (src.offset == src.length))
+            {
+                break;
+            }
+            if ((dst.length - dst.offset) < spaceSize)
+            {
+                errors |= (toolkit::cp_errors::bits::Failed | toolkit::cp_errors::bits::WriteOverflow);
+                break;
+            }
+            memcpy(&dst.buffer[dst.offset], space, spaceSize);
+            dst.offset += spaceSize;
+            src.offset = internal::findWhite(handler, scan, src.buffer, src.offset, src.length, false);
+        }
+    }
+    return errors;
+}
+
+// ==== log sanitizing functions ====
+
+[[nodiscard]] toolkit::cp_errors sanitizeForLog(const toolkit::IUTFTK& handler, utf_text& src, utf_text& dst, const LogPolicy policy) noexcept
+{
+    toolkit::cp_errors errors = (toolkit::get_errors(src, handler.unitSize() - 1) | toolkit::get_errors(dst, handler.unitSize() - 1));
+    uint8_t replacement[4];
+    utf_text encoded = { sizeof(replacement), 0, replacement };
+    uint32_t replacementSize = 0;
+    if (errors.no_error() && handler.set(encoded, 0xfffdu, replacementSize).error())
+    {   //  the sub-types which cannot encode U+FFFD use '?'
+        encoded.offset = 0;
+        (void)handler.set(encoded, 0x003fu, replacementSize);
+    }
+    const internal::LogScan scan = internal::getLogScan(handler);
+    while (errors.no_error() && (src.offset < src.length))
+    {
+        const uint32_t available = (dst.length - dst.offset);
+        const uint32_t limit = (((src.length - src.offset) < available) ? src.length : (src.offset + available));
+        const uint32_t stop = internal::findLogHit(handler, scan, src.buffer, src.offset, limit, src.length);
+        const uint32_t size = (stop - src.offset);
+        memcpy(&dst.buffer[dst.offset], &src.buffer[src.offset], size);
+        dst.offset += size;
+        src.offset = stop;
+        if (src.offset == src.length)
+        {
+            break;
+        }
+        unicode_t unicode = 0;
+        uint32_t bytes = 0;
+        const internal::LogHit hit = internal::classifyForLog(handler, src.buffer, src.offset, src.length, unicode, bytes);
+        bool written = true;
+        if (hit == internal::LogHit::Clean)
+        {   //  a clean code-point which did not fit
+            written = false;
+        }
+        else if (policy == LogPolicy::Escape)
+        {
+            written = internal::writeLogEscape(handler, hit, unicode, &src.buffer[src.offset], bytes, dst);
+        }
+        else if (policy == LogPolicy::Replace)
+        {
+            written = (replacementSize <= (dst.length - dst.offset));
+            if (written)
+            {
+                memcpy(&dst.buffer[dst.offset], replacement, replacementSize);
+                dst.offset += replacementSize;
+            }
+        }
+        if (!written)
+        {
+            errors |= (toolkit::cp_errors::bits::Failed | toolkit::cp_errors::bits::WriteOverflow);
+            break;
+        }
+        src.offset += bytes;
+    }
+    return errors;
+}
+
+// ==== bulk chunk planning functions ====
+
+[[nodiscard]] toolkit::cp_errors getChunk(const toolkit::IUTFTK& handler, const utf_text& text, utf_text& chunk, uint32_t& bytes, const uint32_t size) noexcept
+{
+    bytes = 0;
+    chunk.length = 0;
+    chunk.offset = 0;
+    chunk.buffer = nullptr;
+    const uint32_t mask = (handler.unitSize() - 1);
+    toolkit::cp_errors errors = toolkit::get_errors(text, mask);
+    if (errors.no_error())
+    {
+        const uint32_t limit = (text.length - text.offset);
+        if (limit == 0)
+        {
+            errors |= toolkit::cp_errors::bits::ReadExhausted;
+        }
+        else
+        {
+            uint8_t* const buffer = &text.buffer[text.offset];
+            uint32_t split = limit;
+            if (size < limit)
+            {   //  the boundary search begins at the first aligned offset at or after 'size' (chunks are never empty)
+                const uint32_t start = ((size > mask) ? ((size + mask) & ~mask) : (mask + 1));
+                split = internal::findBoundary(handler, buffer, start, limit);
+            }
+            chunk.length = split;
+            chunk.buffer = buffer;
+            bytes = split;
+        }
+    }
+    return errors;
+}
+
+[[nodiscard]] toolkit::cp_errors readChunk(const toolkit::IUTFTK& handler, utf_text& text, utf_text& chunk, const uint32_t size) noexcept
+{
+    uint32_t bytes = 0;
+    toolkit::cp_errors errors = getChunk(handler, text, chunk, bytes, size);
+    text.offset += bytes;
+    return errors;
+}
+
+};  //  namespace bulk
+
+};  //  namespace utf
+
+};  //  namespace unicode
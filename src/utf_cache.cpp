@@ -0,0 +1,319 @@
+
+//  SuiteUTF
+//  Original design 20102016; maintained and extended 20242025.
+//  Copyright (c) 20102025 Ritchie Brannan.
+//  MIT License. See LICENSE.txt. Project history: docs/History.md.
+//
+//  File:   utf_cache.cpp
+//  Author: Ritchie Brannan
+//  Date:   18 Oct 26
+//  
+//  Description:
+//  
+//      Bounded memo cache of transcoded strings in caller supplied memory.
+
+#include "utf_cache.h"
+#include "utf_bulk.h"
+#include "text_hash.h"
+#include <new>
+#include <string.h>
+
+namespace unicode
+{
+
+namespace utf
+{
+
+namespace cache
+{
+
+/// set header (the slots follow it)
+struct alignas(transcode_cache::kAlignment) transcode_cache::cache_set
+{
+    ::std::atomic<uint32_t>     lock;       //  insert lock
+    ::std::atomic<uint32_t>     clock;      //  use counter for the slot stamps
+    ::std::atomic<uint64_t>     hits;
+    ::std::atomic<uint64_t>     misses;
+    ::std::atomic<uint64_t>     inserts;
+    ::std::atomic<uint64_t>     evictions;
+};
+
+/// slot header (the source bytes and then the transcoded bytes follow it)
+struct transcode_cache::cache_slot
+{
+    ::std::atomic<uint32_t>     sequence;   //  odd while the slot is written
+    ::std::atomic<uint32_t>     stamp;      //  set clock value of the last use
+    ::std::atomic<uint32_t>     key;        //  sub-types and flags (0 if the slot is empty)
+    ::std::atomic<uint32_t>     hash;       //  string hash
+    ::std::atomic<uint32_t>     sourceSize; //  source bytes
+    ::std::atomic<uint32_t>     outputSize; //  transcoded bytes
+    ::std::atomic<uint32_t>     errors;     //  transcode() result
+};
+
+namespace internal
+{
+
+/// internal size of a slot header (the data is 16 byte aligned)
+constexpr uint32_t kSlotHeaderSize = 32;
+
+/// internal check of a cache layout
+inline [[nodiscard]] bool isValidLayout(const uint32_t sets, const uint32_t ways, const uint32_t slotSize) noexcept
+{
+    return ((sets != 0) && ((sets & (sets - 1)) == 0) && (ways != 0) && (ways <= transcode_cache::kMaxWays) &&
+            (slotSize > kSlotHeaderSize) && ((slotSize % transcode_cache::kAlignment) == 0));
+}
+
+/// internal key of the sub-types and flags of a transcode (never 0)
+inline [[nodiscard]] uint32_t getKey(const toolkit::IUTFTK& from, const toolkit::IUTFTK& to, const bool use_nlf) noexcept
+{
+    return ((static_cast<uint32_t>(from.utfSubType()) + 1) | (static_cast<uint32_t>(to.utfSubType()) << 8) | (use_nlf ? 0x10000u : 0));
+}
+
+/// internal set selection hash of the string hash and the key
+inline [[nodiscard]] uint32_t mixHash(const uint32_t hash, const uint32_t key) noexcept
+{
+    uint32_t mixed = (hash ^ (key * 0x9e3779b9u));
+    mixed ^= (mixed >> 16);
+    mixed *= 0x85ebca6bu;
+    mixed ^= (mixed >> 13);
+    return mixed;
+}
+
+};  //  namespace internal
+
+size_t transcode_cache::memorySize(const uint32_t sets, const uint32_t ways, const uint32_t slotSize) noexcept
+{
+    static_assert(sizeof(cache_slot) <= internal::kSlotHeaderSize, "the slot header does not fit");
+    if (!internal::isValidLayout(sets, ways, slotSize))
+    {
+        return 0;
+    }
+    return (static_cast<size_t>(sets) * (sizeof(cache_set) + (static_cast<size_t>(ways) * slotSize)));
+}
+
+uint32_t transcode_cache::slotCapacity(const uint32_t slotSize) noexcept
+{
+    return ((internal::isValidLayout(1, 1, slotSize)) ? (slotSize - internal::kSlotHeaderSize) : 0);
+}
+
+transcode_cache::transcode_cache() noexcept : m_sets(nullptr), m_setMask(0), m_ways(0), m_slotSize(0), m_setSize(0)
+{
+}
+
+[[nodiscard]] bool transcode_cache::init(void* const memory, const size_t size, const uint32_t sets, const uint32_t ways, const uint32_t slotSize) noexcept
+{
+    m_sets = nullptr;
+    const size_t required = memorySize(sets, ways, slotSize);
+    if ((memory == nullptr) || (required == 0) || (size < required) || ((reinterpret_cast<uintptr_t>(memory) % kAlignment) != 0))
+    {
+        return false;
+    }
+    uint8_t* const base = static_cast<uint8_t*>(memory);
+    m_setMask = (sets - 1);
+    m_ways = ways;
+    m_slotSize = slotSize;
+    m_setSize = static_cast<uint32_t>(sizeof(cache_set) + (static_cast<size_t>(ways) * slotSize));
+    for (uint32_t index = 0; index < sets; ++index)
+    {
+        uint8_t* const at = &base[static_cast<size_t>(index) * m_setSize];
+        cache_set* const set = new (at) cache_set;
+        set->lock.store(0, ::std::memory_order_relaxed);
+        set->clock.store(0, ::std::memory_order_relaxed);
+        set->hits.store(0, ::std::memory_order_relaxed);
+        set->misses.store(0, ::std::memory_order_relaxed);
+        set->inserts.store(0, ::std::memory_order_relaxed);
+        set->evictions.store(0, ::std::memory_order_relaxed);
+        for (uint32_t way = 0; way < ways; ++way)
+        {
+            cache_slot* const slot = new (&at[sizeof(cache_set) + (static_cast<size_t>(way) * slotSize)]) cache_slot;
+            slot->sequence.store(0, ::std::memory_order_relaxed);
+            slot->stamp.store(0, ::std::memory_order_relaxed);
+            slot->key.store(0, ::std::memory_order_relaxed);
+            slot->hash.store(0, ::std::memory_order_relaxed);
+            slot->sourceSize.store(0, ::std::memory_order_relaxed);
+            slot->outputSize.store(0, ::std::memory_order_relaxed);
+            slot->errors.store(0, ::std::memory_order_relaxed);
+        }
+    }
+    ::std::atomic_thread_fence(::std::memory_order_release);
+    m_sets = base;
+    return true;
+}
+
+transcode_cache::cache_set& transcode_cache::getSet(const uint32_t index) const noexcept
+{
+    return *reinterpret_cast<cache_set*>(&m_sets[static_cast<size_t>(index) * m_setSize]);
+}
+
+transcode_cache::cache_slot& transcode_cache::getSlot(const cache_set& set, const uint32_t way) const noexcept
+{
+    return *reinterpret_cast<cache_slot*>(&(reinterpret_cast<uint8_t*>(const_cast<cache_set*>(&set)))[sizeof(cache_set) + (static_cast<size_t>(way) * m_slotSize)]);
+}
+
+[[nodiscard]] bool transcode_cache::lookup(cache_set& set, const uint32_t hash, const uint32_t key, const utf_text& src, utf_text& dst, toolkit::cp_errors& errors) const noexcept
+{
+    const uint32_t size = (src.length - src.offset);
+    for (uint32_t way = 0; way < m_ways; ++way)
+    {
+        cache_slot& slot = getSlot(set, way);
+        const uint32_t sequence = slot.sequence.load(::std::memory_order_acquire);
+        if ((sequence & 1) || (slot.key.load(::std::memory_order_relaxed) != key) || (slot.hash.load(::std::memory_order_relaxed) != hash) || (slot.sourceSize.load(::std::memory_order_relaxed) != size))
+        {
+            continue;
+        }
+        const uint8_t* const data = &reinterpret_cast<const uint8_t*>(&slot)[internal::kSlotHeaderSize];
+        const uint32_t output = slot.outputSize.load(::std::memory_order_relaxed);
+        const uint32_t result = slot.errors.load(::std::memory_order_relaxed);
+        if (((size + output) > (m_slotSize - internal::kSlotHeaderSize)) || (output > (dst.length - dst.offset)) || (memcmp(data, &src.buffer[src.offset], size) != 0))
+        {
+            continue;
+        }
+        memcpy(&dst.buffer[dst.offset], &data[size], output);
+        ::std::atomic_thread_fence(::std::memory_order_acquire);
+        if (slot.sequence.load(::std::memory_order_relaxed) != sequence)
+        {   //  the slot was replaced while it was read
+            continue;
+        }
+        slot.stamp.store(set.clock.fetch_add(1, ::std::memory_order_relaxed), ::std::memory_order_relaxed);
+        dst.offset += output;
+        errors = toolkit::cp_errors(result);
+        return true;
+    }
+    return false;
+}
+
+void transcode_cache::insert(cache_set& set, const uint32_t hash, const uint32_t key, const uint8_t* const source, const uint32_t sourceSize, const uint8_t* const output, const uint32_t outputSize, const toolkit::cp_errors errors) noexcept
+{
+    uint32_t expected = 0;
+    while (!set.lock.compare_exchange_weak(expected, 1, ::std::memory_order_acquire, ::std::memory_order_relaxed))
+    {
+        expected = 0;
+    }
+    //  the least recently used slot (empty slots first) is replaced unless another thread stored the string first
+    const uint32_t now = set.clock.fetch_add(1, ::std::memory_order_relaxed);
+    cache_slot* victim = nullptr;
+    uint32_t oldest = 0;
+    bool stored = false;
+    for (uint32_t way = 0; way < m_ways; ++way)
+    {
+        cache_slot& slot = getSlot(set, way);
+        const uint32_t used = slot.key.load(::std::memory_order_relaxed);
+        if ((used == key) && (slot.hash.load(::std::memory_order_relaxed) == hash) && (slot.sourceSize.load(::std::memory_order_relaxed) == sourceSize) &&
+            (memcmp(&reinterpret_cast<const uint8_t*>(&slot)[internal::kSlotHeaderSize], source, sourceSize) == 0))
+        {
+            stored = true;
+            break;
+        }
+        const uint32_t age = ((used == 0) ? 0xffffffffu : (now - slot.stamp.load(::std::memory_order_relaxed)));
+        if ((victim == nullptr) || (age > oldest))
+        {
+            victim = &slot;
+            oldest = age;
+        }
+    }
+    if (!stored)
+    {
+        const bool eviction = (victim->key.load(::std::memory_order_relaxed) != 0);
+        const uint32_t sequence = victim->sequence.load(::std::memory_order_relaxed);
+        victim->sequence.store((sequence + 1), ::std::memory_order_relaxed);
+        ::std::atomic_thread_fence(::std::memory_order_release);
+        uint8_t* const data = &reinterpret_cast<uint8_t*>(victim)[internal::kSlotHeaderSize];
+        memcpy(data, source, sourceSize);
+        memcpy(&data[sourceSize], output, outputSize);
+        victim->key.store(key, ::std::memory_order_relaxed);
+        victim->hash.store(hash, ::std::memory_order_relaxed);
+        victim->sourceSize.store(sourceSize, ::std::memory_order_relaxed);
+        victim->outputSize.store(outputSize, ::std::memory_order_relaxed);
+        victim->errors.store(errors.raw(), ::std::memory_order_relaxed);
+        victim->stamp.store(now, ::std::memory_order_relaxed);
+        victim->sequence.store((sequence + 2), ::std::memory_order_release);
+        set.inserts.fetch_add(1, ::std::memory_order_relaxed);
+        if (eviction)
+        {
+            set.evictions.fetch_add(1, ::std::memory_order_relaxed);
+        }
+    }
+    set.lock.store(0, ::std::memory_order_release);
+}
+
+[[nodiscard]] toolkit::cp_errors transcode_cache::transcode(const toolkit::IUTFTK& from, utf_text& src, const toolkit::IUTFTK& to, utf_text& dst, const bool use_nlf) noexcept
+{
+    const toolkit::cp_errors check = (toolkit::get_errors(src, from.unitSize() - 1) | toolkit::get_errors(dst, to.unitSize() - 1));
+    const uint32_t size = (src.length - src.offset);
+    if ((m_sets == nullptr) || check.error() || (size == 0) || (size >= (m_slotSize - internal::kSlotHeaderSize)))
+    {   //  not cacheable
+        return bulk::transcode(from, src, to, dst, use_nlf);
+    }
+    const uint32_t key = internal::getKey(from, to, use_nlf);
+    const uint32_t hash = ((static_cast<uint32_t>(crc_ccitt_false(&src.buffer[src.offset], size)) << 16) ^ size);
+    cache_set& set = getSet(internal::mixHash(hash, key) & m_setMask);
+    toolkit::cp_errors errors;
+    if (lookup(set, hash, key, src, dst, errors))
+    {
+        src.offset = src.length;
+        set.hits.fetch_add(1, ::std::memory_order_relaxed);
+        return errors;
+    }
+    set.misses.fetch_add(1, ::std::memory_order_relaxed);
+    const uint32_t start = src.offset;
+    const uint32_t output = dst.offset;
+    errors = bulk::transcode(from, src, to, dst, use_nlf);
+    if (errors.no_error() && (src.offset == src.length) && ((size + (dst.offset - output)) <= (m_slotSize - internal::kSlotHeaderSize)))
+    {   //  only complete transcodes are stored
+        insert(set, hash, key, &src.buffer[start], size, &dst.buffer[output], (dst.offset - output), errors);
+    }
+    return errors;
+}
+
+void transcode_cache::clear() noexcept
+{
+    if (m_sets == nullptr)
+    {
+        return;
+    }
+    for (uint32_t index = 0; index <= m_setMask; ++index)
+    {
+        cache_set& set = getSet(index);
+        uint32_t expected = 0;
+        while (!set.lock.compare_exchange_weak(expected, 1, ::std::memory_order_acquire, ::std::memory_order_relaxed))
+        {
+            expected = 0;
+        }
+        for (uint32_t way = 0; way < m_ways; ++way)
+        {
+            cache_slot& slot = getSlot(set, way);
+            if (slot.key.load(::std::memory_order_relaxed) != 0)
+            {
+                const uint32_t sequence = slot.sequence.load(::std::memory_order_relaxed);
+                slot.sequence.store((sequence + 1), ::std::memory_order_relaxed);
+                ::std::atomic_thread_fence(::std::memory_order_release);
+                slot.key.store(0, ::std::memory_order_relaxed);
+                slot.sequence.store((sequence + 2), ::std::memory_order_release);
+            }
+        }
+        set.lock.store(0, ::std::memory_order_release);
+    }
+}
+
+[[nodiscard]] cache_statistics transcode_cache::statistics() const noexcept
+{
+    cache_statistics totals = { 0, 0, 0, 0 };
+    if (m_sets != nullptr)
+    {
+        for (uint32_t index = 0; index <= m_setMask; ++index)
+        {
+            const cache_set& set = getSet(index);
+            totals.hits += set.hits.load(::std::memory_order_relaxed);
+            totals.misses += set.misses.load(::std::memory_order_relaxed);
+            totals.inserts += set.inserts.load(::std::memory_order_relaxed);
+            totals.evictions += set.evictions.load(::std::memory_order_relaxed);
+        }
+    }
+    return totals;
+}
+
+};  //  namespace cache
+
+};  //  namespace utf
+
+};  //  namespace unicode
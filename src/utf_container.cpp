@@ -0,0 +1,390 @@
+
+//  SuiteUTF
+//  Original design 20102016; maintained and extended 20242025.
+//  Copyright (c) 20102025 Ritchie Brannan.
+//  MIT License. See LICENSE.txt. Project history: docs/History.md.
+//
+//  File:   utf_container.cpp
+//  Author: Ritchie Brannan
+//  Date:   18 Oct 26
+//  
+//  Description:
+//  
+//      Self-describing binary container for encoded text.
+
+#include "utf_container.h"
+#include "text_hash.h"
+#include <string.h>
+
+namespace unicode
+{
+
+namespace utf
+{
+
+namespace container
+{
+
+namespace internal
+{
+
+using toolkit::cp_errors;
+using toolkit::IUTFTK;
+using toolkit::UTF_SUB_TYPE;
+
+inline [[nodiscard]] uint32_t load16(const uint8_t* const buffer) noexcept
+{
+    return (static_cast<uint32_t>(buffer[0]) | (static_cast<uint32_t>(buffer[1]) << 8));
+}
+
+inline [[nodiscard]] uint32_t load32(const uint8_t* const buffer) noexcept
+{
+    return (static_cast<uint32_t>(buffer[0]) | (static_cast<uint32_t>(buffer[1]) << 8) | (static_cast<uint32_t>(buffer[2]) << 16) | (static_cast<uint32_t>(buffer[3]) << 24));
+}
+
+inline void store16(uint8_t* const buffer, const uint32_t value) noexcept
+{
+    buffer[0] = static_cast<uint8_t>(value);
+    buffer[1] = static_cast<uint8_t>(value >> 8);
+}
+
+inline void store32(uint8_t* const buffer, const uint32_t value) noexcept
+{
+    buffer[0] = static_cast<uint8_t>(value);
+    buffer[1] = static_cast<uint8_t>(value >> 8);
+    buffer[2] = static_cast<uint8_t>(value >> 16);
+    buffer[3] = static_cast<uint8_t>(value >> 24);
+}
+
+/// internal check for the line-feed variants counted by getNLF()
+inline [[nodiscard]] bool isLineFeed(const unicode_t unicode) noexcept
+{
+    const uint32_t value = static_cast<uint32_t>(unicode);
+    return (((value - 0x0au) < 4u) || (value == 0x85u) || ((value & 0xfffffffeu) == 0x2028u));
+}
+
+/// internal index entry writer or comparer
+struct index_cursor
+{
+    uint8_t*        output;     //  entries are written here if not null
+    const uint8_t*  expected;   //  entries are compared with these if not null
+    uint32_t        count;
+    bool            mismatch;
+};
+
+inline void addSample(index_cursor& cursor, const uint32_t offset) noexcept
+{
+    if (cursor.output != nullptr)
+    {
+        store32(&cursor.output[cursor.count << 2], offset);
+    }
+    if ((cursor.expected != nullptr) && (load32(&cursor.expected[cursor.count << 2]) != offset))
+    {
+        cursor.mismatch = true;
+    }
+    ++cursor.count;
+}
+
+/// internal metadata scan of the text from text.offset to text.length, writing or comparing the index entries
+[[nodiscard]] cp_errors scanText(const IUTFTK& handler, const utf_text& text, const uint32_t interval, container_info& info, index_cursor& points, index_cursor& lines) noexcept
+{
+    info = container_info();
+    info.utfSubType = handler.utfSubType();
+    info.interval = interval;
+    info.line_count = 1;
+    cp_errors errors = toolkit::get_errors(text, (handler.unitSize() - 1));
+    if (errors.no_error())
+    {
+        info.length = (text.length - text.offset);
+        info.crc = crc_ccitt_false(&text.buffer[text.offset], info.length);
+        utf_text scan = text;
+        while (scan.offset < scan.length)
+        {
+            unicode_t unicode = 0;
+            uint32_t bytes = 0;
+            const cp_errors check = handler.get(scan, unicode, bytes);
+            errors |= check;
+            if (check.error())
+            {
+                break;
+            }
+            if (interval && info.code_points && ((info.code_points % interval) == 0))
+            {
+                addSample(points, (scan.offset - text.offset));
+            }
+            ++info.code_points;
+            info.utf16_length += ((static_cast<uint32_t>(unicode) > 0xffffu) ? 2 : 1);
+            if (isLineFeed(unicode))
+            {
+                if ((unicode == 0x0au) || (unicode == 0x0du))
+                {   //  a { 0x0d, 0x0a } or { 0x0a, 0x0d } pairing is one line-feed
+                    unicode_t paired = 0;
+                    uint32_t pairing = 0;
+                    if (handler.getNLF(scan, paired, pairing).no_error() && (pairing > bytes))
+                    {
+                        if (interval && ((info.code_points % interval) == 0))
+                        {
+                            addSample(points, (scan.offset + bytes - text.offset));
+                        }
+                        ++info.code_points;
+                        ++info.utf16_length;
+                        bytes = pairing;
+                    }
+                }
+                if (interval && ((info.line_count % interval) == 0))
+                {
+                    addSample(lines, (scan.offset + bytes - text.offset));
+                }
+                ++info.line_count;
+            }
+            scan.offset += bytes;
+        }
+        info.warnings = errors.warnings_only();
+        info.point_samples = (interval && info.code_points) ? ((info.code_points - 1) / interval) : 0;
+        info.line_samples = interval ? ((info.line_count - 1) / interval) : 0;
+    }
+    return errors;
+}
+
+/// internal crc of the header fields and the indexes
+inline [[nodiscard]] uint16_t headerCrc(const uint8_t* const container, const uint32_t indexBytes) noexcept
+{
+    const uint16_t crc = crc_ccitt_false(container, (kContainerHeaderSize - 2));
+    return crc_ccitt_false_update(crc, &container[kContainerHeaderSize], indexBytes);
+}
+
+inline [[nodiscard]] bool sameInfo(const container_info& lhs, const container_info& rhs) noexcept
+{
+    return ((lhs.utfSubType == rhs.utfSubType) && (lhs.length == rhs.length) && (lhs.code_points == rhs.code_points) && (lhs.utf16_length == rhs.utf16_length) &&
+        (lhs.line_count == rhs.line_count) && (lhs.warnings == rhs.warnings) && (lhs.interval == rhs.interval) && (lhs.point_samples == rhs.point_samples) &&
+        (lhs.line_samples == rhs.line_samples) && (lhs.crc == rhs.crc));
+}
+
+};  //  namespace internal
+
+// ==== container writing functions ====
+
+[[nodiscard]] toolkit::cp_errors describeText(const toolkit::IUTFTK& handler, const utf_text& text, const uint32_t interval, container_info& info) noexcept
+{
+    internal::index_cursor points = { nullptr, nullptr, 0, false };
+    internal::index_cursor lines = { nullptr, nullptr, 0, false };
+    return internal::scanText(handler, text, interval, info, points, lines);
+}
+
+uint32_t containerSize(const container_info& info) noexcept
+{
+    const uint64_t size = (static_cast<uint64_t>(kContainerHeaderSize) + (static_cast<uint64_t>(info.point_samples) << 2) + (static_cast<uint64_t>(info.line_samples) << 2) + info.length);
+    return ((size <= 0xffffffffull) ? static_cast<uint32_t>(size) : 0);
+}
+
+[[nodiscard]] toolkit::cp_errors writeContainer(const toolkit::IUTFTK& handler, const utf_text& text, const container_info& info, utf_text& dst) noexcept
+{
+    toolkit::cp_errors errors = toolkit::get_errors(dst);
+    const uint32_t size = containerSize(info);
+    if (errors.no_error())
+    {
+        if ((size == 0) || (info.utfSubType != handler.utfSubType()) || toolkit::isCustomSubType(info.utfSubType))
+        {
+            errors |= (toolkit::cp_errors::bits::Failed | toolkit::cp_errors::bits::InvalidBuffer);
+        }
+        else if ((dst.length - dst.offset) < size)
+        {
+            errors |= (toolkit::cp_errors::bits::Failed | toolkit::cp_errors::bits::WriteOverflow);
+        }
+    }
+    if (errors.no_error())
+    {
+        uint8_t* const container = &dst.buffer[dst.offset];
+        const uint32_t indexBytes = ((info.point_samples + info.line_samples) << 2);
+        internal::index_cursor points = { &container[kContainerHeaderSize], nullptr, 0, false };
+        internal::index_cursor lines = { &container[kContainerHeaderSize + (info.point_samples << 2)], nullptr, 0, false };
+        container_info check;
+        errors |= internal::scanText(handler, text, info.interval, check, points, lines);
+        if (errors.error() || !internal::sameInfo(info, check))
+        {   //  the info does not describe the text
+            return (errors.errors_only() | toolkit::cp_errors::bits::Failed | toolkit::cp_errors::bits::InvalidBuffer);
+        }
+        internal::store32(&container[0], kContainerMagic);
+        internal::store16(&container[4], kContainerVersion);
+        container[6] = static_cast<uint8_t>(info.utfSubType);
+        container[7] = 0;
+        internal::store32(&container[8], (kContainerHeaderSize + indexBytes));
+        internal::store32(&container[12], info.length);
+        internal::store32(&container[16], info.code_points);
+        internal::store32(&container[20], info.utf16_length);
+        internal::store32(&container[24], info.line_count);
+        internal::store32(&container[28], info.warnings.raw());
+        internal::store32(&container[32], info.interval);
+        internal::store32(&container[36], info.point_samples);
+        internal::store32(&container[40], info.line_samples);
+        internal::store16(&container[44], info.crc);
+        internal::store16(&container[46], internal::headerCrc(container, indexBytes));
+        memcpy(&container[kContainerHeaderSize + indexBytes], &text.buffer[text.offset], info.length);
+        dst.offset += size;
+    }
+    return errors;
+}
+
+// ==== container reading functions ====
+
+[[nodiscard]] toolkit::cp_errors openContainer(const utf_text& src, container_view& view, const bool verify) noexcept
+{
+    view = container_view();
+    toolkit::cp_errors errors = toolkit::get_errors(src);
+    if (errors.error())
+    {
+        return errors;
+    }
+    const uint32_t available = (src.length - src.offset);
+    const uint8_t* const container = &src.buffer[src.offset];
+    if (available < kContainerHeaderSize)
+    {
+        return (toolkit::cp_errors::bits::Failed | toolkit::cp_errors::bits::ReadTruncated);
+    }
+    container_info& info = view.info;
+    info.utfSubType = static_cast<toolkit::UTF_SUB_TYPE>(container[6]);
+    info.length = internal::load32(&container[12]);
+    info.code_points = internal::load32(&container[16]);
+    info.utf16_length = internal::load32(&container[20]);
+    info.line_count = internal::load32(&container[24]);
+    info.warnings = toolkit::cp_errors(internal::load32(&container[28]));
+    info.interval = internal::load32(&container[32]);
+    info.point_samples = internal::load32(&container[36]);
+    info.line_samples = internal::load32(&container[40]);
+    info.crc = static_cast<uint16_t>(internal::load16(&container[44]));
+    const uint32_t payload = internal::load32(&container[8]);
+    const uint64_t indexBytes = ((static_cast<uint64_t>(info.point_samples) + info.line_samples) << 2);
+    const bool valid = ((internal::load32(&container[0]) == kContainerMagic) && (internal::load16(&container[4]) == kContainerVersion) && (container[7] == 0) &&
+        (container[6] < static_cast<uint8_t>(toolkit::UTF_SUB_TYPE::COUNT)) && (payload == (kContainerHeaderSize + indexBytes)) && (info.line_count != 0) && info.warnings.no_error() &&
+        (info.point_samples == ((info.interval && info.code_points) ? ((info.code_points - 1) / info.interval) : 0)) &&
+        (info.line_samples == (info.interval ? ((info.line_count - 1) / info.interval) : 0)));
+    if (!valid)
+    {
+        return (toolkit::cp_errors::bits::Failed | toolkit::cp_errors::bits::InvalidBuffer);
+    }
+    if ((static_cast<uint64_t>(payload) + info.length) > available)
+    {
+        return (toolkit::cp_errors::bits::Failed | toolkit::cp_errors::bits::ReadTruncated);
+    }
+    if (internal::load16(&container[46]) != internal::headerCrc(container, static_cast<uint32_t>(indexBytes)))
+    {
+        return (toolkit::cp_errors::bits::Failed | toolkit::cp_errors::bits::InvalidBuffer);
+    }
+    if (!toolkit::isSubTypeAvailable(info.utfSubType))
+    {
+        return (toolkit::cp_errors::bits::Failed | toolkit::cp_errors::bits::NotDecodable);
+    }
+    const toolkit::IUTFTK& handler = toolkit::IUTFTK::getHandler(info.utfSubType);
+    view.text = { info.length, 0, const_cast<uint8_t*>(&container[payload]) };
+    view.point_index = (info.point_samples ? &container[kContainerHeaderSize] : nullptr);
+    view.line_index = (info.line_samples ? &container[kContainerHeaderSize + (info.point_samples << 2)] : nullptr);
+    if (info.length & (handler.unitSize() - 1))
+    {
+        errors |= (toolkit::cp_errors::bits::Failed | toolkit::cp_errors::bits::InvalidBuffer);
+    }
+    else if (verify)
+    {
+        internal::index_cursor points = { nullptr, view.point_index, 0, false };
+        internal::index_cursor lines = { nullptr, view.line_index, 0, false };
+        container_info check;
+        const toolkit::cp_errors status = internal::scanText(handler, view.text, info.interval, check, points, lines);
+        if (status.error() || !internal::sameInfo(info, check) || points.mismatch || lines.mismatch)
+        {
+            errors |= (toolkit::cp_errors::bits::Failed | toolkit::cp_errors::bits::InvalidBuffer);
+        }
+    }
+    if (errors.error())
+    {
+        view = container_view();
+    }
+    return errors;
+}
+
+[[nodiscard]] toolkit::cp_errors seekCodePoint(const container_view& view, const uint32_t index, uint32_t& offset) noexcept
+{
+    offset = 0;
+    toolkit::cp_errors errors;
+    if (index > view.info.code_points)
+    {
+        errors |= (toolkit::cp_errors::bits::Failed | toolkit::cp_errors::bits::InvalidOffset);
+    }
+    else if (index == view.info.code_points)
+    {
+        offset = view.info.length;
+    }
+    else
+    {
+        const toolkit::IUTFTK& handler = toolkit::IUTFTK::getHandler(view.info.utfSubType);
+        utf_text scan = view.text;
+        uint32_t current = 0;
+        const uint32_t sample = (view.info.interval ? (index / view.info.interval) : 0);
+        if (sample)
+        {
+            scan.offset = internal::load32(&view.point_index[(sample - 1) << 2]);
+            current = (sample * view.info.interval);
+        }
+        while ((current < index) && (scan.offset < scan.length))
+        {   //  the payload decodes without errors so every code-point can be read
+            unicode_t unicode = 0;
+            uint32_t bytes = 0;
+            errors |= handler.get(scan, unicode, bytes);
+            if (errors.error())
+            {
+                break;
+            }
+            scan.offset += bytes;
+            ++current;
+        }
+        offset = scan.offset;
+    }
+    return errors.errors_only();
+}
+
+[[nodiscard]] toolkit::cp_errors seekLine(const container_view& view, const uint32_t line, uint32_t& offset) noexcept
+{
+    offset = 0;
+    toolkit::cp_errors errors;
+    if (line > view.info.line_count)
+    {
+        errors |= (toolkit::cp_errors::bits::Failed | toolkit::cp_errors::bits::InvalidOffset);
+    }
+    else if (line == view.info.line_count)
+    {
+        offset = view.info.length;
+    }
+    else
+    {
+        const toolkit::IUTFTK& handler = toolkit::IUTFTK::getHandler(view.info.utfSubType);
+        utf_text scan = view.text;
+        uint32_t current = 0;
+        const uint32_t sample = (view.info.interval ? (line / view.info.interval) : 0);
+        if (sample)
+        {
+            scan.offset = internal::load32(&view.line_index[(sample - 1) << 2]);
+            current = (sample * view.info.interval);
+        }
+        while ((current < line) && (scan.offset < scan.length))
+        {
+            unicode_t unicode = 0;
+            uint32_t bytes = 0;
+            errors |= handler.getNLF(scan, unicode, bytes);
+            if (errors.error())
+            {
+                break;
+            }
+            scan.offset += bytes;
+            if (unicode == 0x0au)
+            {
+                ++current;
+            }
+        }
+        offset = scan.offset;
+    }
+    return errors.errors_only();
+}
+
+};  //  namespace container
+
+};  //  namespace utf
+
+};  //  namespace unicode
@@ -0,0 +1,59 @@
+
+//  SuiteUTF
+//  Original design 20102016; maintained and extended 20242025.
+//  Copyright (c) 20102025 Ritchie Brannan.
+//  MIT License. See LICENSE.txt. Project history: docs/History.md.
+//
+//  File:   utf_pipeline.cpp
+//  Author: Ritchie Brannan
+//  Date:   18 Oct 26
+//  
+//  Description:
+//  
+//      Platform specific support for the threaded stage pipeline.
+
+#include "utf_pipeline.h"
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace unicode
+{
+
+namespace utf
+{
+
+namespace pipeline
+{
+
+[[nodiscard]] bool pinThread(const int cpu) noexcept
+{
+#if defined(_WIN32)
+    return ((cpu >= 0) && (cpu < static_cast<int>(sizeof(DWORD_PTR) * 8)) && (SetThreadAffinityMask(GetCurrentThread(), (static_cast<DWORD_PTR>(1) << cpu)) != 0));
+#elif defined(__linux__)
+    if ((cpu < 0) || (cpu >= CPU_SETSIZE))
+    {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0);
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+};  //  namespace pipeline
+
+};  //  namespace utf
+
+};  //  namespace unicode
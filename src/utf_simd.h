@@ -0,0 +1,566 @@
+
+//  SuiteUTF
+//  Original design 20102016; maintained and extended 20242025.
+//  Copyright (c) 20102025 Ritchie Brannan.
+//  MIT License. See LICENSE.txt. Project history: docs/History.md.
+//
+//  File:   utf_simd.h
+//  Author: Ritchie Brannan
+//  Date:   18 Oct 26
+//  
+//  Description:
+//  
+//      Internal portable SIMD and word-at-a-time layer for the bulk and toolkit kernels.
+//  
+//  Notes:
+//  
+//      This header is internal to the library sources, it is not part of the public API.
+//  
+//      The bulk kernels are written once against the types and functions below:
+//  
+//          v128        : a 16 byte vector (SSE2 and scalar backends) with 8, 16 and 32-bit lane operations.
+//          block64     : a 64 byte block (AVX-512BW, AVX2, SSE2 and scalar backends) compared to byte masks.
+//          bit masks   : lowest and highest set bit, population count and prefix-XOR.
+//          byte order  : unaligned 16 and 32-bit code-unit loads in either byte order, and 64-bit words of 4 UTF16
+//                        or 2 UTF32 code-units with SWAR surrogate tests (for the scalar paths and short strings).
+//  
+//      The backends are selected from the target options of the build (for example -mavx2 or /arch:AVX2), there
+//      is no run-time dispatch. Defining SUITEUTF_SIMD_SCALAR (for the whole build) selects the scalar backends on
+//      any target, so the kernels can be tested without SIMD hardware. The scalar backends treat the lanes as
+//      little endian regardless of the host, matching the hardware backends.
+//  
+//      The lane operations follow the SSE2 semantics: comparisons return all ones or all zeros lanes, greater and
+//      less are signed, min8u is unsigned, moveMask8() and moveMask32() collect the top bit of each lane.
+//  
+//      The code-unit loads use memcpy (a single unaligned load on the common targets) and a byte swap when the
+//      byte order differs from the host. The lanes of the 64-bit words are in host order, so the words should only
+//      be used for tests and counts which do not depend on the position of a code-unit.
+//  
+//      kStreaming is true when non-temporal stores are available. Without them streamStore() is a plain store,
+//      and prefetch() and fence() do nothing.
+
+#pragma once
+
+#ifndef __UTF_SIMD_INCLUDED__
+#define __UTF_SIMD_INCLUDED__
+
+#include "unicode_type.h"
+#include <string.h>
+
+#if !defined(SUITEUTF_SIMD_SCALAR) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)))
+#define SUITEUTF_SIMD_SSE2
+#include <emmintrin.h>
+#if defined(__AVX2__)
+#define SUITEUTF_SIMD_AVX2
+#include <immintrin.h>
+#endif
+#if defined(__AVX512BW__)
+#define SUITEUTF_SIMD_AVX512
+#endif
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace unicode
+{
+
+namespace utf
+{
+
+namespace simd
+{
+
+// ==== 16 byte vectors ====
+
+#if defined(SUITEUTF_SIMD_SSE2)
+
+constexpr bool kStreaming = true;
+
+struct v128
+{
+    __m128i     value;
+};
+
+inline v128 loadu(const void* const src) noexcept { return { _mm_loadu_si128(static_cast<const __m128i*>(src)) }; }
+inline void storeu(void* const dst, const v128 a) noexcept { _mm_storeu_si128(static_cast<__m128i*>(dst), a.value); }
+inline void storeLow64(void* const dst, const v128 a) noexcept { _mm_storel_epi64(static_cast<__m128i*>(dst), a.value); }
+inline void streamStore(void* const dst, const v128 a) noexcept { _mm_stream_si128(static_cast<__m128i*>(dst), a.value); }
+inline void prefetch(const void* const src) noexcept { _mm_prefetch(static_cast<const char*>(src), _MM_HINT_NTA); }
+inline void fence() noexcept { _mm_sfence(); }
+
+inline v128 zero() noexcept { return { _mm_setzero_si128() }; }
+inline v128 splat8(const uint8_t value) noexcept { return { _mm_set1_epi8(static_cast<char>(value)) }; }
+inline v128 splat16(const uint16_t value) noexcept { return { _mm_set1_epi16(static_cast<short>(value)) }; }
+inline v128 splat32(const uint32_t value) noexcept { return { _mm_set1_epi32(static_cast<int>(value)) }; }
+
+inline v128 bitAnd(const v128 a, const v128 b) noexcept { return { _mm_and_si128(a.value, b.value) }; }
+inline v128 bitOr(const v128 a, const v128 b) noexcept { return { _mm_or_si128(a.value, b.value) }; }
+inline v128 bitXor(const v128 a, const v128 b) noexcept { return { _mm_xor_si128(a.value, b.value) }; }
+inline v128 bitAndNot(const v128 a, const v128 b) noexcept { return { _mm_andnot_si128(a.value, b.value) }; }   //  ~a & b
+
+inline v128 add8(const v128 a, const v128 b) noexcept { return { _mm_add_epi8(a.value, b.value) }; }
+inline v128 add16(const v128 a, const v128 b) noexcept { return { _mm_add_epi16(a.value, b.value) }; }
+inline v128 add32(const v128 a, const v128 b) noexcept { return { _mm_add_epi32(a.value, b.value) }; }
+inline v128 sub8(const v128 a, const v128 b) noexcept { return { _mm_sub_epi8(a.value, b.value) }; }
+inline v128 sub16(const v128 a, const v128 b) noexcept { return { _mm_sub_epi16(a.value, b.value) }; }
+inline v128 sub32(const v128 a, const v128 b) noexcept { return { _mm_sub_epi32(a.value, b.value) }; }
+
+inline v128 equal8(const v128 a, const v128 b) noexcept { return { _mm_cmpeq_epi8(a.value, b.value) }; }
+inline v128 equal16(const v128 a, const v128 b) noexcept { return { _mm_cmpeq_epi16(a.value, b.value) }; }
+inline v128 equal32(const v128 a, const v128 b) noexcept { return { _mm_cmpeq_epi32(a.value, b.value) }; }
+inline v128 less8(const v128 a, const v128 b) noexcept { return { _mm_cmplt_epi8(a.value, b.value) }; }
+inline v128 less16(const v128 a, const v128 b) noexcept { return { _mm_cmplt_epi16(a.value, b.value) }; }
+inline v128 greater16(const v128 a, const v128 b) noexcept { return { _mm_cmpgt_epi16(a.value, b.value) }; }
+inline v128 greater32(const v128 a, const v128 b) noexcept { return { _mm_cmpgt_epi32(a.value, b.value) }; }
+inline v128 min8u(const v128 a, const v128 b) noexcept { return { _mm_min_epu8(a.value, b.value) }; }
+
+inline v128 swapBytes16(const v128 a) noexcept { return { _mm_or_si128(_mm_slli_epi16(a.value, 8), _mm_srli_epi16(a.value, 8)) }; }
+inline v128 swapBytes32(const v128 a) noexcept { return swapBytes16({ _mm_shufflehi_epi16(_mm_shufflelo_epi16(a.value, 0xb1), 0xb1) }); }
+inline v128 interleaveLow8(const v128 a, const v128 b) noexcept { return { _mm_unpacklo_epi8(a.value, b.value) }; }
+inline v128 interleaveHigh8(const v128 a, const v128 b) noexcept { return { _mm_unpackhi_epi8(a.value, b.value) }; }
+inline v128 interleaveLow16(const v128 a, const v128 b) noexcept { return { _mm_unpacklo_epi16(a.value, b.value) }; }
+inline v128 interleaveHigh16(const v128 a, const v128 b) noexcept { return { _mm_unpackhi_epi16(a.value, b.value) }; }
+inline v128 packSigned32(const v128 a, const v128 b) noexcept { return { _mm_packs_epi32(a.value, b.value) }; }
+inline v128 packUnsigned16(const v128 a, const v128 b) noexcept { return { _mm_packus_epi16(a.value, b.value) }; }
+
+inline uint32_t moveMask8(const v128 a) noexcept { return static_cast<uint32_t>(_mm_movemask_epi8(a.value)); }
+inline uint32_t moveMask32(const v128 a) noexcept { return static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(a.value))); }
+inline uint32_t orLanes32(const v128 a) noexcept
+{
+    const __m128i half = _mm_or_si128(a.value, _mm_srli_si128(a.value, 8));
+    return static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_or_si128(half, _mm_srli_si128(half, 4))));
+}
+inline void lanes32(const v128 a, uint32_t* const lanes) noexcept { _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), a.value); }
+
+#else
+
+constexpr bool kStreaming = false;
+
+struct v128
+{
+    alignas(16) uint8_t bytes[16];
+};
+
+namespace internal
+{
+
+inline uint32_t getLane(const v128& a, const uint32_t index, const uint32_t size) noexcept
+{
+    uint32_t value = 0;
+    for (uint32_t byte = 0; byte < size; ++byte)
+    {
+        value |= (static_cast<uint32_t>(a.bytes[(index * size) + byte]) << (byte << 3));
+    }
+    return value;
+}
+
+inline void setLane(v128& a, const uint32_t index, const uint32_t size, const uint32_t value) noexcept
+{
+    for (uint32_t byte = 0; byte < size; ++byte)
+    {
+        a.bytes[(index * size) + byte] = static_cast<uint8_t>(value >> (byte << 3));
+    }
+}
+
+inline int32_t signedLane(const uint32_t value, const uint32_t size) noexcept
+{
+    const uint32_t shift = (32 - (size << 3));
+    return (static_cast<int32_t>(value << shift) >> shift);
+}
+
+/// lane-wise operation on the lanes of size bytes
+template <typename Operation>
+inline v128 lanewise(const v128& a, const v128& b, const uint32_t size, const Operation& operation) noexcept
+{
+    v128 result;
+    for (uint32_t index = 0; index < (16 / size); ++index)
+    {
+        setLane(result, index, size, operation(getLane(a, index, size), getLane(b, index, size)));
+    }
+    return result;
+}
+
+inline uint32_t allOnes(const bool test) noexcept { return (test ? 0xffffffffu : 0); }
+
+/// interleave the low (first = 0) or high (first = half the lanes) lanes of size bytes
+inline v128 interleave(const v128& a, const v128& b, const uint32_t size, const uint32_t first) noexcept
+{
+    v128 result;
+    for (uint32_t index = 0; index < (8 / size); ++index)
+    {
+        setLane(result, (index << 1), size, getLane(a, (first + index), size));
+        setLane(result, ((index << 1) + 1), size, getLane(b, (first + index), size));
+    }
+    return result;
+}
+
+};  //  namespace internal
+
+inline v128 loadu(const void* const src) noexcept { v128 a; memcpy(a.bytes, src, 16); return a; }
+inline void storeu(void* const dst, const v128 a) noexcept { memcpy(dst, a.bytes, 16); }
+inline void storeLow64(void* const dst, const v128 a) noexcept { memcpy(dst, a.bytes, 8); }
+inline void streamStore(void* const dst, const v128 a) noexcept { memcpy(dst, a.bytes, 16); }
+inline void prefetch(const void* const src) noexcept { (void)src; }
+inline void fence() noexcept {}
+
+inline v128 zero() noexcept { v128 a; memset(a.bytes, 0, 16); return a; }
+inline v128 splat8(const uint8_t value) noexcept { v128 a; memset(a.bytes, value, 16); return a; }
+
+inline v128 splat16(const uint16_t value) noexcept
+{
+    v128 a;
+    for (uint32_t index = 0; index < 8; ++index)
+    {
+        internal::setLane(a, index, 2, value);
+    }
+    return a;
+}
+
+inline v128 splat32(const uint32_t value) noexcept
+{
+    v128 a;
+    for (uint32_t index = 0; index < 4; ++index)
+    {
+        internal::setLane(a, index, 4, value);
+    }
+    return a;
+}
+
+
+inline v128 bitAnd(const v128 a, const v128 b) noexcept { return internal::lanewise(a, b, 1, [](const uint32_t x, const uint32_t y) { return (x & y); }); }
+inline v128 bitOr(const v128 a, const v128 b) noexcept { return internal::lanewise(a, b, 1, [](const uint32_t x, const uint32_t y) { return (x | y); }); }
+inline v128 bitXor(const v128 a, const v128 b) noexcept { return internal::lanewise(a, b, 1, [](const uint32_t x, const uint32_t y) { return (x ^ y); }); }
+inline v128 bitAndNot(const v128 a, const v128 b) noexcept { return internal::lanewise(a, b, 1, [](const uint32_t x, const uint32_t y) { return (~x & y); }); }   //  ~a & b
+
+inline v128 add8(const v128 a, const v128 b) noexcept { return internal::lanewise(a, b, 1, [](const uint32_t x, const uint32_t y) { return (x + y); }); }
+inline v128 add16(const v128 a, const v128 b) noexcept { return internal::lanewise(a, b, 2, [](const uint32_t x, const uint32_t y) { return (x + y); }); }
+inline v128 add32(const v128 a, const v128 b) noexcept { return internal::lanewise(a, b, 4, [](const uint32_t x, const uint32_t y) { return (x + y); }); }
+inline v128 sub8(const v128 a, const v128 b) noexcept { return internal::lanewise(a, b, 1, [](const uint32_t x, const uint32_t y) { return (x - y); }); }
+inline v128 sub16(const v128 a, const v128 b) noexcept { return internal::lanewise(a, b, 2, [](const uint32_t x, const uint32_t y) { return (x - y); }); }
+inline v128 sub32(const v128 a, const v128 b) noexcept { return internal::lanewise(a, b, 4, [](const uint32_t x, const uint32_t y) { return (x - y); }); }
+
+inline v128 equal8(const v128 a, const v128 b) noexcept { return internal::lanewise(a, b, 1, [](const uint32_t x, const uint32_t y) { return internal::allOnes(x == y); }); }
+inline v128 equal16(const v128 a, const v128 b) noexcept { return internal::lanewise(a, b, 2, [](const uint32_t x, const uint32_t y) { return internal::allOnes(x == y); }); }
+inline v128 equal32(const v128 a, const v128 b) noexcept { return internal::lanewise(a, b, 4, [](const uint32_t x, const uint32_t y) { return internal::allOnes(x == y); }); }
+inline v128 less8(const v128 a, const v128 b) noexcept { return internal::lanewise(a, b, 1, [](const uint32_t x, const uint32_t y) { return internal::allOnes(internal::signedLane(x, 1) < internal::signedLane(y, 1)); }); }
+inline v128 less16(const v128 a, const v128 b) noexcept { return internal::lanewise(a, b, 2, [](const uint32_t x, const uint32_t y) { return internal::allOnes(internal::signedLane(x, 2) < internal::signedLane(y, 2)); }); }
+inline v128 greater16(const v128 a, const v128 b) noexcept { return internal::lanewise(a, b, 2, [](const uint32_t x, const uint32_t y) { return internal::allOnes(internal::signedLane(x, 2) > internal::signedLane(y, 2)); }); }
+inline v128 greater32(const v128 a, const v128 b) noexcept { return internal::lanewise(a, b, 4, [](const uint32_t x, const uint32_t y) { return internal::allOnes(internal::signedLane(x, 4) > internal::signedLane(y, 4)); }); }
+inline v128 min8u(const v128 a, const v128 b) noexcept { return internal::lanewise(a, b, 1, [](const uint32_t x, const uint32_t y) { return ((x < y) ? x : y); }); }
+
+inline v128 swapBytes16(const v128 a) noexcept
+{
+    v128 result;
+    for (uint32_t index = 0; index < 16; ++index)
+    {
+        result.bytes[index] = a.bytes[index ^ 1];
+    }
+    return result;
+}
+
+inline v128 swapBytes32(const v128 a) noexcept
+{
+    v128 result;
+    for (uint32_t index = 0; index < 16; ++index)
+    {
+        result.bytes[index] = a.bytes[index ^ 3];
+    }
+    return result;
+}
+
+inline v128 interleaveLow8(const v128 a, const v128 b) noexcept { return internal::interleave(a, b, 1, 0); }
+inline v128 interleaveHigh8(const v128 a, const v128 b) noexcept { return internal::interleave(a, b, 1, 8); }
+inline v128 interleaveLow16(const v128 a, const v128 b) noexcept { return internal::interleave(a, b, 2, 0); }
+inline v128 interleaveHigh16(const v128 a, const v128 b) noexcept { return internal::interleave(a, b, 2, 4); }
+
+inline v128 packSigned32(const v128 a, const v128 b) noexcept
+{
+    v128 result;
+    for (uint32_t index = 0; index < 8; ++index)
+    {
+        const int32_t value = static_cast<int32_t>(internal::getLane(((index < 4) ? a : b), (index & 3), 4));
+        internal::setLane(result, index, 2, static_cast<uint32_t>((value < -32768) ? -32768 : ((value > 32767) ? 32767 : value)));
+    }
+    return result;
+}
+
+inline v128 packUnsigned16(const v128 a, const v128 b) noexcept
+{
+    v128 result;
+    for (uint32_t index = 0; index < 16; ++index)
+    {
+        const int32_t value = internal::signedLane(internal::getLane(((index < 8) ? a : b), (index & 7), 2), 2);
+        result.bytes[index] = static_cast<uint8_t>((value < 0) ? 0 : ((value > 255) ? 255 : value));
+    }
+    return result;
+}
+
+inline uint32_t moveMask8(const v128 a) noexcept
+{
+    uint32_t mask = 0;
+    for (uint32_t index = 0; index < 16; ++index)
+    {
+        mask |= (static_cast<uint32_t>(a.bytes[index] >> 7) << index);
+    }
+    return mask;
+}
+
+inline uint32_t moveMask32(const v128 a) noexcept
+{
+    return (((a.bytes[3] >> 7) | ((a.bytes[7] >> 7) << 1)) | (((a.bytes[11] >> 7) << 2) | ((a.bytes[15] >> 7) << 3)));
+}
+
+inline uint32_t orLanes32(const v128 a) noexcept
+{
+    return ((internal::getLane(a, 0, 4) | internal::getLane(a, 1, 4)) | (internal::getLane(a, 2, 4) | internal::getLane(a, 3, 4)));
+}
+
+inline void lanes32(const v128 a, uint32_t* const lanes) noexcept
+{
+    for (uint32_t index = 0; index < 4; ++index)
+    {
+        lanes[index] = internal::getLane(a, index, 4);
+    }
+}
+
+#endif
+
+// ==== 64 byte blocks ====
+
+#if defined(SUITEUTF_SIMD_AVX512)
+
+struct block64
+{
+    __m512i     value;
+};
+
+inline block64 loadBlock(const uint8_t* const src) noexcept { return { _mm512_loadu_si512(src) }; }
+inline uint64_t equalMask(const block64& block, const uint8_t byte) noexcept { return static_cast<uint64_t>(_mm512_cmpeq_epi8_mask(block.value, _mm512_set1_epi8(static_cast<char>(byte)))); }
+inline uint64_t rangeMask(const block64& block, const uint8_t low, const uint8_t span) noexcept
+{   //  bytes from low to (low + span)
+    return static_cast<uint64_t>(_mm512_cmple_epu8_mask(_mm512_sub_epi8(block.value, _mm512_set1_epi8(static_cast<char>(low))), _mm512_set1_epi8(static_cast<char>(span))));
+}
+
+#elif defined(SUITEUTF_SIMD_AVX2)
+
+struct block64
+{
+    __m256i     value[2];
+};
+
+inline block64 loadBlock(const uint8_t* const src) noexcept
+{
+    return { { _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&src[32])) } };
+}
+
+inline uint64_t equalMask(const block64& block, const uint8_t byte) noexcept
+{
+    const __m256i bytes = _mm256_set1_epi8(static_cast<char>(byte));
+    return (static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block.value[0], bytes)))) |
+           (static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block.value[1], bytes)))) << 32));
+}
+
+inline uint64_t rangeMask(const block64& block, const uint8_t low, const uint8_t span) noexcept
+{   //  bytes from low to (low + span)
+    const __m256i lows = _mm256_set1_epi8(static_cast<char>(low));
+    const __m256i spans = _mm256_set1_epi8(static_cast<char>(span));
+    const __m256i offset0 = _mm256_sub_epi8(block.value[0], lows);
+    const __m256i offset1 = _mm256_sub_epi8(block.value[1], lows);
+    return (static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_min_epu8(offset0, spans), offset0)))) |
+           (static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_min_epu8(offset1, spans), offset1)))) << 32));
+}
+
+#else
+
+struct block64
+{
+    v128        value[4];
+};
+
+inline block64 loadBlock(const uint8_t* const src) noexcept
+{
+    return { { loadu(src), loadu(&src[16]), loadu(&src[32]), loadu(&src[48]) } };
+}
+
+inline uint64_t equalMask(const block64& block, const uint8_t byte) noexcept
+{
+    const v128 bytes = splat8(byte);
+    uint64_t mask = 0;
+    for (uint32_t index = 0; index < 4; ++index)
+    {
+        mask |= (static_cast<uint64_t>(moveMask8(equal8(block.value[index], bytes))) << (index << 4));
+    }
+    return mask;
+}
+
+inline uint64_t rangeMask(const block64& block, const uint8_t low, const uint8_t span) noexcept
+{   //  bytes from low to (low + span)
+    const v128 lows = splat8(low);
+    const v128 spans = splat8(span);
+    uint64_t mask = 0;
+    for (uint32_t index = 0; index < 4; ++index)
+    {
+        const v128 offset = sub8(block.value[index], lows);
+        mask |= (static_cast<uint64_t>(moveMask8(equal8(min8u(offset, spans), offset))) << (index << 4));
+    }
+    return mask;
+}
+
+#endif
+
+// ==== bit mask functions ====
+
+/// index of the lowest set bit (the mask must not be 0)
+inline uint32_t lowestBit(const uint64_t mask) noexcept
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return static_cast<uint32_t>(index);
+#elif defined(_MSC_VER)
+    unsigned long index;
+    if (_BitScanForward(&index, static_cast<unsigned long>(mask)))
+    {
+        return static_cast<uint32_t>(index);
+    }
+    _BitScanForward(&index, static_cast<unsigned long>(mask >> 32));
+    return static_cast<uint32_t>(index + 32);
+#else
+    return static_cast<uint32_t>(__builtin_ctzll(mask));
+#endif
+}
+
+/// index of the highest set bit (the mask must not be 0)
+inline uint32_t highestBit(const uint32_t mask) noexcept
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse(&index, static_cast<unsigned long>(mask));
+    return static_cast<uint32_t>(index);
+#else
+    return static_cast<uint32_t>(31 - __builtin_clz(mask));
+#endif
+}
+
+/// count of the set bits
+inline uint32_t popCount(uint64_t mask) noexcept
+{
+#if defined(_MSC_VER)
+    mask -= ((mask >> 1) & 0x5555555555555555ull);
+    mask = ((mask & 0x3333333333333333ull) + ((mask >> 2) & 0x3333333333333333ull));
+    return static_cast<uint32_t>((((mask + (mask >> 4)) & 0x0f0f0f0f0f0f0f0full) * 0x0101010101010101ull) >> 56);
+#else
+    return static_cast<uint32_t>(__builtin_popcountll(mask));
+#endif
+}
+
+/// inclusive prefix-XOR (each bit becomes the parity of itself and all the lower bits)
+inline uint64_t prefixXor(uint64_t mask) noexcept
+{
+    mask ^= (mask << 1);
+    mask ^= (mask << 2);
+    mask ^= (mask << 4);
+    mask ^= (mask << 8);
+    mask ^= (mask << 16);
+    mask ^= (mask << 32);
+    return mask;
+}
+
+// ==== byte order functions ====
+
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+constexpr bool kHostLE = false;
+#else
+constexpr bool kHostLE = true;
+#endif
+
+inline uint16_t byteSwap16(const uint16_t value) noexcept
+{
+#if defined(_MSC_VER)
+    return _byteswap_ushort(value);
+#else
+    return __builtin_bswap16(value);
+#endif
+}
+
+inline uint32_t byteSwap32(const uint32_t value) noexcept
+{
+#if defined(_MSC_VER)
+    return _byteswap_ulong(value);
+#else
+    return __builtin_bswap32(value);
+#endif
+}
+
+inline uint64_t byteSwap64(const uint64_t value) noexcept
+{
+#if defined(_MSC_VER)
+    return _byteswap_uint64(value);
+#else
+    return __builtin_bswap64(value);
+#endif
+}
+
+/// big endian 64-bit word (the source need not be aligned)
+inline uint64_t loadBE64(const uint8_t* const src) noexcept
+{
+    uint64_t word;
+    memcpy(&word, src, sizeof(word));
+    return (kHostLE ? byteSwap64(word) : word);
+}
+
+/// 16-bit code-unit in the byte order given (the source need not be aligned)
+inline uint16_t load16(const uint8_t* const src, const bool le) noexcept
+{
+    uint16_t value;
+    memcpy(&value, src, sizeof(value));
+    return ((le == kHostLE) ? value : byteSwap16(value));
+}
+
+/// 32-bit code-unit in the byte order given (the source need not be aligned)
+inline uint32_t load32(const uint8_t* const src, const bool le) noexcept
+{
+    uint32_t value;
+    memcpy(&value, src, sizeof(value));
+    return ((le == kHostLE) ? value : byteSwap32(value));
+}
+
+/// 4 16-bit code-units in the byte order given (the lanes are in host order)
+inline uint64_t loadUnits16(const uint8_t* const src, const bool le) noexcept
+{
+    uint64_t word;
+    memcpy(&word, src, sizeof(word));
+    return ((le == kHostLE) ? word : (((word >> 8) & 0x00ff00ff00ff00ffull) | ((word & 0x00ff00ff00ff00ffull) << 8)));
+}
+
+/// 2 32-bit code-units in the byte order given (the lanes are in host order)
+inline uint64_t loadUnits32(const uint8_t* const src, const bool le) noexcept
+{
+    uint64_t word;
+    memcpy(&word, src, sizeof(word));
+    return ((le == kHostLE) ? word : ((static_cast<uint64_t>(byteSwap32(static_cast<uint32_t>(word >> 32))) << 32) | byteSwap32(static_cast<uint32_t>(word))));
+}
+
+/// check for a surrogate (0xd800 to 0xdfff) in any of the 4 code-units of a loadUnits16() word
+inline bool hasSurrogate16(const uint64_t word) noexcept
+{   //  the surrogate lanes become 0, a zero lane test has no false positives
+    const uint64_t lanes = ((word & 0xf800f800f800f800ull) ^ 0xd800d800d800d800ull);
+    return (((lanes - 0x0001000100010001ull) & ~lanes & 0x8000800080008000ull) != 0);
+}
+
+/// check for a surrogate (0x0000d800 to 0x0000dfff) in either of the 2 code-units of a loadUnits32() word
+inline bool hasSurrogate32(const uint64_t word) noexcept
+{
+    const uint64_t lanes = ((word & 0xfffff800fffff800ull) ^ 0x0000d8000000d800ull);
+    return (((lanes - 0x0000000100000001ull) & ~lanes & 0x8000000080000000ull) != 0);
+}
+
+};  //  namespace simd
+
+};  //  namespace utf
+
+};  //  namespace unicode
+
+#endif  //  #ifndef __UTF_SIMD_INCLUDED__
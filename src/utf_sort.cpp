@@ -0,0 +1,557 @@
+
+//  SuiteUTF
+//  Original design 20102016; maintained and extended 20242025.
+//  Copyright (c) 20102025 Ritchie Brannan.
+//  MIT License. See LICENSE.txt. Project history: docs/History.md.
+//
+//  File:   utf_sort.cpp
+//  Author: Ritchie Brannan
+//  Date:   18 Oct 26
+//  
+//  Description:
+//  
+//      Code-point order radix sort of arrays of encoded strings.
+
+#include "utf_sort.h"
+#include "unicode_utilities.h"
+#include "utf_simd.h"
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <type_traits>
+
+namespace unicode
+{
+
+namespace utf
+{
+
+namespace sort
+{
+
+using toolkit::IUTFTK;
+using toolkit::UTF_SUB_TYPE;
+
+namespace internal
+{
+
+/// internal key byte mapping of a sub-type
+enum class KeyMap : uint8_t
+{
+    Bytes = 0,  //  the bytes
+    JavaUTF8,   //  the bytes, the C0 of a C0 80 null is mapped to 00
+    CESU8,      //  the bytes, the ED lead of a surrogate is mapped to F8
+    JavaCESU8,  //  the bytes, with both of the mappings
+    UTF16le,    //  big endian code-units, surrogates moved above 0xffff
+    UTF16be,
+    UCS2le,     //  big endian code-units
+    UCS2be,
+    UTF32le,    //  big endian code-units
+    UTF32be,
+    CESU32le,   //  big endian code-units, surrogates moved above 0x10ffff
+    CESU32be,
+    CP1252,     //  big endian 16-bit code-points
+    Unsupported
+};
+
+/// internal sort entry (the cached key prefix and the text view)
+struct sort_entry
+{
+    uint64_t    prefix;     //  8 key bytes of the current block (big endian, 0 padded)
+    utf_text    text;
+};
+
+static_assert(sizeof(sort_entry) <= kScratchPerText, "the sort entry does not fit the scratch memory");
+
+/// internal bucket size below which a range is insertion sorted
+constexpr uint32_t kInsertionLimit = 24;
+
+/// internal count below which the threaded sort runs on the calling thread
+constexpr uint32_t kParallelLimit = 65536;
+
+inline [[nodiscard]] KeyMap getKeyMap(const IUTFTK& handler) noexcept
+{
+    switch (handler.utfSubType())
+    {
+        case UTF_SUB_TYPE::UTF8:
+        case UTF_SUB_TYPE::UTF8ns:
+        case UTF_SUB_TYPE::UTF8st:
+        case UTF_SUB_TYPE::BYTE:
+        case UTF_SUB_TYPE::BYTEns:
+        case UTF_SUB_TYPE::ASCII:
+        case UTF_SUB_TYPE::ASCIIns:
+            return KeyMap::Bytes;
+        case UTF_SUB_TYPE::JUTF8:
+        case UTF_SUB_TYPE::JUTF8ns:
+        case UTF_SUB_TYPE::JUTF8st:
+            return KeyMap::JavaUTF8;
+        case UTF_SUB_TYPE::CESU8:
+        case UTF_SUB_TYPE::CESU8ns:
+        case UTF_SUB_TYPE::CESU8st:
+            return KeyMap::CESU8;
+        case UTF_SUB_TYPE::JCESU8:
+        case UTF_SUB_TYPE::JCESU8ns:
+        case UTF_SUB_TYPE::JCESU8st:
+            return KeyMap::JavaCESU8;
+        case UTF_SUB_TYPE::UTF16le: return KeyMap::UTF16le;
+        case UTF_SUB_TYPE::UTF16be: return KeyMap::UTF16be;
+        case UTF_SUB_TYPE::UCS2le:  return KeyMap::UCS2le;
+        case UTF_SUB_TYPE::UCS2be:  return KeyMap::UCS2be;
+        case UTF_SUB_TYPE::UTF32le:
+        case UTF_SUB_TYPE::UCS4le:
+            return KeyMap::UTF32le;
+        case UTF_SUB_TYPE::UTF32be:
+        case UTF_SUB_TYPE::UCS4be:
+            return KeyMap::UTF32be;
+        case UTF_SUB_TYPE::CESU32le:
+        case UTF_SUB_TYPE::CESU4le:
+            return KeyMap::CESU32le;
+        case UTF_SUB_TYPE::CESU32be:
+        case UTF_SUB_TYPE::CESU4be:
+            return KeyMap::CESU32be;
+        case UTF_SUB_TYPE::CP1252:
+        case UTF_SUB_TYPE::CP1252ns:
+        case UTF_SUB_TYPE::CP1252st:
+            return KeyMap::CP1252;
+        default:
+            return KeyMap::Unsupported;
+    }
+}
+
+inline [[nodiscard]] bool isValidView(const utf_text& text) noexcept
+{
+    return ((text.offset <= text.length) && ((text.buffer != nullptr) || (text.length == 0)));
+}
+
+/// internal key of a text view (the unread bytes and the key length, which is twice the byte count for CP1252)
+template <KeyMap Map>
+struct text_key
+{
+    explicit text_key(const utf_text& text) noexcept :
+        data(&text.buffer[text.offset]), size(text.length - text.offset),
+        length((Map == KeyMap::CP1252) ? (static_cast<uint64_t>(size) << 1) : size) {}
+    [[nodiscard]] uint32_t byteAt(const uint64_t position) const noexcept;
+    [[nodiscard]] uint64_t prefixAt(const uint64_t position) const noexcept;
+    const uint8_t*  data;
+    uint32_t        size;
+    uint64_t        length;
+};
+
+/// internal UTF16 code-unit with the surrogates moved above 0xffff (0xe000 to 0xffff move down to 0xd800)
+inline [[nodiscard]] uint32_t remapUTF16(const uint32_t unit) noexcept
+{
+    return ((unit < 0xd800u) ? unit : ((unit < 0xe000u) ? (unit + 0x2000u) : (unit - 0x0800u)));
+}
+
+/// internal CESU32 code-unit with the surrogates moved above 0x10ffff
+inline [[nodiscard]] uint32_t remapCESU32(const uint32_t unit) noexcept
+{
+    return (((unit & 0xfffff800u) == 0x0000d800u) ? (unit + (0x00110000u - 0x0000d800u)) : unit);
+}
+
+/// internal key byte at a position (the position must be less than the key length)
+template <KeyMap Map>
+uint32_t text_key<Map>::byteAt(const uint64_t position) const noexcept
+{
+    const uint32_t index = static_cast<uint32_t>((Map == KeyMap::CP1252) ? (position >> 1) : position);
+    const uint32_t byte = data[index];
+    switch (Map)
+    {
+        case KeyMap::JavaUTF8:
+            return (((byte == 0xc0u) && ((index + 1) < size) && (data[index + 1] == 0x80u)) ? 0 : byte);
+        case KeyMap::CESU8:
+            return (((byte == 0xedu) && ((index + 1) < size) && (data[index + 1] >= 0xa0u)) ? 0xf8u : byte);
+        case KeyMap::JavaCESU8:
+            if ((index + 1) < size)
+            {
+                if ((byte == 0xc0u) && (data[index + 1] == 0x80u))
+                {
+                    return 0;
+                }
+                if ((byte == 0xedu) && (data[index + 1] >= 0xa0u))
+                {
+                    return 0xf8u;
+                }
+            }
+            return byte;
+        case KeyMap::UTF16le:
+        case KeyMap::UTF16be:
+        case KeyMap::UCS2le:
+        case KeyMap::UCS2be:
+        {
+            const uint32_t start = (index & ~1u);
+            if ((start + 2) > size)
+            {   //  trailing partial code-unit
+                return byte;
+            }
+            uint32_t unit = simd::load16(&data[start], ((Map == KeyMap::UTF16le) || (Map == KeyMap::UCS2le)));
+            if ((Map == KeyMap::UTF16le) || (Map == KeyMap::UTF16be))
+            {
+                unit = remapUTF16(unit);
+            }
+            return ((index & 1) ? (unit & 0xffu) : (unit >> 8));
+        }
+        case KeyMap::UTF32le:
+        case KeyMap::UTF32be:
+        case KeyMap::CESU32le:
+        case KeyMap::CESU32be:
+        {
+            const uint32_t start = (index & ~3u);
+            if ((start + 4) > size)
+            {   //  trailing partial code-unit
+                return byte;
+            }
+            uint32_t unit = simd::load32(&data[start], ((Map == KeyMap::UTF32le) || (Map == KeyMap::CESU32le)));
+            if ((Map == KeyMap::CESU32le) || (Map == KeyMap::CESU32be))
+            {
+                unit = remapCESU32(unit);
+            }
+            return ((unit >> (24 - ((index & 3) << 3))) & 0xffu);
+        }
+        case KeyMap::CP1252:
+        {
+            unicode_t unicode = static_cast<unicode_t>(byte);
+            (void)cp1252ToUnicode(static_cast<uint8_t>(byte), unicode);
+            return ((position & 1) ? (static_cast<uint32_t>(unicode) & 0xffu) : ((static_cast<uint32_t>(unicode) >> 8) & 0xffu));
+        }
+        default:
+            return byte;
+    }
+}
+
+/// internal 8 key bytes from a position (big endian, 0 padded past the end of the key)
+template <KeyMap Map>
+uint64_t text_key<Map>::prefixAt(const uint64_t position) const noexcept
+{
+    if ((Map == KeyMap::Bytes) && ((position + 8) <= length))
+    {
+        return simd::loadBE64(&data[position]);
+    }
+    uint64_t prefix = 0;
+    for (uint32_t index = 0; index < 8; ++index)
+    {
+        prefix <<= 8;
+        if ((position + index) < length)
+        {
+            prefix |= byteAt(position + index);
+        }
+    }
+    return prefix;
+}
+
+/// internal comparison of two entries with equal keys before the block of depth (the prefixes are for that block)
+template <KeyMap Map>
+[[nodiscard]] int compareEntries(const sort_entry& lhs, const sort_entry& rhs, const uint64_t depth) noexcept
+{
+    if (lhs.prefix != rhs.prefix)
+    {   //  a key which ends in the block is 0 padded, so it orders before any longer key
+        return ((lhs.prefix < rhs.prefix) ? -1 : 1);
+    }
+    const text_key<Map> left(lhs.text);
+    const text_key<Map> right(rhs.text);
+    for (uint64_t position = ((depth & ~7ull) + 8); (position < left.length) && (position < right.length); ++position)
+    {
+        const uint32_t a = left.byteAt(position);
+        const uint32_t b = right.byteAt(position);
+        if (a != b)
+        {
+            return ((a < b) ? -1 : 1);
+        }
+    }
+    return ((left.length < right.length) ? -1 : ((left.length > right.length) ? 1 : 0));
+}
+
+/// internal radix digit of an entry at depth (0 if the key has ended, otherwise 1 + the key byte)
+template <KeyMap Map>
+inline [[nodiscard]] uint32_t getDigit(const sort_entry& entry, const uint64_t depth) noexcept
+{
+    return ((depth < text_key<Map>(entry.text).length) ? (1 + static_cast<uint32_t>((entry.prefix >> (56 - ((depth & 7) << 3))) & 0xffu)) : 0);
+}
+
+/// internal prefix fill at the start of a block (returns true if every key continues past the block with equal prefixes)
+template <KeyMap Map>
+[[nodiscard]] bool fillPrefixes(sort_entry* const entries, const uint32_t count, const uint64_t depth) noexcept
+{
+    bool shared = true;
+    for (uint32_t index = 0; index < count; ++index)
+    {
+        const text_key<Map> key(entries[index].text);
+        entries[index].prefix = key.prefixAt(depth);
+        shared = (shared && ((depth + 8) < key.length) && (entries[index].prefix == entries[0].prefix));
+    }
+    return shared;
+}
+
+template <KeyMap Map>
+void insertionSort(sort_entry* const entries, const uint32_t count, const uint64_t depth) noexcept
+{
+    for (uint32_t index = 1; index < count; ++index)
+    {
+        const sort_entry entry = entries[index];
+        uint32_t slot = index;
+        while ((slot > 0) && (compareEntries<Map>(entry, entries[slot - 1], depth) < 0))
+        {
+            entries[slot] = entries[slot - 1];
+            --slot;
+        }
+        entries[slot] = entry;
+    }
+}
+
+/// internal radix partition of a range (returns false if the keys are all equal)
+///
+///     Key bytes shared by the whole range are skipped, depth is advanced to the byte the range was partitioned on
+///     and starts[] is set to the bucket boundaries (bucket 0 holds the keys which end before that byte).
+///
+template <KeyMap Map>
+[[nodiscard]] bool partition(sort_entry* const entries, const uint32_t count, uint64_t& depth, uint32_t (&starts)[258]) noexcept
+{
+    for (;;)
+    {
+        if (((depth & 7) == 0) && fillPrefixes<Map>(entries, count, depth))
+        {
+            depth += 8;
+            continue;
+        }
+        uint32_t counts[257] = {};
+        for (uint32_t index = 0; index < count; ++index)
+        {
+            ++counts[getDigit<Map>(entries[index], depth)];
+        }
+        if (counts[0] == count)
+        {
+            return false;
+        }
+        if (counts[getDigit<Map>(entries[0], depth)] == count)
+        {   //  one bucket
+            ++depth;
+            continue;
+        }
+        starts[0] = 0;
+        for (uint32_t digit = 0; digit < 257; ++digit)
+        {
+            starts[digit + 1] = (starts[digit] + counts[digit]);
+        }
+        uint32_t next[257];
+        for (uint32_t digit = 0; digit < 257; ++digit)
+        {
+            next[digit] = starts[digit];
+        }
+        for (uint32_t digit = 0; digit < 257; ++digit)
+        {   //  in-place permutation (each swap places one entry in its bucket)
+            while (next[digit] < starts[digit + 1])
+            {
+                sort_entry entry = entries[next[digit]];
+                uint32_t target = getDigit<Map>(entry, depth);
+                while (target != digit)
+                {
+                    const sort_entry swapped = entries[next[target]];
+                    entries[next[target]++] = entry;
+                    entry = swapped;
+                    target = getDigit<Map>(entry, depth);
+                }
+                entries[next[digit]++] = entry;
+            }
+        }
+        return true;
+    }
+}
+
+/// internal sort of a range in which the keys are equal before depth
+template <KeyMap Map>
+void sortRange(sort_entry* entries, uint32_t count, uint64_t depth) noexcept
+{
+    uint32_t starts[258];
+    while (count > 1)
+    {
+        if (count <= kInsertionLimit)
+        {
+            if ((depth & 7) == 0)
+            {
+                (void)fillPrefixes<Map>(entries, count, depth);
+            }
+            insertionSort<Map>(entries, count, depth);
+            return;
+        }
+        if (!partition<Map>(entries, count, depth, starts))
+        {
+            return;
+        }
+        uint32_t largest = 1;
+        for (uint32_t digit = 2; digit < 257; ++digit)
+        {
+            if ((starts[digit + 1] - starts[digit]) > (starts[largest + 1] - starts[largest]))
+            {
+                largest = digit;
+            }
+        }
+        for (uint32_t digit = 1; digit < 257; ++digit)
+        {   //  the smaller buckets are sorted recursively and the largest bucket iteratively
+            if ((digit != largest) && ((starts[digit + 1] - starts[digit]) > 1))
+            {
+                sortRange<Map>(&entries[starts[digit]], (starts[digit + 1] - starts[digit]), (depth + 1));
+            }
+        }
+        entries = &entries[starts[largest]];
+        count = (starts[largest + 1] - starts[largest]);
+        ++depth;
+    }
+}
+
+/// internal threaded sort (the first level buckets are shared between the threads, largest first)
+template <KeyMap Map>
+void sortParallel(sort_entry* const entries, const uint32_t count, const uint32_t threads)
+{
+    uint64_t depth = 0;
+    uint32_t starts[258];
+    if (!partition<Map>(entries, count, depth, starts))
+    {
+        return;
+    }
+    uint32_t order[256];
+    for (uint32_t index = 0; index < 256; ++index)
+    {   //  insertion sort of the buckets by size, largest first
+        const uint32_t digit = (index + 1);
+        const uint32_t size = (starts[digit + 1] - starts[digit]);
+        uint32_t slot = index;
+        while ((slot > 0) && ((starts[order[slot - 1] + 1] - starts[order[slot - 1]]) < size))
+        {
+            order[slot] = order[slot - 1];
+            --slot;
+        }
+        order[slot] = digit;
+    }
+    ::std::atomic<uint32_t> next(0);
+    auto worker = [&]() noexcept
+    {
+        for (uint32_t index = next.fetch_add(1, ::std::memory_order_relaxed); index < 256; index = next.fetch_add(1, ::std::memory_order_relaxed))
+        {
+            const uint32_t digit = order[index];
+            sortRange<Map>(&entries[starts[digit]], (starts[digit + 1] - starts[digit]), (depth + 1));
+        }
+    };
+    const uint32_t helpers = ((threads < 64) ? threads : 64) - 1;
+    ::std::thread pool[63];
+    for (uint32_t index = 0; index < helpers; ++index)
+    {
+        pool[index] = ::std::thread(worker);
+    }
+    worker();
+    for (uint32_t index = 0; index < helpers; ++index)
+    {
+        pool[index].join();
+    }
+}
+
+/// internal set up of the entries (returns false if the arguments are invalid)
+[[nodiscard]] bool prepare(const IUTFTK& handler, const utf_text* const texts, const uint32_t count, void* const scratch, const size_t size) noexcept
+{
+    if ((getKeyMap(handler) == KeyMap::Unsupported) || ((count != 0) && ((texts == nullptr) || (scratch == nullptr))) ||
+        (size < scratchSize(count)) || ((reinterpret_cast<uintptr_t>(scratch) % alignof(sort_entry)) != 0))
+    {
+        return false;
+    }
+    sort_entry* const entries = static_cast<sort_entry*>(scratch);
+    for (uint32_t index = 0; index < count; ++index)
+    {
+        if (!isValidView(texts[index]))
+        {
+            return false;
+        }
+        entries[index].prefix = 0;
+        entries[index].text = texts[index];
+    }
+    return true;
+}
+
+void finish(utf_text* const texts, const uint32_t count, const void* const scratch) noexcept
+{
+    const sort_entry* const entries = static_cast<const sort_entry*>(scratch);
+    for (uint32_t index = 0; index < count; ++index)
+    {
+        texts[index] = entries[index].text;
+    }
+}
+
+template <KeyMap Map>
+[[nodiscard]] int compareKeys(const utf_text& lhs, const utf_text& rhs) noexcept
+{
+    sort_entry left = { 0, lhs };
+    sort_entry right = { 0, rhs };
+    left.prefix = text_key<Map>(left.text).prefixAt(0);
+    right.prefix = text_key<Map>(right.text).prefixAt(0);
+    return compareEntries<Map>(left, right, 0);
+}
+
+/// internal dispatch of a function template on the key mapping
+template <typename Function>
+void dispatch(const KeyMap map, const Function& function)
+{
+    switch (map)
+    {
+        case KeyMap::JavaUTF8:  function(::std::integral_constant<KeyMap, KeyMap::JavaUTF8>()); break;
+        case KeyMap::CESU8:     function(::std::integral_constant<KeyMap, KeyMap::CESU8>()); break;
+        case KeyMap::JavaCESU8: function(::std::integral_constant<KeyMap, KeyMap::JavaCESU8>()); break;
+        case KeyMap::UTF16le:   function(::std::integral_constant<KeyMap, KeyMap::UTF16le>()); break;
+        case KeyMap::UTF16be:   function(::std::integral_constant<KeyMap, KeyMap::UTF16be>()); break;
+        case KeyMap::UCS2le:    function(::std::integral_constant<KeyMap, KeyMap::UCS2le>()); break;
+        case KeyMap::UCS2be:    function(::std::integral_constant<KeyMap, KeyMap::UCS2be>()); break;
+        case KeyMap::UTF32le:   function(::std::integral_constant<KeyMap, KeyMap::UTF32le>()); break;
+        case KeyMap::UTF32be:   function(::std::integral_constant<KeyMap, KeyMap::UTF32be>()); break;
+        case KeyMap::CESU32le:  function(::std::integral_constant<KeyMap, KeyMap::CESU32le>()); break;
+        case KeyMap::CESU32be:  function(::std::integral_constant<KeyMap, KeyMap::CESU32be>()); break;
+        case KeyMap::CP1252:    function(::std::integral_constant<KeyMap, KeyMap::CP1252>()); break;
+        default:                function(::std::integral_constant<KeyMap, KeyMap::Bytes>()); break;
+    }
+}
+
+};  //  namespace internal
+
+[[nodiscard]] bool isSortable(const IUTFTK& handler) noexcept
+{
+    return (internal::getKeyMap(handler) != internal::KeyMap::Unsupported);
+}
+
+[[nodiscard]] int compareTexts(const IUTFTK& handler, const utf_text& lhs, const utf_text& rhs) noexcept
+{
+    const utf_text empty = { 0, 0, nullptr };
+    const utf_text& left = (internal::isValidView(lhs) ? lhs : empty);
+    const utf_text& right = (internal::isValidView(rhs) ? rhs : empty);
+    int result = 0;
+    internal::dispatch(internal::getKeyMap(handler), [&](auto map) noexcept { result = internal::compareKeys<decltype(map)::value>(left, right); });
+    return result;
+}
+
+[[nodiscard]] bool sortTexts(const IUTFTK& handler, utf_text* const texts, const uint32_t count, void* const scratch, const size_t size) noexcept
+{
+    if (!internal::prepare(handler, texts, count, scratch, size))
+    {
+        return false;
+    }
+    internal::sort_entry* const entries = static_cast<internal::sort_entry*>(scratch);
+    internal::dispatch(internal::getKeyMap(handler), [&](auto map) noexcept { internal::sortRange<decltype(map)::value>(entries, count, 0); });
+    internal::finish(texts, count, scratch);
+    return true;
+}
+
+[[nodiscard]] bool sortTexts(const IUTFTK& handler, utf_text* const texts, const uint32_t count, void* const scratch, const size_t size, const uint32_t threads)
+{
+    if ((threads <= 1) || (count < internal::kParallelLimit))
+    {
+        return sortTexts(handler, texts, count, scratch, size);
+    }
+    if (!internal::prepare(handler, texts, count, scratch, size))
+    {
+        return false;
+    }
+    internal::sort_entry* const entries = static_cast<internal::sort_entry*>(scratch);
+    internal::dispatch(internal::getKeyMap(handler), [&](auto map) { internal::sortParallel<decltype(map)::value>(entries, count, threads); });
+    internal::finish(texts, count, scratch);
+    return true;
+}
+
+};  //  namespace sort
+
+};  //  namespace utf
+
+};  //  namespace unicode
@@ -49,6 +49,7 @@
 
 #include "utf_std.h"
 #include "unicode_utilities.h"
+#include "utf_simd.h"
 #include <string.h>
 
 namespace unicode
@@ -380,7 +381,7 @@ uint32_t lenCP1252(const unicode_t unicode) noexcept
     if ((buffer != nullptr) && (size >= 2))
     {
         bytes = 2;
-        unicode_t value = ((static_cast<unicode_t>(buffer[1]) << 8) + buffer[0]);
+        unicode_t value = simd::load16(buffer, true);
         if ((value & 0xfffff800u) != 0x0000d800u)
         {
             unicode = value;
@@ -388,7 +389,7 @@ uint32_t lenCP1252(const unicode_t unicode) noexcept
         }
         else if ((size >= 4) && ((value & 0xfffffc00u) == 0x0000d800u))
         {
-            unicode_t extra = ((static_cast<unicode_t>(buffer[3]) << 8) + buffer[2]);
+            unicode_t extra = simd::load16(&buffer[2], true);
             if ((extra & 0xfffffc00u) == 0x0000dc00u)
             {   //  found low surrogate (valid surrogate pair)
                 unicode = (((value & 0x000003ffu) << 10) + (extra & 0x000003ffu) + 0x00010000u);
@@ -435,7 +436,7 @@ uint32_t lenCP1252(const unicode_t unicode) noexcept
     if ((buffer != nullptr) && (size >= 2))
     {
         bytes = 2;
-        unicode_t value = ((static_cast<unicode_t>(buffer[0]) << 8) + buffer[1]);
+        unicode_t value = simd::load16(buffer, false);
         if ((value & 0xfffff800u) != 0x0000d800u)
         {
             unicode = value;
@@ -443,7 +444,7 @@ uint32_t lenCP1252(const unicode_t unicode) noexcept
         }
         else if ((size >= 4) && ((value & 0xfffffc00u) == 0x0000d800u))
         {
-            unicode_t extra = ((static_cast<unicode_t>(buffer[2]) << 8) + buffer[3]);
+            unicode_t extra = simd::load16(&buffer[2], false);
             if ((extra & 0xfffffc00u) == 0x0000dc00u)
             {   //  found low surrogate (valid surrogate pair)
                 unicode = (((value & 0x000003ffu) << 10) + (extra & 0x000003ffu) + 0x00010000u);
@@ -490,7 +491,7 @@ uint32_t lenCP1252(const unicode_t unicode) noexcept
     if ((buffer != nullptr) && (size >= 4))
     {
         bytes = 4;
-        unicode_t value = ((((((static_cast<unicode_t>(buffer[3]) << 8) + buffer[2]) << 8) + buffer[1]) << 8) + buffer[0]);
+        unicode_t value = static_cast<unicode_t>(simd::load32(buffer, true));
         if ((static_cast<uint32_t>(value) <= 0x0010ffffu) && ((value & 0xfffff800u) != 0x0000d800u))
         {
             unicode = value;
@@ -523,7 +524,7 @@ uint32_t lenCP1252(const unicode_t unicode) noexcept
     if ((buffer != nullptr) && (size >= 4))
     {
         bytes = 4;
-        unicode_t value = ((((((static_cast<unicode_t>(buffer[0]) << 8) + buffer[1]) << 8) + buffer[2]) << 8) + buffer[3]);
+        unicode_t value = static_cast<unicode_t>(simd::load32(buffer, false));
         if ((static_cast<uint32_t>(value) <= 0x0010ffffu) && ((value & 0xfffff800u) != 0x0000d800u))
         {
             unicode = value;
@@ -615,11 +616,11 @@ uint32_t strlenUTF16le(const uint8_t* const buffer) noexcept
     if (buffer != nullptr)
     {
         uint16_t value = 0;
-        for (uint32_t index = 0; (value = ((static_cast<uint16_t>(buffer[index + 1]) << 8) + buffer[index + 0])) != 0; index += 2)
+        for (uint32_t index = 0; (value = simd::load16(&buffer[index], true)) != 0; index += 2)
         {
             if ((value & 0xfc00u) == 0xd800u)
             {
-                value = ((static_cast<uint16_t>(buffer[index + 3]) << 8) + buffer[index + 2]);
+                value = simd::load16(&buffer[index + 2], true);
                 if ((value & 0xfc00u) == 0xdc00u)
                 {
                     index += 2;
@@ -637,11 +638,11 @@ uint32_t strlenUTF16be(const uint8_t* const buffer) noexcept
     if (buffer != nullptr)
     {
         uint16_t value = 0;
-        for (uint32_t index = 0; (value = ((static_cast<uint16_t>(buffer[index + 0]) << 8) + buffer[index + 1])) != 0; index += 2)
+        for (uint32_t index = 0; (value = simd::load16(&buffer[index], false)) != 0; index += 2)
         {
             if ((value & 0xfc00u) == 0xd800u)
             {
-                value = ((static_cast<uint16_t>(buffer[index + 2]) << 8) + buffer[index + 3]);
+                value = simd::load16(&buffer[index + 2], false);
                 if ((value & 0xfc00u) == 0xdc00u)
                 {
                     index += 2;
@@ -694,10 +695,17 @@ uint32_t strlenUTF16le(const uint8_t* const buffer, const uint32_t size) noexcep
         uint32_t index = 0;
         for (uint32_t limit = size; limit >= 2; limit -= 2)
         {
-            uint16_t value = ((static_cast<uint16_t>(buffer[index + 1]) << 8) + buffer[index + 0]);
+            if ((limit >= 8) && !simd::hasSurrogate16(simd::loadUnits16(&buffer[index], true)))
+            {   //  4 code-units without surrogates
+                index += 8;
+                limit -= 6;
+                count += 4;
+                continue;
+            }
+            uint16_t value = simd::load16(&buffer[index], true);
             if (((value & 0xfc00u) == 0xd800u) && (limit >= 4))
             {
-                value = ((static_cast<uint16_t>(buffer[index + 3]) << 8) + buffer[index + 2]);
+                value = simd::load16(&buffer[index + 2], true);
                 if ((value & 0xfc00u) == 0xdc00u)
                 {
                     index += 2;
@@ -719,10 +727,17 @@ uint32_t strlenUTF16be(const uint8_t* const buffer, const uint32_t size) noexcep
         uint32_t index = 0;
         for (uint32_t limit = size; limit >= 2; limit -= 2)
         {
-            uint16_t value = ((static_cast<uint16_t>(buffer[index + 0]) << 8) + buffer[index + 1]);
+            if ((limit >= 8) && !simd::hasSurrogate16(simd::loadUnits16(&buffer[index], false)))
+            {   //  4 code-units without surrogates
+                index += 8;
+                limit -= 6;
+                count += 4;
+                continue;
+            }
+            uint16_t value = simd::load16(&buffer[index], false);
             if (((value & 0xfc00u) == 0xd800u) && (limit >= 4))
             {
-                value = ((static_cast<uint16_t>(buffer[index + 2]) << 8) + buffer[index + 3]);
+                value = simd::load16(&buffer[index + 2], false);
                 if ((value & 0xfc00u) == 0xdc00u)
                 {
                     index += 2;
@@ -904,6 +919,16 @@ uint32_t strsizeUTF8fromUTF16le(const uint8_t* const buffer, const uint32_t size
         unicode_t unicode = 0;
         for (uint32_t index = 0; index < size; index += bytes)
         {
+            if ((limit >= 8) && !simd::hasSurrogate16(simd::loadUnits16(&buffer[index], true)))
+            {   //  4 code-units without surrogates
+                for (uint32_t unit = 0; unit < 8; unit += 2)
+                {
+                    needs += lenUTF8(simd::load16(&buffer[index + unit], true), use_java);
+                }
+                bytes = 8;
+                limit -= 8;
+                continue;
+            }
             if (getUTF16le(&buffer[index], limit, unicode, bytes))
             {
                 needs += lenUTF8(unicode, use_java);
@@ -928,6 +953,16 @@ uint32_t strsizeUTF8fromUTF16be(const uint8_t* const buffer, const uint32_t size
         unicode_t unicode = 0;
         for (uint32_t index = 0; index < size; index += bytes)
         {
+            if ((limit >= 8) && !simd::hasSurrogate16(simd::loadUnits16(&buffer[index], false)))
+            {   //  4 code-units without surrogates
+                for (uint32_t unit = 0; unit < 8; unit += 2)
+                {
+                    needs += lenUTF8(simd::load16(&buffer[index + unit], false), use_java);
+                }
+                bytes = 8;
+                limit -= 8;
+                continue;
+            }
             if (getUTF16be(&buffer[index], limit, unicode, bytes))
             {
                 needs += lenUTF8(unicode, use_java);
@@ -77,6 +77,8 @@
 
 #include "utf_toolkit.h"
 #include "unicode_utilities.h"
+#include "utf_simd.h"
+#include <atomic>
 
 namespace unicode
 {
@@ -191,12 +193,29 @@ namespace internal
 
 //  Notes:
 //  
-//  These are helper functions for the backUTF8() and skipUTF8() functions.
+//  These are helper functions for the backUTF8() and stepUTF8() functions.
 //  
 //  The bytes parameter is the number of bytes of qualifying code-point found.
 //  The extra parameter is the number of invalid or illegal bytes following the code-point.
+//  
+//  The scans are bounded so that the total work of any sequence of backUTF8() and stepUTF8() calls is linear in the
+//  bytes skipped, even for long runs of continuation bytes:
+//  
+//      The step functions return as soon as a code-point is found (extra is 0), the invalid bytes which follow it
+//      are counted by the next call. Only the continuation bytes which can belong to the code-point are scanned.
+//  
+//      When bounded is true (invalid bytes are counted individually) at most kScanLimitUTF8 invalid bytes are
+//      counted per call. The back functions then stop scanning for a lead byte after kScanLimitUTF8 bytes, as a
+//      code-point (including a CESU surrogate pair) never extends more than kMaxSeqUTF8 bytes past its lead byte,
+//      the last (kScanLimitUTF8 - kMaxSeqUTF8) bytes scanned are invalid whatever precedes them.
+//  
+//      When bounded is false (a run of invalid bytes is coalesced into a single code-point) the whole run is scanned,
+//      but the whole run is also skipped. The strict functions are always bounded.
+
+constexpr uint32_t kMaxSeqUTF8 = 6;
+constexpr uint32_t kScanLimitUTF8 = 12;
 
-void backSeqUTF8(const uint8_t* const buffer, const uint32_t offset, const uint32_t limit, uint32_t& bytes, uint32_t& extra, const bool use_cesu) noexcept
+void backSeqUTF8(const uint8_t* const buffer, const uint32_t offset, const uint32_t limit, uint32_t& bytes, uint32_t& extra, const bool use_cesu, const bool bounded) noexcept
 {
     bytes = extra = 0;
     uint32_t check = 0;
@@ -204,6 +223,11 @@ void backSeqUTF8(const uint8_t* const buffer, const uint32_t offset, const uint3
     uint32_t index = offset;
     while (limit > count)
     {
+        if (bounded && (count == kScanLimitUTF8))
+        {   //  no lead byte close enough for the last bytes scanned to belong to its code-point
+            extra = (kScanLimitUTF8 - kMaxSeqUTF8);
+            return;
+        }
         --index;
         ++count;
         uint8_t byte = buffer[index];
@@ -333,28 +357,21 @@ void backSeqUTF8(const uint8_t* const buffer, const uint32_t offset, const uint3
     extra = count;
 }
 
-void stepSeqUTF8(const uint8_t* const buffer, const uint32_t offset, const uint32_t limit, uint32_t& bytes, uint32_t& extra, const bool use_cesu) noexcept
+void stepSeqUTF8(const uint8_t* const buffer, const uint32_t offset, const uint32_t limit, uint32_t& bytes, uint32_t& extra, const bool use_cesu, const bool bounded) noexcept
 {
     bytes = extra = 0;
-    uint32_t count = 0;
-    uint32_t index = offset;
     if (limit)
     {
-        uint8_t byte = buffer[index];
-        ++count;
-        ++index;
+        const uint8_t* const data = (buffer + offset);
+        uint8_t byte = data[0];
         if (((byte & 0xc0u) != 0x80u) && (byte <= 0xfdu))
-        {   //  sequence starts with a lead byte
-            while (limit > count)
+        {   //  sequence starts with a lead byte (only the continuation bytes which can belong to the sequence are scanned)
+            const uint32_t scan = ((limit < kMaxSeqUTF8) ? limit : kMaxSeqUTF8);
+            uint32_t check = 1;
+            while ((check < scan) && ((data[check] & 0xc0u) == 0x80u))
             {
-                if ((buffer[index] & 0xc0u) != 0x80u)
-                {   //  found end of continuation bytes
-                    break;
-                }
-                ++count;
-                ++index;
+                ++check;
             }
-            uint32_t check = count;
             if (use_cesu)
             {   //  cesu
                 bytes = check;
@@ -364,7 +381,7 @@ void stepSeqUTF8(const uint8_t* const buffer, const uint32_t offset, const uint3
                 }
                 else if (byte <= 0xdfu)
                 {
-                    if (limit >= 2)
+                    if (check >= 2)
                     {
                         bytes = 2;
                     }
@@ -376,7 +393,7 @@ void stepSeqUTF8(const uint8_t* const buffer, const uint32_t offset, const uint3
                     {
                         if (check >= 3)
                         {
-                            high_surrogate = (byte == 0xedu) && ((buffer[1] & 0xf0u) == 0xa0u);
+                            high_surrogate = (byte == 0xedu) && ((data[1] & 0xf0u) == 0xa0u);
                             bytes = 3;
                         }
                     }
@@ -384,7 +401,7 @@ void stepSeqUTF8(const uint8_t* const buffer, const uint32_t offset, const uint3
                     {
                         if (check >= 4)
                         {
-                            high_surrogate = (byte == 0xf0u) && (buffer[1] == 0x8du) && ((buffer[2] & 0xf0u) == 0xa0u);
+                            high_surrogate = (byte == 0xf0u) && (data[1] == 0x8du) && ((data[2] & 0xf0u) == 0xa0u);
                             bytes = 4;
                         }
                     }
@@ -392,7 +409,7 @@ void stepSeqUTF8(const uint8_t* const buffer, const uint32_t offset, const uint3
                     {
                         if (check >= 5)
                         {
-                            high_surrogate = (byte == 0xf8u) && (buffer[2] == 0x8du) && ((buffer[3] & 0xf0u) == 0xa0u);
+                            high_surrogate = (byte == 0xf8u) && (data[2] == 0x8du) && ((data[3] & 0xf0u) == 0xa0u);
                             bytes = 5;
                         }
                     }
@@ -400,7 +417,7 @@ void stepSeqUTF8(const uint8_t* const buffer, const uint32_t offset, const uint3
                     {
                         if (check >= 6)
                         {
-                            high_surrogate = (byte == 0xfcu) && (buffer[3] == 0x8du) && ((buffer[4] & 0xf0u) == 0xa0u);
+                            high_surrogate = (byte == 0xfcu) && (data[3] == 0x8du) && ((data[4] & 0xf0u) == 0xa0u);
                             bytes = 6;
                         }
                     }
@@ -408,20 +425,21 @@ void stepSeqUTF8(const uint8_t* const buffer, const uint32_t offset, const uint3
                     {
                         check = (limit - bytes);
                         if (check >= 3)
-                        {   //  a high surrogate is possible
-                            const uint8_t* const verify = (buffer + bytes);
+                        {   //  a low surrogate is possible
+                            const uint8_t* const verify = (data + bytes);
+                            uint32_t low = 0;
                             switch (verify[0])
                             {
                                 case(0xedu):
                                 {
-                                    extra = 3;
+                                    low = 3;
                                     break;
                                 }
                                 case(0xf0u):
                                 {
                                     if ((check >= 4) && (verify[1] == 0x8du))
                                     {
-                                        extra = 4;
+                                        low = 4;
                                     }
                                     break;
                                 }
@@ -429,7 +447,7 @@ void stepSeqUTF8(const uint8_t* const buffer, const uint32_t offset, const uint3
                                 {
                                     if ((check >= 5) && ((verify[1] & 0xc0u) == 0x80u) && (verify[2] == 0x8du))
                                     {
-                                        extra = 5;
+                                        low = 5;
                                     }
                                     break;
                                 }
@@ -437,7 +455,7 @@ void stepSeqUTF8(const uint8_t* const buffer, const uint32_t offset, const uint3
                                 {
                                     if ((check >= 6) && ((verify[1] & 0xc0u) == 0x80u) && ((verify[2] & 0xc0u) == 0x80u) && (verify[3] == 0x8du))
                                     {
-                                        extra = 6;
+                                        low = 6;
                                     }
                                     break;
                                 }
@@ -446,14 +464,9 @@ void stepSeqUTF8(const uint8_t* const buffer, const uint32_t offset, const uint3
                                     break;
                                 }
                             }
-                            if (extra)
+                            if (low && ((verify[low - 2] & 0xf0u) == 0xb0u) && ((verify[low - 1] & 0xc0u) == 0x80u))
                             {
-                                if (((verify[extra - 2] & 0xf0u) == 0xb0u) && ((verify[extra - 1] & 0xc0u) == 0x80u))
-                                {
-                                    bytes += extra;
-                                    count += extra;
-                                    index += extra;
-                                }
+                                bytes += low;
                             }
                         }
                     }
@@ -475,19 +488,22 @@ void stepSeqUTF8(const uint8_t* const buffer, const uint32_t offset, const uint3
                 }
                 if (bytes > check) bytes = check;
             }
-            count -= bytes;
         }
-        while (limit > count)
-        {
-            byte = buffer[index];
-            if (((byte & 0xc0u) != 0x80u) && (byte <= 0xfdu))
-            {   //  found next lead byte
-                break;
+        else
+        {   //  invalid bytes up to the next lead byte
+            const uint32_t scan = ((bounded && (limit > kScanLimitUTF8)) ? kScanLimitUTF8 : limit);
+            uint32_t count = 1;
+            while (count < scan)
+            {
+                byte = data[count];
+                if (((byte & 0xc0u) != 0x80u) && (byte <= 0xfdu))
+                {   //  found next lead byte
+                    break;
+                }
+                ++count;
             }
-            ++count;
-            ++index;
+            extra = count;
         }
-        extra = count;
     }
 }
 
@@ -499,6 +515,11 @@ void backSeqUTF8st(const uint8_t* const buffer, const uint32_t offset, const uin
     uint32_t index = offset;
     while (limit > count)
     {
+        if ((count == kScanLimitUTF8))
+        {   //  no lead byte close enough for the last bytes scanned to belong to its code-point
+            extra = (kScanLimitUTF8 - kMaxSeqUTF8);
+            return;
+        }
         --index;
         ++count;
         uint8_t byte = buffer[index];
@@ -569,20 +590,19 @@ void backSeqUTF8st(const uint8_t* const buffer, const uint32_t offset, const uin
 void stepSeqUTF8st(const uint8_t* const buffer, const uint32_t offset, const uint32_t limit, uint32_t& bytes, uint32_t& extra, const bool use_cesu, const bool use_java) noexcept
 {
     bytes = extra = 0;
-    uint32_t count = 0;
-    uint32_t index = offset;
     if (limit)
     {
-        uint8_t byte = buffer[index];
+        const uint8_t* const data = (buffer + offset);
+        uint8_t byte = data[0];
         if (((byte & 0xc0u) != 0x80u) && (byte <= 0xf7u))
         {   //  sequence starts with a lead byte
             if (byte <= 0x7fu)
             {
                 bytes = 1;
             }
-            else if ((limit >= 2) && ((buffer[1] & 0xc0u) == 0x80u))
+            else if ((limit >= 2) && ((data[1] & 0xc0u) == 0x80u))
             {
-                uint16_t leading = ((static_cast<uint16_t>(byte) << 8) | buffer[1]);
+                uint16_t leading = ((static_cast<uint16_t>(byte) << 8) | data[1]);
                 if (byte <= 0xdfu)
                 {
                     if ((leading >= 0xc280u) || (use_java && (leading == 0xc080u)))
@@ -590,7 +610,7 @@ void stepSeqUTF8st(const uint8_t* const buffer, const uint32_t offset, const uin
                         bytes = 2;
                     }
                 }
-                else if ((limit >= 3) && ((buffer[2] & 0xc0u) == 0x80u))
+                else if ((limit >= 3) && ((data[2] & 0xc0u) == 0x80u))
                 {
                     if (byte <= 0xefu)
                     {
@@ -601,15 +621,15 @@ void stepSeqUTF8st(const uint8_t* const buffer, const uint32_t offset, const uin
                                 bytes = 3;
                             }
                             else if (use_cesu && ((leading & 0xfff0u) == 0xeda0u) && (limit >= 6))
-                            {   //  using cesu and found a low surrogate and there are enough bytes for a leading high surrogate
-                                if ((buffer[3] == 0xedu) && ((buffer[4] & 0xf0u) == 0xa0u) && ((buffer[5] & 0xc0u) == 0x80u))
+                            {   //  using cesu and found a high surrogate and there are enough bytes for a following low surrogate
+                                if ((data[3] == 0xedu) && ((data[4] & 0xf0u) == 0xb0u) && ((data[5] & 0xc0u) == 0x80u))
                                 {   //  found a surrogate pair
                                     bytes = 6;
                                 }
                             }
                         }
                     }
-                    else if ((limit >= 4) && ((buffer[3] & 0xc0u) == 0x80u))
+                    else if ((limit >= 4) && ((data[3] & 0xc0u) == 0x80u))
                     {
                         if ((leading >= 0xf090u) && (leading <= 0xf48fu))
                         {   //  >= 0x00010000 and <= 0x0010ffff 
@@ -619,19 +639,21 @@ void stepSeqUTF8st(const uint8_t* const buffer, const uint32_t offset, const uin
                 }
             }
         }
-        count = (bytes ? bytes : 1);
-        index += count;
-        while (limit > count)
-        {
-            byte = buffer[index];
-            if (((byte & 0xc0u) != 0x80u) && (byte <= 0xf7u))
-            {   //  found next lead byte
-                break;
+        if (bytes == 0)
+        {   //  invalid bytes up to the next lead byte
+            const uint32_t scan = ((limit > kScanLimitUTF8) ? kScanLimitUTF8 : limit);
+            uint32_t count = 1;
+            while (count < scan)
+            {
+                byte = data[count];
+                if (((byte & 0xc0u) != 0x80u) && (byte <= 0xf7u))
+                {   //  found next lead byte
+                    break;
+                }
+                ++count;
             }
-            ++count;
-            ++index;
+            extra = count;
         }
-        extra = (count - bytes);
     }
 }
 
@@ -1229,7 +1251,7 @@ uint32_t lenUTF32(const unicode_t unicode, const bool use_cesu, const bool use_u
 
 // ==== low level code-point decoding functions ====
 
-[[nodiscard]] cp_errors decodeBYTE(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const bool use_ascii, const bool coalesce) noexcept
+[[nodiscard]] cp_errors decodeBYTE(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const bool use_ascii, const bool coalesce, const cp_errors diagnostics) noexcept
 {
     bytes = 0;
     unicode = 0;
@@ -1263,16 +1285,16 @@ uint32_t lenUTF32(const unicode_t unicode, const bool use_cesu, const bool use_u
                     bytes = count;
                 }
             }
-            else if (unicode == 0x00000000u)
+            else if ((unicode == 0x00000000u) && diagnostics.any(cp_errors::bits::DelimitString))
             {
                 errors |= cp_errors::bits::DelimitString;
             }
         }
     }
-    return errors;
+    return errors.diagnosed(diagnostics);
 }
 
-[[nodiscard]] cp_errors decodeUTF8(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const bool use_cesu, const bool use_java, const bool strict, const bool coalesce) noexcept
+[[nodiscard]] cp_errors decodeUTF8(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const bool use_cesu, const bool use_java, const bool strict, const bool coalesce, const cp_errors diagnostics) noexcept
 {
     bytes = 0;
     unicode = 0;
@@ -1292,11 +1314,11 @@ uint32_t lenUTF32(const unicode_t unicode, const bool use_cesu, const bool use_u
                 }
                 else if (unicode >= 0x0000fdd0u)
                 {
-                    if ((unicode <= 0x0000fdefu) || ((unicode & 0x0000fffeu) == 0x0000fffeu))
+                    if (diagnostics.any(cp_errors::bits::NonCharacter) && ((unicode <= 0x0000fdefu) || ((unicode & 0x0000fffeu) == 0x0000fffeu)))
                     {
                         errors |= cp_errors::bits::NonCharacter;
                     }
-                    if (unicode > 0x0000ffffu)
+                    if (diagnostics.any(cp_errors::bits::Supplementary) && (unicode > 0x0000ffffu))
                     {
                         errors |= cp_errors::bits::Supplementary;
                     }
@@ -1327,7 +1349,7 @@ uint32_t lenUTF32(const unicode_t unicode, const bool use_cesu, const bool use_u
                                     bytes += extra;
                                     errors |= check;
                                     errors ^= (cp_errors::bits::SurrogatePair | cp_errors::bits::Supplementary | cp_errors::bits::HighSurrogate);
-                                    if ((unicode & 0x0000fffeu) == 0x0000fffeu)
+                                    if (diagnostics.any(cp_errors::bits::NonCharacter) && ((unicode & 0x0000fffeu) == 0x0000fffeu))
                                     {
                                         errors |= cp_errors::bits::NonCharacter;
                                     }
@@ -1337,7 +1359,7 @@ uint32_t lenUTF32(const unicode_t unicode, const bool use_cesu, const bool use_u
                     }
                 }
             }
-            else if ((unicode == 0x00000000u) && (errors.none(cp_errors::bits::ModifiedUTF8 | cp_errors::bits::OverlongUTF8)))
+            else if ((unicode == 0x00000000u) && diagnostics.any(cp_errors::bits::DelimitString) && errors.none(cp_errors::bits::ModifiedUTF8 | cp_errors::bits::OverlongUTF8))
             {
                 errors |= cp_errors::bits::DelimitString;
             }
@@ -1357,10 +1379,10 @@ uint32_t lenUTF32(const unicode_t unicode, const bool use_cesu, const bool use_u
             bytes = 1;
         }
     }
-    return errors;
+    return errors.diagnosed(diagnostics);
 }
 
-[[nodiscard]] cp_errors decodeUTF16(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const bool le, const bool use_ucs2) noexcept
+[[nodiscard]] cp_errors decodeUTF16(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const bool le, const bool use_ucs2, const cp_errors diagnostics) noexcept
 {
     bytes = 0;
     unicode = 0;
@@ -1375,13 +1397,13 @@ uint32_t lenUTF32(const unicode_t unicode, const bool use_cesu, const bool use_u
         else
         {
             uint8_t* const buffer = &text.buffer[text.offset];
-            unicode = (le ? ((static_cast<unicode_t>(buffer[1]) << 8) + buffer[0]) : ((static_cast<unicode_t>(buffer[0]) << 8) + buffer[1]));
+            unicode = simd::load16(buffer, le);
             bytes = 2;
             if (unicode >= 0x0000d800u)
             {
                 if (unicode >= 0x0000fdd0u)
                 {
-                    if ((unicode <= 0x0000fdefu) || ((unicode & 0x0000fffeu) == 0x0000fffeu))
+                    if (diagnostics.any(cp_errors::bits::NonCharacter) && ((unicode <= 0x0000fdefu) || ((unicode & 0x0000fffeu) == 0x0000fffeu)))
                     {
                         errors |= cp_errors::bits::NonCharacter;
                     }
@@ -1404,13 +1426,13 @@ uint32_t lenUTF32(const unicode_t unicode, const bool use_cesu, const bool use_u
                             }
                             else
                             {
-                                unicode_t lowbits = (le ? ((static_cast<unicode_t>(buffer[3]) << 8) + buffer[2]) : ((static_cast<unicode_t>(buffer[2]) << 8) + buffer[3]));
+                                unicode_t lowbits = simd::load16(&buffer[2], le);
                                 if ((lowbits & 0xfffffc00u) == 0x0000dc00u)
                                 {   //  found low surrogate (valid surrogate pair)
                                     unicode = (((unicode & 0x000003ffu) << 10) + (lowbits & 0x000003ffu) + 0x00010000u);
                                     bytes = 4;
                                     errors ^= (cp_errors::bits::SurrogatePair | cp_errors::bits::Supplementary | cp_errors::bits::HighSurrogate | cp_errors::bits::IrregularForm);
-                                    if ((unicode & 0x0000fffeu) == 0x0000fffeu)
+                                    if (diagnostics.any(cp_errors::bits::NonCharacter) && ((unicode & 0x0000fffeu) == 0x0000fffeu))
                                     {
                                         errors |= cp_errors::bits::NonCharacter;
                                     }
@@ -1420,16 +1442,16 @@ uint32_t lenUTF32(const unicode_t unicode, const bool use_cesu, const bool use_u
                     }
                 }
             }
-            else if (unicode == 0x00000000u)
+            else if ((unicode == 0x00000000u) && diagnostics.any(cp_errors::bits::DelimitString))
             {
                 errors |= cp_errors::bits::DelimitString;
             }
         }
     }
-    return errors;
+    return errors.diagnosed(diagnostics);
 }
 
-[[nodiscard]] cp_errors decodeUTF32(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const bool le, const bool use_cesu, const bool use_ucs4) noexcept
+[[nodiscard]] cp_errors decodeUTF32(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const bool le, const bool use_cesu, const bool use_ucs4, const cp_errors diagnostics) noexcept
 {
     bytes = 0;
     unicode = 0;
@@ -1444,13 +1466,11 @@ uint32_t lenUTF32(const unicode_t unicode, const bool use_cesu, const bool use_u
         }
         else
         {
-            unicode = (le ?
-                ((((((static_cast<unicode_t>(buffer[3]) << 8) + buffer[2]) << 8) + buffer[1]) << 8) + buffer[0]) :
-                ((((((static_cast<unicode_t>(buffer[0]) << 8) + buffer[1]) << 8) + buffer[2]) << 8) + buffer[3]));
+            unicode = static_cast<unicode_t>(simd::load32(buffer, le));
             bytes = 4;
             if (unicode <= 0x00000000u)
             {
-                errors |= (unicode ? (cp_errors::bits::InvalidPoint | cp_errors::bits::IrregularForm) : cp_errors::bits::DelimitString);
+                errors |= (unicode ? (cp_errors::bits::InvalidPoint | cp_errors::bits::IrregularForm) : (diagnostics & cp_errors::bits::DelimitString));
             }
             else if (unicode >= 0x0000d800u)
             {
@@ -1460,11 +1480,11 @@ uint32_t lenUTF32(const unicode_t unicode, const bool use_cesu, const bool use_u
                 }
                 else if (unicode >= 0x0000fdd0u)
                 {
-                    if ((unicode <= 0x0000fdefu) || ((unicode & 0x0000fffeu) == 0x0000fffeu))
+                    if (diagnostics.any(cp_errors::bits::NonCharacter) && ((unicode <= 0x0000fdefu) || ((unicode & 0x0000fffeu) == 0x0000fffeu)))
                     {
                         errors |= cp_errors::bits::NonCharacter;
                     }
-                    if (unicode > 0x0000ffffu)
+                    if (diagnostics.any(cp_errors::bits::Supplementary) && (unicode > 0x0000ffffu))
                     {
                         errors |= cp_errors::bits::Supplementary;
                     }
@@ -1487,15 +1507,13 @@ uint32_t lenUTF32(const unicode_t unicode, const bool use_cesu, const bool use_u
                             }
                             else
                             {
-                                unicode_t lowbits = (le ?
-                                    ((((((static_cast<unicode_t>(buffer[7]) << 8) + buffer[6]) << 8) + buffer[5]) << 8) + buffer[4]) :
-                                    ((((((static_cast<unicode_t>(buffer[4]) << 8) + buffer[5]) << 8) + buffer[6]) << 8) + buffer[7]));
+                                unicode_t lowbits = static_cast<unicode_t>(simd::load32(&buffer[4], le));
                                 if ((lowbits & 0xfffffc00u) == 0x0000dc00u)
                                 {   //  found low surrogate (valid surrogate pair)
                                     unicode = (((unicode & 0x000003ffu) << 10) + (lowbits & 0x000003ffu) + 0x00010000u);
                                     bytes = 8;
                                     errors ^= (cp_errors::bits::SurrogatePair | cp_errors::bits::Supplementary | cp_errors::bits::HighSurrogate | cp_errors::bits::IrregularForm);
-                                    if ((unicode & 0x0000fffeu) == 0x0000fffeu)
+                                    if (diagnostics.any(cp_errors::bits::NonCharacter) && ((unicode & 0x0000fffeu) == 0x0000fffeu))
                                     {
                                         errors |= cp_errors::bits::NonCharacter;
                                     }
@@ -1507,10 +1525,10 @@ uint32_t lenUTF32(const unicode_t unicode, const bool use_cesu, const bool use_u
             }
         }
     }
-    return errors;
+    return errors.diagnosed(diagnostics);
 }
 
-[[nodiscard]] cp_errors decodeCP1252(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const bool strict, const bool coalesce) noexcept
+[[nodiscard]] cp_errors decodeCP1252(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const bool strict, const bool coalesce, const cp_errors diagnostics) noexcept
 {
     bytes = 0;
     unicode = 0;
@@ -1547,13 +1565,13 @@ uint32_t lenUTF32(const unicode_t unicode, const bool use_cesu, const bool use_u
                     bytes = count;
                 }
             }
-            else if (unicode == 0x00000000u)
+            else if ((unicode == 0x00000000u) && diagnostics.any(cp_errors::bits::DelimitString))
             {
                 errors |= cp_errors::bits::DelimitString;
             }
         }
     }
-    return errors;
+    return errors.diagnosed(diagnostics);
 }
 
 // ==== low level utf byte order marker and NULL code-point fast encoding functions ====
@@ -1806,7 +1824,7 @@ uint32_t backUTF8(utf_text& text, const uint32_t count, const bool use_cesu, con
             }
             else
             {
-                strict ? internal::backSeqUTF8st(buffer, offset, limit, bytes, extra, use_cesu, use_java) : internal::backSeqUTF8(buffer, offset, limit, bytes, extra, use_cesu);
+                strict ? internal::backSeqUTF8st(buffer, offset, limit, bytes, extra, use_cesu, use_java) : internal::backSeqUTF8(buffer, offset, limit, bytes, extra, use_cesu, !coalesce);
                 if (extra)
                 {
                     if (coalesce && !strict)
@@ -1870,7 +1888,7 @@ uint32_t stepUTF8(utf_text& text, const uint32_t count, const bool use_cesu, con
             }
             else
             {
-                strict ? internal::stepSeqUTF8st(buffer, offset, limit, bytes, extra, use_cesu, use_java) : internal::stepSeqUTF8(buffer, offset, limit, bytes, extra, use_cesu);
+                strict ? internal::stepSeqUTF8st(buffer, offset, limit, bytes, extra, use_cesu, use_java) : internal::stepSeqUTF8(buffer, offset, limit, bytes, extra, use_cesu, !coalesce);
                 if (bytes)
                 {
                     ++points;
@@ -1906,10 +1924,18 @@ uint32_t backUTF16(utf_text& text, const uint32_t count, const bool le, const bo
             bool pairing = false;
             while ((points < count) && (limit >= 2))
             {
+                if (((count - points) >= 4) && (limit >= 8) && !simd::hasSurrogate16(simd::loadUnits16((buffer - 8), le)))
+                {   //  4 code-units without surrogates
+                    points += 4;
+                    limit -= 8;
+                    buffer -= 8;
+                    pairing = false;
+                    continue;
+                }
                 ++points;
                 limit -= 2;
                 buffer -= 2;
-                unicode_t unicode = (le ? ((static_cast<unicode_t>(buffer[1]) << 8) + buffer[0]) : ((static_cast<unicode_t>(buffer[0]) << 8) + buffer[1]));
+                unicode_t unicode = simd::load16(buffer, le);
                 if ((unicode & 0xfffff800u) == 0x0000d800u)
                 {   //  found a surrogate
                     if ((unicode & 0x00000400u) != 0)
@@ -1954,9 +1980,17 @@ uint32_t stepUTF16(utf_text& text, const uint32_t count, const bool le, const bo
             bool pairing = false;
             while ((points < count) && (limit >= 2))
             {
+                if (((count - points) >= 4) && (limit >= 8) && !simd::hasSurrogate16(simd::loadUnits16(buffer, le)))
+                {   //  4 code-units without surrogates
+                    points += 4;
+                    limit -= 8;
+                    buffer += 8;
+                    pairing = false;
+                    continue;
+                }
                 ++points;
                 limit -= 2;
-                unicode_t unicode = (le ? ((static_cast<unicode_t>(buffer[1]) << 8) + buffer[0]) : ((static_cast<unicode_t>(buffer[0]) << 8) + buffer[1]));
+                unicode_t unicode = simd::load16(buffer, le);
                 if ((unicode & 0xfffff800u) == 0x0000d800u)
                 {   //  found a surrogate
                     if ((unicode & 0x00000400u) == 0)
@@ -1993,12 +2027,18 @@ uint32_t backUTF32(utf_text& text, const uint32_t count, const bool le, const bo
             bool pairing = false;
             while ((points < count) && (limit >= 4))
             {
+                if (((count - points) >= 2) && (limit >= 8) && !simd::hasSurrogate32(simd::loadUnits32((buffer - 8), le)))
+                {   //  2 code-units without surrogates
+                    points += 2;
+                    limit -= 8;
+                    buffer -= 8;
+                    pairing = false;
+                    continue;
+                }
                 ++points;
                 limit -= 4;
                 buffer -= 4;
-                unicode_t unicode = (le ?
-                    ((((((static_cast<unicode_t>(buffer[3]) << 8) + buffer[2]) << 8) + buffer[1]) << 8) + buffer[0]) :
-                    ((((((static_cast<unicode_t>(buffer[0]) << 8) + buffer[1]) << 8) + buffer[2]) << 8) + buffer[3]));
+                unicode_t unicode = static_cast<unicode_t>(simd::load32(buffer, le));
                 if ((unicode & 0xfffff800u) == 0x0000d800u)
                 {   //  found a surrogate
                     if ((unicode & 0x00000400u) != 0)
@@ -2043,11 +2083,17 @@ uint32_t stepUTF32(utf_text& text, const uint32_t count, const bool le, const bo
             bool pairing = false;
             while ((points < count) && (limit >= 4))
             {
+                if (((count - points) >= 2) && (limit >= 8) && !simd::hasSurrogate32(simd::loadUnits32(buffer, le)))
+                {   //  2 code-units without surrogates
+                    points += 2;
+                    limit -= 8;
+                    buffer += 8;
+                    pairing = false;
+                    continue;
+                }
                 ++points;
                 limit -= 4;
-                unicode_t unicode = (le ?
-                    ((((((static_cast<unicode_t>(buffer[3]) << 8) + buffer[2]) << 8) + buffer[1]) << 8) + buffer[0]) :
-                    ((((((static_cast<unicode_t>(buffer[0]) << 8) + buffer[1]) << 8) + buffer[2]) << 8) + buffer[3]));
+                unicode_t unicode = static_cast<unicode_t>(simd::load32(buffer, le));
                 if ((unicode & 0xfffff800u) == 0x0000d800u)
                 {   //  found a surrogate
                     if ((unicode & 0x00000400u) == 0)
@@ -2263,6 +2309,11 @@ uint32_t stepCP1252(utf_text& text, const uint32_t count, const bool strict, con
 
 // ==== encoded unicode code-point handling functions abstraction interface utility functions ====
 
+[[nodiscard]] cp_errors IUTFTK::get(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const cp_errors diagnostics) const noexcept
+{   //  handlers without a masked decoder compute all the warnings and drop those not requested
+    return get(text, unicode, bytes).diagnosed(diagnostics);
+}
+
 [[nodiscard]] cp_errors IUTFTK::read(utf_text& text, unicode_t& unicode) const noexcept
 {
     uint32_t bytes = 0;
@@ -2404,6 +2455,7 @@ uint32_t stepCP1252(utf_text& text, const uint32_t count, const bool strict, con
 
 // ==== concrete classes for encoded unicode code-point handling ====
 
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_UTF8)
 struct CUTF_UTF8 : public IUTFTK
 {
     virtual UTF_TYPE                utfType(void) const noexcept { return UTF_TYPE::UTF8; }
@@ -2413,13 +2465,16 @@ struct CUTF_UTF8 : public IUTFTK
     virtual uint32_t                lenBOM() const noexcept { return 3; }
     virtual uint32_t                lenNull() const noexcept { return 1; }
     virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes) const noexcept { return decodeUTF8(text, unicode, bytes, false, false, false, true); }
+    virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const cp_errors diagnostics) const noexcept { return decodeUTF8(text, unicode, bytes, false, false, false, true, diagnostics); }
     virtual [[nodiscard]] cp_errors set(utf_text& text, const unicode_t unicode, uint32_t& bytes) const noexcept { return encodeUTF8(text, unicode, bytes, false, false); }
     virtual [[nodiscard]] cp_errors setBOM(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF8_BOM(text, bytes); }
     virtual [[nodiscard]] cp_errors setNull(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF8_NULL(text, bytes); }
     virtual uint32_t                back(utf_text& text, const uint32_t count) const noexcept { return backUTF8(text, count, false, false, true); }
     virtual uint32_t                step(utf_text& text, const uint32_t count) const noexcept { return stepUTF8(text, count, false, false, true); }
 };
+#endif
 
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_UTF8ns)
 struct CUTF_UTF8ns : public IUTFTK
 {
     virtual UTF_TYPE                utfType(void) const noexcept { return UTF_TYPE::UTF8; }
@@ -2429,13 +2484,16 @@ struct CUTF_UTF8ns : public IUTFTK
     virtual uint32_t                lenBOM() const noexcept { return 3; }
     virtual uint32_t                lenNull() const noexcept { return 1; }
     virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes) const noexcept { return decodeUTF8(text, unicode, bytes, false, false, false, false); }
+    virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const cp_errors diagnostics) const noexcept { return decodeUTF8(text, unicode, bytes, false, false, false, false, diagnostics); }
     virtual [[nodiscard]] cp_errors set(utf_text& text, const unicode_t unicode, uint32_t& bytes) const noexcept { return encodeUTF8(text, unicode, bytes, false, false); }
     virtual [[nodiscard]] cp_errors setBOM(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF8_BOM(text, bytes); }
     virtual [[nodiscard]] cp_errors setNull(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF8_NULL(text, bytes); }
     virtual uint32_t                back(utf_text& text, const uint32_t count) const noexcept { return backUTF8(text, count, false, false, false); }
     virtual uint32_t                step(utf_text& text, const uint32_t count) const noexcept { return stepUTF8(text, count, false, false, false); }
 };
+#endif
 
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_UTF8st)
 struct CUTF_UTF8st : public IUTFTK
 {
     virtual UTF_TYPE                utfType(void) const noexcept { return UTF_TYPE::UTF8; }
@@ -2445,13 +2503,16 @@ struct CUTF_UTF8st : public IUTFTK
     virtual uint32_t                lenBOM() const noexcept { return 3; }
     virtual uint32_t                lenNull() const noexcept { return 1; }
     virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes) const noexcept { return decodeUTF8(text, unicode, bytes, false, false, true, false); }
+    virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const cp_errors diagnostics) const noexcept { return decodeUTF8(text, unicode, bytes, false, false, true, false, diagnostics); }
     virtual [[nodiscard]] cp_errors set(utf_text& text, const unicode_t unicode, uint32_t& bytes) const noexcept { return encodeUTF8(text, unicode, bytes, false, false); }
     virtual [[nodiscard]] cp_errors setBOM(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF8_BOM(text, bytes); }
     virtual [[nodiscard]] cp_errors setNull(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF8_NULL(text, bytes); }
     virtual uint32_t                back(utf_text& text, const uint32_t count) const noexcept { return backUTF8(text, count, false, true, false); }
     virtual uint32_t                step(utf_text& text, const uint32_t count) const noexcept { return stepUTF8(text, count, false, true, false); }
 };
+#endif
 
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_JUTF8)
 struct CUTF_JUTF8 : public IUTFTK
 {
     virtual UTF_TYPE                utfType(void) const noexcept { return UTF_TYPE::UTF8; }
@@ -2461,13 +2522,16 @@ struct CUTF_JUTF8 : public IUTFTK
     virtual uint32_t                lenBOM() const noexcept { return 3; }
     virtual uint32_t                lenNull() const noexcept { return 1; }
     virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes) const noexcept { return decodeUTF8(text, unicode, bytes, false, true, false, true); }
+    virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const cp_errors diagnostics) const noexcept { return decodeUTF8(text, unicode, bytes, false, true, false, true, diagnostics); }
     virtual [[nodiscard]] cp_errors set(utf_text& text, const unicode_t unicode, uint32_t& bytes) const noexcept { return encodeUTF8(text, unicode, bytes, false, true); }
     virtual [[nodiscard]] cp_errors setBOM(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF8_BOM(text, bytes); }
     virtual [[nodiscard]] cp_errors setNull(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF8_NULL(text, bytes); }
     virtual uint32_t                back(utf_text& text, const uint32_t count) const noexcept { return backUTF8(text, count, false, false, true); }
     virtual uint32_t                step(utf_text& text, const uint32_t count) const noexcept { return stepUTF8(text, count, false, false, true); }
 };
+#endif
 
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_JUTF8ns)
 struct CUTF_JUTF8ns : public IUTFTK
 {
     virtual UTF_TYPE                utfType(void) const noexcept { return UTF_TYPE::UTF8; }
@@ -2477,13 +2541,16 @@ struct CUTF_JUTF8ns : public IUTFTK
     virtual uint32_t                lenBOM() const noexcept { return 3; }
     virtual uint32_t                lenNull() const noexcept { return 1; }
     virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes) const noexcept { return decodeUTF8(text, unicode, bytes, false, true, false, false); }
+    virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const cp_errors diagnostics) const noexcept { return decodeUTF8(text, unicode, bytes, false, true, false, false, diagnostics); }
     virtual [[nodiscard]] cp_errors set(utf_text& text, const unicode_t unicode, uint32_t& bytes) const noexcept { return encodeUTF8(text, unicode, bytes, false, true); }
     virtual [[nodiscard]] cp_errors setBOM(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF8_BOM(text, bytes); }
     virtual [[nodiscard]] cp_errors setNull(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF8_NULL(text, bytes); }
     virtual uint32_t                back(utf_text& text, const uint32_t count) const noexcept { return backUTF8(text, count, false, false, false); }
     virtual uint32_t                step(utf_text& text, const uint32_t count) const noexcept { return stepUTF8(text, count, false, false, false); }
 };
+#endif
 
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_JUTF8st)
 struct CUTF_JUTF8st : public IUTFTK
 {
     virtual UTF_TYPE                utfType(void) const noexcept { return UTF_TYPE::UTF8; }
@@ -2493,13 +2560,16 @@ struct CUTF_JUTF8st : public IUTFTK
     virtual uint32_t                lenBOM() const noexcept { return 3; }
     virtual uint32_t                lenNull() const noexcept { return 1; }
     virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes) const noexcept { return decodeUTF8(text, unicode, bytes, false, true, true, false); }
+    virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const cp_errors diagnostics) const noexcept { return decodeUTF8(text, unicode, bytes, false, true, true, false, diagnostics); }
     virtual [[nodiscard]] cp_errors set(utf_text& text, const unicode_t unicode, uint32_t& bytes) const noexcept { return encodeUTF8(text, unicode, bytes, false, true); }
     virtual [[nodiscard]] cp_errors setBOM(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF8_BOM(text, bytes); }
     virtual [[nodiscard]] cp_errors setNull(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF8_NULL(text, bytes); }
     virtual uint32_t                back(utf_text& text, const uint32_t count) const noexcept { return backUTF8(text, count, false, true, false); }
     virtual uint32_t                step(utf_text& text, const uint32_t count) const noexcept { return stepUTF8(text, count, false, true, false); }
 };
+#endif
 
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_CESU8)
 struct CUTF_CESU8 : public IUTFTK
 {
     virtual UTF_TYPE                utfType(void) const noexcept { return UTF_TYPE::UTF8; }
@@ -2509,13 +2579,16 @@ struct CUTF_CESU8 : public IUTFTK
     virtual uint32_t                lenBOM() const noexcept { return 3; }
     virtual uint32_t                lenNull() const noexcept { return 1; }
     virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes) const noexcept { return decodeUTF8(text, unicode, bytes, true, false, false, true); }
+    virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const cp_errors diagnostics) const noexcept { return decodeUTF8(text, unicode, bytes, true, false, false, true, diagnostics); }
     virtual [[nodiscard]] cp_errors set(utf_text& text, const unicode_t unicode, uint32_t& bytes) const noexcept { return encodeUTF8(text, unicode, bytes, true, false); }
     virtual [[nodiscard]] cp_errors setBOM(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF8_BOM(text, bytes); }
     virtual [[nodiscard]] cp_errors setNull(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF8_NULL(text, bytes); }
     virtual uint32_t                back(utf_text& text, const uint32_t count) const noexcept { return backUTF8(text, count, true, false, true); }
     virtual uint32_t                step(utf_text& text, const uint32_t count) const noexcept { return stepUTF8(text, count, true, false, true); }
 };
+#endif
 
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_CESU8ns)
 struct CUTF_CESU8ns : public IUTFTK
 {
     virtual UTF_TYPE                utfType(void) const noexcept { return UTF_TYPE::UTF8; }
@@ -2525,13 +2598,16 @@ struct CUTF_CESU8ns : public IUTFTK
     virtual uint32_t                lenBOM() const noexcept { return 3; }
     virtual uint32_t                lenNull() const noexcept { return 1; }
     virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes) const noexcept { return decodeUTF8(text, unicode, bytes, true, false, false, false); }
+    virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const cp_errors diagnostics) const noexcept { return decodeUTF8(text, unicode, bytes, true, false, false, false, diagnostics); }
     virtual [[nodiscard]] cp_errors set(utf_text& text, const unicode_t unicode, uint32_t& bytes) const noexcept { return encodeUTF8(text, unicode, bytes, true, false); }
     virtual [[nodiscard]] cp_errors setBOM(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF8_BOM(text, bytes); }
     virtual [[nodiscard]] cp_errors setNull(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF8_NULL(text, bytes); }
     virtual uint32_t                back(utf_text& text, const uint32_t count) const noexcept { return backUTF8(text, count, true, false, false); }
     virtual uint32_t                step(utf_text& text, const uint32_t count) const noexcept { return stepUTF8(text, count, true, false, false); }
 };
+#endif
 
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_CESU8st)
 struct CUTF_CESU8st : public IUTFTK
 {
     virtual UTF_TYPE                utfType(void) const noexcept { return UTF_TYPE::UTF8; }
@@ -2541,13 +2617,16 @@ struct CUTF_CESU8st : public IUTFTK
     virtual uint32_t                lenBOM() const noexcept { return 3; }
     virtual uint32_t                lenNull() const noexcept { return 1; }
     virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes) const noexcept { return decodeUTF8(text, unicode, bytes, true, false, true, false); }
+    virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const cp_errors diagnostics) const noexcept { return decodeUTF8(text, unicode, bytes, true, false, true, false, diagnostics); }
     virtual [[nodiscard]] cp_errors set(utf_text& text, const unicode_t unicode, uint32_t& bytes) const noexcept { return encodeUTF8(text, unicode, bytes, true, false); }
     virtual [[nodiscard]] cp_errors setBOM(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF8_BOM(text, bytes); }
     virtual [[nodiscard]] cp_errors setNull(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF8_NULL(text, bytes); }
     virtual uint32_t                back(utf_text& text, const uint32_t count) const noexcept { return backUTF8(text, count, true, true, false); }
     virtual uint32_t                step(utf_text& text, const uint32_t count) const noexcept { return stepUTF8(text, count, true, true, false); }
 };
+#endif
 
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_JCESU8)
 struct CUTF_JCESU8 : public IUTFTK
 {
     virtual UTF_TYPE                utfType(void) const noexcept { return UTF_TYPE::UTF8; }
@@ -2557,13 +2636,16 @@ struct CUTF_JCESU8 : public IUTFTK
     virtual uint32_t                lenBOM() const noexcept { return 3; }
     virtual uint32_t                lenNull() const noexcept { return 1; }
     virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes) const noexcept { return decodeUTF8(text, unicode, bytes, true, true, false, true); }
+    virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const cp_errors diagnostics) const noexcept { return decodeUTF8(text, unicode, bytes, true, true, false, true, diagnostics); }
     virtual [[nodiscard]] cp_errors set(utf_text& text, const unicode_t unicode, uint32_t& bytes) const noexcept { return encodeUTF8(text, unicode, bytes, true, true); }
     virtual [[nodiscard]] cp_errors setBOM(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF8_BOM(text, bytes); }
     virtual [[nodiscard]] cp_errors setNull(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF8_NULL(text, bytes); }
     virtual uint32_t                back(utf_text& text, const uint32_t count) const noexcept { return backUTF8(text, count, true, false, true); }
     virtual uint32_t                step(utf_text& text, const uint32_t count) const noexcept { return stepUTF8(text, count, true, false, true); }
 };
+#endif
 
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_JCESU8ns)
 struct CUTF_JCESU8ns : public IUTFTK
 {
     virtual UTF_TYPE                utfType(void) const noexcept { return UTF_TYPE::UTF8; }
@@ -2573,13 +2655,16 @@ struct CUTF_JCESU8ns : public IUTFTK
     virtual uint32_t                lenBOM() const noexcept { return 3; }
     virtual uint32_t                lenNull() const noexcept { return 1; }
     virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes) const noexcept { return decodeUTF8(text, unicode, bytes, true, true, false, false); }
+    virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const cp_errors diagnostics) const noexcept { return decodeUTF8(text, unicode, bytes, true, true, false, false, diagnostics); }
     virtual [[nodiscard]] cp_errors set(utf_text& text, const unicode_t unicode, uint32_t& bytes) const noexcept { return encodeUTF8(text, unicode, bytes, true, true); }
     virtual [[nodiscard]] cp_errors setBOM(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF8_BOM(text, bytes); }
     virtual [[nodiscard]] cp_errors setNull(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF8_NULL(text, bytes); }
     virtual uint32_t                back(utf_text& text, const uint32_t count) const noexcept { return backUTF8(text, count, true, false, false); }
     virtual uint32_t                step(utf_text& text, const uint32_t count) const noexcept { return stepUTF8(text, count, true, false, false); }
 };
+#endif
 
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_JCESU8st)
 struct CUTF_JCESU8st : public IUTFTK
 {
     virtual UTF_TYPE                utfType(void) const noexcept { return UTF_TYPE::UTF8; }
@@ -2589,13 +2674,16 @@ struct CUTF_JCESU8st : public IUTFTK
     virtual uint32_t                lenBOM() const noexcept { return 3; }
     virtual uint32_t                lenNull() const noexcept { return 1; }
     virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes) const noexcept { return decodeUTF8(text, unicode, bytes, true, true, true, false); }
+    virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const cp_errors diagnostics) const noexcept { return decodeUTF8(text, unicode, bytes, true, true, true, false, diagnostics); }
     virtual [[nodiscard]] cp_errors set(utf_text& text, const unicode_t unicode, uint32_t& bytes) const noexcept { return encodeUTF8(text, unicode, bytes, true, true); }
     virtual [[nodiscard]] cp_errors setBOM(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF8_BOM(text, bytes); }
     virtual [[nodiscard]] cp_errors setNull(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF8_NULL(text, bytes); }
     virtual uint32_t                back(utf_text& text, const uint32_t count) const noexcept { return backUTF8(text, count, true, true, false); }
     virtual uint32_t                step(utf_text& text, const uint32_t count) const noexcept { return stepUTF8(text, count, true, true, false); }
 };
+#endif
 
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_UTF16le)
 struct CUTF_UTF16le : public IUTFTK
 {
     virtual UTF_TYPE                utfType(void) const noexcept { return UTF_TYPE::UTF16le; }
@@ -2605,13 +2693,16 @@ struct CUTF_UTF16le : public IUTFTK
     virtual uint32_t                lenBOM() const noexcept { return 2; }
     virtual uint32_t                lenNull() const noexcept { return 2; }
     virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes) const noexcept { return decodeUTF16(text, unicode, bytes, true, false); }
+    virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const cp_errors diagnostics) const noexcept { return decodeUTF16(text, unicode, bytes, true, false, diagnostics); }
     virtual [[nodiscard]] cp_errors set(utf_text& text, const unicode_t unicode, uint32_t& bytes) const noexcept { return encodeUTF16(text, unicode, bytes, true, false); }
     virtual [[nodiscard]] cp_errors setBOM(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF16_BOM(text, bytes, true); }
     virtual [[nodiscard]] cp_errors setNull(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF16_NULL(text, bytes); }
     virtual uint32_t                back(utf_text& text, const uint32_t count) const noexcept { return backUTF16(text, count, true, false); }
     virtual uint32_t                step(utf_text& text, const uint32_t count) const noexcept { return stepUTF16(text, count, true, false); }
 };
+#endif
 
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_UTF16be)
 struct CUTF_UTF16be : public IUTFTK
 {
     virtual UTF_TYPE                utfType(void) const noexcept { return UTF_TYPE::UTF16be; }
@@ -2621,13 +2712,16 @@ struct CUTF_UTF16be : public IUTFTK
     virtual uint32_t                lenBOM() const noexcept { return 2; }
     virtual uint32_t                lenNull() const noexcept { return 2; }
     virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes) const noexcept { return decodeUTF16(text, unicode, bytes, false, false); }
+    virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const cp_errors diagnostics) const noexcept { return decodeUTF16(text, unicode, bytes, false, false, diagnostics); }
     virtual [[nodiscard]] cp_errors set(utf_text& text, const unicode_t unicode, uint32_t& bytes) const noexcept { return encodeUTF16(text, unicode, bytes, false, false); }
     virtual [[nodiscard]] cp_errors setBOM(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF16_BOM(text, bytes, false); }
     virtual [[nodiscard]] cp_errors setNull(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF16_NULL(text, bytes); }
     virtual uint32_t                back(utf_text& text, const uint32_t count) const noexcept { return backUTF16(text, count, false, false); }
     virtual uint32_t                step(utf_text& text, const uint32_t count) const noexcept { return stepUTF16(text, count, false, false); }
 };
+#endif
 
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_UCS2le)
 struct CUTF_UCS2le : public IUTFTK
 {
     virtual UTF_TYPE                utfType(void) const noexcept { return UTF_TYPE::UTF16le; }
@@ -2637,13 +2731,16 @@ struct CUTF_UCS2le : public IUTFTK
     virtual uint32_t                lenBOM() const noexcept { return 2; }
     virtual uint32_t                lenNull() const noexcept { return 2; }
     virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes) const noexcept { return decodeUTF16(text, unicode, bytes, true, true); }
+    virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const cp_errors diagnostics) const noexcept { return decodeUTF16(text, unicode, bytes, true, true, diagnostics); }
     virtual [[nodiscard]] cp_errors set(utf_text& text, const unicode_t unicode, uint32_t& bytes) const noexcept { return encodeUTF16(text, unicode, bytes, true, true); }
     virtual [[nodiscard]] cp_errors setBOM(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF16_BOM(text, bytes, true); }
     virtual [[nodiscard]] cp_errors setNull(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF16_NULL(text, bytes); }
     virtual uint32_t                back(utf_text& text, const uint32_t count) const noexcept { return backUTF16(text, count, true, true); }
     virtual uint32_t                step(utf_text& text, const uint32_t count) const noexcept { return stepUTF16(text, count, true, true); }
 };
+#endif
 
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_UCS2be)
 struct CUTF_UCS2be : public IUTFTK
 {
     virtual UTF_TYPE                utfType(void) const noexcept { return UTF_TYPE::UTF16be; }
@@ -2653,13 +2750,16 @@ struct CUTF_UCS2be : public IUTFTK
     virtual uint32_t                lenBOM() const noexcept { return 2; }
     virtual uint32_t                lenNull() const noexcept { return 2; }
     virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes) const noexcept { return decodeUTF16(text, unicode, bytes, false, true); }
+    virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const cp_errors diagnostics) const noexcept { return decodeUTF16(text, unicode, bytes, false, true, diagnostics); }
     virtual [[nodiscard]] cp_errors set(utf_text& text, const unicode_t unicode, uint32_t& bytes) const noexcept { return encodeUTF16(text, unicode, bytes, false, true); }
     virtual [[nodiscard]] cp_errors setBOM(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF16_BOM(text, bytes, false); }
     virtual [[nodiscard]] cp_errors setNull(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF16_NULL(text, bytes); }
     virtual uint32_t                back(utf_text& text, const uint32_t count) const noexcept { return backUTF16(text, count, false, true); }
     virtual uint32_t                step(utf_text& text, const uint32_t count) const noexcept { return stepUTF16(text, count, false, true); }
 };
+#endif
 
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_UTF32le)
 struct CUTF_UTF32le : public IUTFTK
 {
     virtual UTF_TYPE                utfType(void) const noexcept { return UTF_TYPE::UTF32le; }
@@ -2669,13 +2769,16 @@ struct CUTF_UTF32le : public IUTFTK
     virtual uint32_t                lenBOM() const noexcept { return 4; }
     virtual uint32_t                lenNull() const noexcept { return 4; }
     virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes) const noexcept { return decodeUTF32(text, unicode, bytes, true, false, false); }
+    virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const cp_errors diagnostics) const noexcept { return decodeUTF32(text, unicode, bytes, true, false, false, diagnostics); }
     virtual [[nodiscard]] cp_errors set(utf_text& text, const unicode_t unicode, uint32_t& bytes) const noexcept { return encodeUTF32(text, unicode, bytes, true, false, false); }
     virtual [[nodiscard]] cp_errors setBOM(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF32_BOM(text, bytes, true); }
     virtual [[nodiscard]] cp_errors setNull(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF32_NULL(text, bytes); }
     virtual uint32_t                back(utf_text& text, const uint32_t count) const noexcept { return backUTF32(text, count, true, false); }
     virtual uint32_t                step(utf_text& text, const uint32_t count) const noexcept { return stepUTF32(text, count, true, false); }
 };
+#endif
 
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_UTF32be)
 struct CUTF_UTF32be : public IUTFTK
 {
     virtual UTF_TYPE                utfType(void) const noexcept { return UTF_TYPE::UTF32be; }
@@ -2685,13 +2788,16 @@ struct CUTF_UTF32be : public IUTFTK
     virtual uint32_t                lenBOM() const noexcept { return 4; }
     virtual uint32_t                lenNull() const noexcept { return 4; }
     virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes) const noexcept { return decodeUTF32(text, unicode, bytes, false, false, false); }
+    virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const cp_errors diagnostics) const noexcept { return decodeUTF32(text, unicode, bytes, false, false, false, diagnostics); }
     virtual [[nodiscard]] cp_errors set(utf_text& text, const unicode_t unicode, uint32_t& bytes) const noexcept { return encodeUTF32(text, unicode, bytes, false, false, false); }
     virtual [[nodiscard]] cp_errors setBOM(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF32_BOM(text, bytes, false); }
     virtual [[nodiscard]] cp_errors setNull(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF32_NULL(text, bytes); }
     virtual uint32_t                back(utf_text& text, const uint32_t count) const noexcept { return backUTF32(text, count, false, false); }
     virtual uint32_t                step(utf_text& text, const uint32_t count) const noexcept { return stepUTF32(text, count, false, false); }
 };
+#endif
 
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_UCS4le)
 struct CUTF_UCS4le : public IUTFTK
 {
     virtual UTF_TYPE                utfType(void) const noexcept { return UTF_TYPE::UTF32le; }
@@ -2701,13 +2807,16 @@ struct CUTF_UCS4le : public IUTFTK
     virtual uint32_t                lenBOM() const noexcept { return 4; }
     virtual uint32_t                lenNull() const noexcept { return 4; }
     virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes) const noexcept { return decodeUTF32(text, unicode, bytes, true, false, true); }
+    virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const cp_errors diagnostics) const noexcept { return decodeUTF32(text, unicode, bytes, true, false, true, diagnostics); }
     virtual [[nodiscard]] cp_errors set(utf_text& text, const unicode_t unicode, uint32_t& bytes) const noexcept { return encodeUTF32(text, unicode, bytes, true, false, true); }
     virtual [[nodiscard]] cp_errors setBOM(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF32_BOM(text, bytes, true); }
     virtual [[nodiscard]] cp_errors setNull(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF32_NULL(text, bytes); }
     virtual uint32_t                back(utf_text& text, const uint32_t count) const noexcept { return backUTF32(text, count, true, false); }
     virtual uint32_t                step(utf_text& text, const uint32_t count) const noexcept { return stepUTF32(text, count, true, false); }
 };
+#endif
 
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_UCS4be)
 struct CUTF_UCS4be : public IUTFTK
 {
     virtual UTF_TYPE                utfType(void) const noexcept { return UTF_TYPE::UTF32be; }
@@ -2717,13 +2826,16 @@ struct CUTF_UCS4be : public IUTFTK
     virtual uint32_t                lenBOM() const noexcept { return 4; }
     virtual uint32_t                lenNull() const noexcept { return 4; }
     virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes) const noexcept { return decodeUTF32(text, unicode, bytes, false, false, true); }
+    virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const cp_errors diagnostics) const noexcept { return decodeUTF32(text, unicode, bytes, false, false, true, diagnostics); }
     virtual [[nodiscard]] cp_errors set(utf_text& text, const unicode_t unicode, uint32_t& bytes) const noexcept { return encodeUTF32(text, unicode, bytes, false, false, true); }
     virtual [[nodiscard]] cp_errors setBOM(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF32_BOM(text, bytes, false); }
     virtual [[nodiscard]] cp_errors setNull(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF32_NULL(text, bytes); }
     virtual uint32_t                back(utf_text& text, const uint32_t count) const noexcept { return backUTF32(text, count, false, false); }
     virtual uint32_t                step(utf_text& text, const uint32_t count) const noexcept { return stepUTF32(text, count, false, false); }
 };
+#endif
 
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_CESU32le)
 struct CUTF_CESU32le : public IUTFTK
 {
     virtual UTF_TYPE                utfType(void) const noexcept { return UTF_TYPE::UTF32le; }
@@ -2733,13 +2845,16 @@ struct CUTF_CESU32le : public IUTFTK
     virtual uint32_t                lenBOM() const noexcept { return 4; }
     virtual uint32_t                lenNull() const noexcept { return 4; }
     virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes) const noexcept { return decodeUTF32(text, unicode, bytes, true, true, false); }
+    virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const cp_errors diagnostics) const noexcept { return decodeUTF32(text, unicode, bytes, true, true, false, diagnostics); }
     virtual [[nodiscard]] cp_errors set(utf_text& text, const unicode_t unicode, uint32_t& bytes) const noexcept { return encodeUTF32(text, unicode, bytes, true, true, false); }
     virtual [[nodiscard]] cp_errors setBOM(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF32_BOM(text, bytes, true); }
     virtual [[nodiscard]] cp_errors setNull(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF32_NULL(text, bytes); }
     virtual uint32_t                back(utf_text& text, const uint32_t count) const noexcept { return backUTF32(text, count, true, true); }
     virtual uint32_t                step(utf_text& text, const uint32_t count) const noexcept { return stepUTF32(text, count, true, true); }
 };
+#endif
 
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_CESU32be)
 struct CUTF_CESU32be : public IUTFTK
 {
     virtual UTF_TYPE                utfType(void) const noexcept { return UTF_TYPE::UTF32be; }
@@ -2749,45 +2864,54 @@ struct CUTF_CESU32be : public IUTFTK
     virtual uint32_t                lenBOM() const noexcept { return 4; }
     virtual uint32_t                lenNull() const noexcept { return 4; }
     virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes) const noexcept { return decodeUTF32(text, unicode, bytes, false, true, false); }
+    virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const cp_errors diagnostics) const noexcept { return decodeUTF32(text, unicode, bytes, false, true, false, diagnostics); }
     virtual [[nodiscard]] cp_errors set(utf_text& text, const unicode_t unicode, uint32_t& bytes) const noexcept { return encodeUTF32(text, unicode, bytes, false, true, false); }
     virtual [[nodiscard]] cp_errors setBOM(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF32_BOM(text, bytes, false); }
     virtual [[nodiscard]] cp_errors setNull(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF32_NULL(text, bytes); }
     virtual uint32_t                back(utf_text& text, const uint32_t count) const noexcept { return backUTF32(text, count, false, true); }
     virtual uint32_t                step(utf_text& text, const uint32_t count) const noexcept { return stepUTF32(text, count, false, true); }
 };
+#endif
 
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_CESU4le)
 struct CUTF_CESU4le : public IUTFTK
 {
     virtual UTF_TYPE                utfType(void) const noexcept { return UTF_TYPE::UTF32le; }
-    virtual UTF_SUB_TYPE            utfSubType(void) const noexcept { return UTF_SUB_TYPE::CESU32le; }
+    virtual UTF_SUB_TYPE            utfSubType(void) const noexcept { return UTF_SUB_TYPE::CESU4le; }
     virtual uint32_t                unitSize(void) const noexcept { return 4; }
     virtual uint32_t                len(const unicode_t unicode) const noexcept { return lenUTF32(unicode, true, true); }
     virtual uint32_t                lenBOM() const noexcept { return 4; }
     virtual uint32_t                lenNull() const noexcept { return 4; }
     virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes) const noexcept { return decodeUTF32(text, unicode, bytes, true, true, true); }
+    virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const cp_errors diagnostics) const noexcept { return decodeUTF32(text, unicode, bytes, true, true, true, diagnostics); }
     virtual [[nodiscard]] cp_errors set(utf_text& text, const unicode_t unicode, uint32_t& bytes) const noexcept { return encodeUTF32(text, unicode, bytes, true, true, true); }
     virtual [[nodiscard]] cp_errors setBOM(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF32_BOM(text, bytes, true); }
     virtual [[nodiscard]] cp_errors setNull(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF32_NULL(text, bytes); }
     virtual uint32_t                back(utf_text& text, const uint32_t count) const noexcept { return backUTF32(text, count, true, true); }
     virtual uint32_t                step(utf_text& text, const uint32_t count) const noexcept { return stepUTF32(text, count, true, true); }
 };
+#endif
 
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_CESU4be)
 struct CUTF_CESU4be : public IUTFTK
 {
     virtual UTF_TYPE                utfType(void) const noexcept { return UTF_TYPE::UTF32be; }
-    virtual UTF_SUB_TYPE            utfSubType(void) const noexcept { return UTF_SUB_TYPE::CESU32be; }
+    virtual UTF_SUB_TYPE            utfSubType(void) const noexcept { return UTF_SUB_TYPE::CESU4be; }
     virtual uint32_t                unitSize(void) const noexcept { return 4; }
     virtual uint32_t                len(const unicode_t unicode) const noexcept { return lenUTF32(unicode, true, true); }
     virtual uint32_t                lenBOM() const noexcept { return 4; }
     virtual uint32_t                lenNull() const noexcept { return 4; }
     virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes) const noexcept { return decodeUTF32(text, unicode, bytes, false, true, true); }
+    virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const cp_errors diagnostics) const noexcept { return decodeUTF32(text, unicode, bytes, false, true, true, diagnostics); }
     virtual [[nodiscard]] cp_errors set(utf_text& text, const unicode_t unicode, uint32_t& bytes) const noexcept { return encodeUTF32(text, unicode, bytes, false, true, true); }
     virtual [[nodiscard]] cp_errors setBOM(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF32_BOM(text, bytes, false); }
     virtual [[nodiscard]] cp_errors setNull(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF32_NULL(text, bytes); }
     virtual uint32_t                back(utf_text& text, const uint32_t count) const noexcept { return backUTF32(text, count, false, true); }
     virtual uint32_t                step(utf_text& text, const uint32_t count) const noexcept { return stepUTF32(text, count, false, true); }
 };
+#endif
 
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_BYTE)
 struct CUTF_BYTE : public IUTFTK
 {
     virtual UTF_TYPE                utfType(void) const noexcept { return UTF_TYPE::OTHER; }
@@ -2797,13 +2921,16 @@ struct CUTF_BYTE : public IUTFTK
     virtual uint32_t                lenBOM() const noexcept { return 3; }
     virtual uint32_t                lenNull() const noexcept { return 1; }
     virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes) const noexcept { return decodeBYTE(text, unicode, bytes, false, true); }
+    virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const cp_errors diagnostics) const noexcept { return decodeBYTE(text, unicode, bytes, false, true, diagnostics); }
     virtual [[nodiscard]] cp_errors set(utf_text& text, const unicode_t unicode, uint32_t& bytes) const noexcept { return encodeBYTE(text, unicode, bytes, false); }
     virtual [[nodiscard]] cp_errors setBOM(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF8_BOM(text, bytes); }
     virtual [[nodiscard]] cp_errors setNull(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF8_NULL(text, bytes); }
     virtual uint32_t                back(utf_text& text, const uint32_t count) const noexcept { return backBYTE(text, count, false, true); }
     virtual uint32_t                step(utf_text& text, const uint32_t count) const noexcept { return stepBYTE(text, count, false, true); }
 };
+#endif
 
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_BYTEns)
 struct CUTF_BYTEns : public IUTFTK
 {
     virtual UTF_TYPE                utfType(void) const noexcept { return UTF_TYPE::OTHER; }
@@ -2813,13 +2940,16 @@ struct CUTF_BYTEns : public IUTFTK
     virtual uint32_t                lenBOM() const noexcept { return 3; }
     virtual uint32_t                lenNull() const noexcept { return 1; }
     virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes) const noexcept { return decodeBYTE(text, unicode, bytes, false, false); }
+    virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const cp_errors diagnostics) const noexcept { return decodeBYTE(text, unicode, bytes, false, false, diagnostics); }
     virtual [[nodiscard]] cp_errors set(utf_text& text, const unicode_t unicode, uint32_t& bytes) const noexcept { return encodeBYTE(text, unicode, bytes, false); }
     virtual [[nodiscard]] cp_errors setBOM(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF8_BOM(text, bytes); }
     virtual [[nodiscard]] cp_errors setNull(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF8_NULL(text, bytes); }
     virtual uint32_t                back(utf_text& text, const uint32_t count) const noexcept { return backBYTE(text, count, false, false); }
     virtual uint32_t                step(utf_text& text, const uint32_t count) const noexcept { return stepBYTE(text, count, false, false); }
 };
+#endif
 
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_ASCII)
 struct CUTF_ASCII : public IUTFTK
 {
     virtual UTF_TYPE                utfType(void) const noexcept { return UTF_TYPE::OTHER; }
@@ -2829,13 +2959,16 @@ struct CUTF_ASCII : public IUTFTK
     virtual uint32_t                lenBOM() const noexcept { return 3; }
     virtual uint32_t                lenNull() const noexcept { return 1; }
     virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes) const noexcept { return decodeBYTE(text, unicode, bytes, true, true); }
+    virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const cp_errors diagnostics) const noexcept { return decodeBYTE(text, unicode, bytes, true, true, diagnostics); }
     virtual [[nodiscard]] cp_errors set(utf_text& text, const unicode_t unicode, uint32_t& bytes) const noexcept { return encodeBYTE(text, unicode, bytes, true); }
     virtual [[nodiscard]] cp_errors setBOM(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF8_BOM(text, bytes); }
     virtual [[nodiscard]] cp_errors setNull(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF8_NULL(text, bytes); }
     virtual uint32_t                back(utf_text& text, const uint32_t count) const noexcept { return backBYTE(text, count, true, true); }
     virtual uint32_t                step(utf_text& text, const uint32_t count) const noexcept { return stepBYTE(text, count, true, true); }
 };
+#endif
 
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_ASCIIns)
 struct CUTF_ASCIIns : public IUTFTK
 {
     virtual UTF_TYPE                utfType(void) const noexcept { return UTF_TYPE::OTHER; }
@@ -2845,13 +2978,16 @@ struct CUTF_ASCIIns : public IUTFTK
     virtual uint32_t                lenBOM() const noexcept { return 3; }
     virtual uint32_t                lenNull() const noexcept { return 1; }
     virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes) const noexcept { return decodeBYTE(text, unicode, bytes, true, false); }
+    virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const cp_errors diagnostics) const noexcept { return decodeBYTE(text, unicode, bytes, true, false, diagnostics); }
     virtual [[nodiscard]] cp_errors set(utf_text& text, const unicode_t unicode, uint32_t& bytes) const noexcept { return encodeBYTE(text, unicode, bytes, true); }
     virtual [[nodiscard]] cp_errors setBOM(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF8_BOM(text, bytes); }
     virtual [[nodiscard]] cp_errors setNull(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF8_NULL(text, bytes); }
     virtual uint32_t                back(utf_text& text, const uint32_t count) const noexcept { return backBYTE(text, count, true, false); }
     virtual uint32_t                step(utf_text& text, const uint32_t count) const noexcept { return stepBYTE(text, count, true, false); }
 };
+#endif
 
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_CP1252)
 struct CUTF_CP1252 : public IUTFTK
 {
     virtual UTF_TYPE                utfType(void) const noexcept { return UTF_TYPE::OTHER; }
@@ -2861,13 +2997,16 @@ struct CUTF_CP1252 : public IUTFTK
     virtual uint32_t                lenBOM() const noexcept { return 0; }
     virtual uint32_t                lenNull() const noexcept { return 1; }
     virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes) const noexcept { return decodeCP1252(text, unicode, bytes, false, true); }
+    virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const cp_errors diagnostics) const noexcept { return decodeCP1252(text, unicode, bytes, false, true, diagnostics); }
     virtual [[nodiscard]] cp_errors set(utf_text& text, const unicode_t unicode, uint32_t& bytes) const noexcept { return encodeCP1252(text, unicode, bytes, false); }
     virtual [[nodiscard]] cp_errors setBOM(utf_text& text, uint32_t& bytes) const noexcept { (void)text; bytes = 0; return cp_errors::bits::None; }
     virtual [[nodiscard]] cp_errors setNull(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF8_NULL(text, bytes); }
     virtual uint32_t                back(utf_text& text, const uint32_t count) const noexcept { return backCP1252(text, count, false, true); }
     virtual uint32_t                step(utf_text& text, const uint32_t count) const noexcept { return stepCP1252(text, count, false, true); }
 };
+#endif
 
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_CP1252ns)
 struct CUTF_CP1252ns : public IUTFTK
 {
     virtual UTF_TYPE                utfType(void) const noexcept { return UTF_TYPE::OTHER; }
@@ -2877,13 +3016,16 @@ struct CUTF_CP1252ns : public IUTFTK
     virtual uint32_t                lenBOM() const noexcept { return 0; }
     virtual uint32_t                lenNull() const noexcept { return 1; }
     virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes) const noexcept { return decodeCP1252(text, unicode, bytes, false, false); }
+    virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const cp_errors diagnostics) const noexcept { return decodeCP1252(text, unicode, bytes, false, false, diagnostics); }
     virtual [[nodiscard]] cp_errors set(utf_text& text, const unicode_t unicode, uint32_t& bytes) const noexcept { return encodeCP1252(text, unicode, bytes, false); }
     virtual [[nodiscard]] cp_errors setBOM(utf_text& text, uint32_t& bytes) const noexcept { (void)text; bytes = 0; return cp_errors::bits::None; }
     virtual [[nodiscard]] cp_errors setNull(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF8_NULL(text, bytes); }
     virtual uint32_t                back(utf_text& text, const uint32_t count) const noexcept { return backCP1252(text, count, false, false); }
     virtual uint32_t                step(utf_text& text, const uint32_t count) const noexcept { return stepCP1252(text, count, false, false); }
 };
+#endif
 
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_CP1252st)
 struct CUTF_CP1252st : public IUTFTK
 {
     virtual UTF_TYPE                utfType(void) const noexcept { return UTF_TYPE::OTHER; }
@@ -2893,12 +3035,61 @@ struct CUTF_CP1252st : public IUTFTK
     virtual uint32_t                lenBOM() const noexcept { return 0; }
     virtual uint32_t                lenNull() const noexcept { return 1; }
     virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes) const noexcept { return decodeCP1252(text, unicode, bytes, true, false); }
+    virtual [[nodiscard]] cp_errors get(const utf_text& text, unicode_t& unicode, uint32_t& bytes, const cp_errors diagnostics) const noexcept { return decodeCP1252(text, unicode, bytes, true, false, diagnostics); }
     virtual [[nodiscard]] cp_errors set(utf_text& text, const unicode_t unicode, uint32_t& bytes) const noexcept { return encodeCP1252(text, unicode, bytes, true); }
     virtual [[nodiscard]] cp_errors setBOM(utf_text& text, uint32_t& bytes) const noexcept { (void)text; bytes = 0; return cp_errors::bits::None; }
     virtual [[nodiscard]] cp_errors setNull(utf_text& text, uint32_t& bytes) const noexcept { return encodeUTF8_NULL(text, bytes); }
     virtual uint32_t                back(utf_text& text, const uint32_t count) const noexcept { return backCP1252(text, count, true, false); }
     virtual uint32_t                step(utf_text& text, const uint32_t count) const noexcept { return stepCP1252(text, count, true, false); }
 };
+#endif
+
+// ==== custom sub-type registry ====
+
+namespace internal
+{
+
+/// internal custom sub-type registry entry (the handler is published after the kernels)
+struct custom_entry
+{
+    ::std::atomic<const ICustomUTFTK*>  handler;
+    custom_kernels                      kernels;
+};
+
+custom_entry            custom_registry[kMaxCustomSubTypes];
+uint32_t                custom_count = 0;           //  guarded by custom_lock
+::std::atomic_flag      custom_lock = ATOMIC_FLAG_INIT;
+
+/// internal registered custom handler lookup (nullptr if the sub-type is not a registered custom sub-type)
+inline [[nodiscard]] const ICustomUTFTK* getCustomHandler(const UTF_SUB_TYPE utfSubType) noexcept
+{
+    return (isCustomSubType(utfSubType) ? custom_registry[static_cast<uint32_t>(utfSubType) - static_cast<uint32_t>(UTF_SUB_TYPE::CUSTOM)].handler.load(::std::memory_order_acquire) : nullptr);
+}
+
+};  //  namespace internal
+
+[[nodiscard]] bool registerSubType(ICustomUTFTK& handler, const custom_kernels& kernels) noexcept
+{
+    while (internal::custom_lock.test_and_set(::std::memory_order_acquire));
+    const bool registered = ((handler.customSubType == UTF_SUB_TYPE::COUNT) && (internal::custom_count < kMaxCustomSubTypes));
+    if (registered)
+    {
+        internal::custom_entry& entry = internal::custom_registry[internal::custom_count];
+        entry.kernels = kernels;
+        handler.customSubType = static_cast<UTF_SUB_TYPE>(static_cast<uint32_t>(UTF_SUB_TYPE::CUSTOM) + internal::custom_count);
+        entry.handler.store(&handler, ::std::memory_order_release);
+        ++internal::custom_count;
+    }
+    internal::custom_lock.clear(::std::memory_order_release);
+    return registered;
+}
+
+[[nodiscard]] const custom_kernels* getCustomKernels(const IUTFTK& handler) noexcept
+{
+    const UTF_SUB_TYPE utfSubType = handler.utfSubType();
+    const ICustomUTFTK* const custom = internal::getCustomHandler(utfSubType);
+    return (((custom != nullptr) && (static_cast<const IUTFTK*>(custom) == &handler)) ? &internal::custom_registry[static_cast<uint32_t>(utfSubType) - static_cast<uint32_t>(UTF_SUB_TYPE::CUSTOM)].kernels : nullptr);
+}
 
 // ==== encoded unicode code-point handler request functions ====
 
@@ -2913,39 +3104,109 @@ const IUTFTK& IUTFTK::getHandler(const UTF_SUB_TYPE utfSubType) noexcept
 {
     switch (utfSubType)
     {
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_UTF8)
         case(UTF_SUB_TYPE::UTF8):       { static const CUTF_UTF8     handler; return handler; }
+#endif
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_UTF8ns)
         case(UTF_SUB_TYPE::UTF8ns):     { static const CUTF_UTF8ns   handler; return handler; }
+#endif
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_UTF8st)
         case(UTF_SUB_TYPE::UTF8st):     { static const CUTF_UTF8st   handler; return handler; }
+#endif
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_JUTF8)
         case(UTF_SUB_TYPE::JUTF8):      { static const CUTF_JUTF8    handler; return handler; }
+#endif
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_JUTF8ns)
         case(UTF_SUB_TYPE::JUTF8ns):    { static const CUTF_JUTF8ns  handler; return handler; }
+#endif
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_JUTF8st)
         case(UTF_SUB_TYPE::JUTF8st):    { static const CUTF_JUTF8st  handler; return handler; }
+#endif
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_CESU8)
         case(UTF_SUB_TYPE::CESU8):      { static const CUTF_CESU8    handler; return handler; }
+#endif
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_CESU8ns)
         case(UTF_SUB_TYPE::CESU8ns):    { static const CUTF_CESU8ns  handler; return handler; }
+#endif
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_CESU8st)
         case(UTF_SUB_TYPE::CESU8st):    { static const CUTF_CESU8st  handler; return handler; }
+#endif
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_JCESU8)
         case(UTF_SUB_TYPE::JCESU8):     { static const CUTF_JCESU8   handler; return handler; }
+#endif
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_JCESU8ns)
         case(UTF_SUB_TYPE::JCESU8ns):   { static const CUTF_JCESU8ns handler; return handler; }
+#endif
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_JCESU8st)
         case(UTF_SUB_TYPE::JCESU8st):   { static const CUTF_JCESU8st handler; return handler; }
+#endif
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_UTF16le)
         case(UTF_SUB_TYPE::UTF16le):    { static const CUTF_UTF16le  handler; return handler; }
+#endif
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_UTF16be)
         case(UTF_SUB_TYPE::UTF16be):    { static const CUTF_UTF16be  handler; return handler; }
+#endif
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_UCS2le)
         case(UTF_SUB_TYPE::UCS2le):     { static const CUTF_UCS2le   handler; return handler; }
+#endif
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_UCS2be)
         case(UTF_SUB_TYPE::UCS2be):     { static const CUTF_UCS2be   handler; return handler; }
+#endif
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_UTF32le)
         case(UTF_SUB_TYPE::UTF32le):    { static const CUTF_UTF32le  handler; return handler; }
+#endif
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_UTF32be)
         case(UTF_SUB_TYPE::UTF32be):    { static const CUTF_UTF32be  handler; return handler; }
+#endif
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_UCS4le)
         case(UTF_SUB_TYPE::UCS4le):     { static const CUTF_UCS4le   handler; return handler; }
+#endif
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_UCS4be)
         case(UTF_SUB_TYPE::UCS4be):     { static const CUTF_UCS4be   handler; return handler; }
+#endif
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_CESU32le)
         case(UTF_SUB_TYPE::CESU32le):   { static const CUTF_CESU32le handler; return handler; }
+#endif
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_CESU32be)
         case(UTF_SUB_TYPE::CESU32be):   { static const CUTF_CESU32be handler; return handler; }
+#endif
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_CESU4le)
         case(UTF_SUB_TYPE::CESU4le):    { static const CUTF_CESU4le  handler; return handler; }
+#endif
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_CESU4be)
         case(UTF_SUB_TYPE::CESU4be):    { static const CUTF_CESU4be  handler; return handler; }
+#endif
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_BYTE)
         case(UTF_SUB_TYPE::BYTE):       { static const CUTF_BYTE     handler; return handler; }
+#endif
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_BYTEns)
         case(UTF_SUB_TYPE::BYTEns):     { static const CUTF_BYTEns   handler; return handler; }
+#endif
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_ASCII)
         case(UTF_SUB_TYPE::ASCII):      { static const CUTF_ASCII    handler; return handler; }
+#endif
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_ASCIIns)
         case(UTF_SUB_TYPE::ASCIIns):    { static const CUTF_ASCIIns  handler; return handler; }
+#endif
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_CP1252)
         case(UTF_SUB_TYPE::CP1252):     { static const CUTF_CP1252   handler; return handler; }
+#endif
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_CP1252ns)
         case(UTF_SUB_TYPE::CP1252ns):   { static const CUTF_CP1252ns handler; return handler; }
+#endif
+#if (SUITEUTF_SUBTYPES & SUITEUTF_SUBTYPE_CP1252st)
         case(UTF_SUB_TYPE::CP1252st):   { static const CUTF_CP1252st handler; return handler; }
-        default:                        { static const CUTF_JUTF8st  handler; return handler; }
+#endif
+        default:                        { break; }
+    }
+    const ICustomUTFTK* const custom = internal::getCustomHandler(utfSubType);
+    if (custom != nullptr)
+    {
+        return *custom;
     }
+    //  invalid and unavailable sub-types
+    static_assert(isSubTypeAvailable(UTF_SUB_TYPE::SUITEUTF_SUBTYPE_FALLBACK), "SUITEUTF_SUBTYPE_FALLBACK must be included in SUITEUTF_SUBTYPES");
+    return getHandler(UTF_SUB_TYPE::SUITEUTF_SUBTYPE_FALLBACK);
 }
 
 const IUTFTK& IUTFTK::getHandler(const UTF_OTHER_TYPE utfOtherType) noexcept
@@ -0,0 +1,447 @@
+
+//  SuiteUTF
+//  Original design 20102016; maintained and extended 20242025.
+//  Copyright (c) 20102025 Ritchie Brannan.
+//  MIT License. See LICENSE.txt. Project history: docs/History.md.
+//
+//  File:   suiteutf_bench.cpp
+//  Author: Ritchie Brannan
+//  Date:   18 Oct 26
+//  
+//  Description:
+//  
+//      suiteutf-bench: mixed sub-type small message benchmark.
+//  
+//  Notes:
+//  
+//      A synthetic mixed script text is split into messages of about the message size (on code-point boundaries)
+//      and each message is encoded in each of the selected sub-types. Every message is then decoded and encoded
+//      again through the handler of its sub-type, in two orders which do the same work:
+//  
+//          grouped:        all the messages of one sub-type, then all the messages of the next sub-type
+//          interleaved:    each message in every sub-type in turn, switching handler on every message
+//  
+//      The difference between the two rates shows the cost of the handler code competing for the instruction cache
+//      (and branch predictors). Building the library with a smaller SUITEUTF_SUBTYPES subset reduces the code which
+//      can compete, compare the results of a full build and a subset build with the same -t list.
+//  
+//      With -a the adversarial UTF8 inputs are timed instead: long runs of continuation bytes, alternating illegal
+//      and continuation bytes, lead bytes followed by long continuation runs and unpaired CESU surrogates. Each input
+//      is skipped a code-point at a time forwards (step), backwards (back), in small alternating steps (step 2,
+//      back 1) and decoded with get(), through the handlers and through stepUTF8() and backUTF8() without
+//      coalescing. The size is quadrupled twice, the time per byte stays flat if the work is linear in the size.
+//  
+//      Exit status: 0 on success, 2 on a usage error.
+
+#include "suiteutf_tool.h"
+#include <chrono>
+
+namespace
+{
+
+using namespace suiteutf_tool;
+using unicode::unicode_t;
+using unicode::utf::utf_text;
+
+const char* const kUsage =
+    "usage: suiteutf-bench [options]\n"
+    "\n"
+    "  -t, --types LIST    comma separated sub-type names (default: every sub-type in the build)\n"
+    "  -s, --size SIZE     message size in bytes with optional K suffix (default 256)\n"
+    "  -n, --total SIZE    bytes of UTF8 equivalent text per order with optional K, M or G suffix (default 64M)\n"
+    "  -a, --adversarial   time step, back and decode on adversarial UTF8 input at 3 sizes\n"
+    "  -l, --list          list the sub-type names\n"
+    "  -h, --help          show this help\n";
+
+struct bench_options
+{
+    std::vector<UTF_SUB_TYPE>   types;
+    uint32_t                    size = 256;
+    uint32_t                    total = (64u << 20);
+    bool                        adversarial = false;
+};
+
+/// message set for one sub-type
+struct encoded_messages
+{
+    const IUTFTK*           handler;
+    std::vector<uint8_t>    data;
+    std::vector<uint32_t>   starts;     //  message start offsets (with a final end offset)
+};
+
+/// deterministic mixed script sample: mostly ASCII words with Latin-1, Greek, Cyrillic, CJK and emoji runs
+std::vector<unicode_t> makeSample(const uint32_t count)
+{
+    static const unicode_t kBases[6] = { 0x0061, 0x00e0, 0x03b1, 0x0430, 0x4e00, 0x1f600 };
+    static const uint32_t kRanges[6] = { 26, 24, 24, 32, 512, 64 };
+    std::vector<unicode_t> sample;
+    sample.reserve(count);
+    uint32_t seed = 0x2545f491u;
+    while (sample.size() < count)
+    {
+        seed = ((seed * 1664525u) + 1013904223u);
+        const uint32_t script = (((seed >> 24) < 176) ? 0 : (1 + ((seed >> 16) % 5)));
+        const uint32_t length = (2 + ((seed >> 8) & 7));
+        for (uint32_t index = 0; index < length; ++index)
+        {
+            seed = ((seed * 1664525u) + 1013904223u);
+            sample.push_back(kBases[script] + ((seed >> 16) % kRanges[script]));
+        }
+        sample.push_back(((seed & 0x1f) == 0) ? 0x000a : 0x0020);
+    }
+    return sample;
+}
+
+/// encodes the sample messages (replacing code-points the sub-type cannot encode with '?')
+void encodeMessages(const std::vector<unicode_t>& sample, const std::vector<uint32_t>& breaks, encoded_messages& messages)
+{
+    const IUTFTK& handler = *messages.handler;
+    messages.data.resize((sample.size() * 4) + 8);
+    utf_text text = { static_cast<uint32_t>(messages.data.size()), 0, messages.data.data() };
+    messages.starts.clear();
+    for (size_t index = 0; index < sample.size(); ++index)
+    {
+        if (breaks[messages.starts.size()] == index)
+        {
+            messages.starts.push_back(text.offset);
+        }
+        if (handler.write(text, sample[index]).error())
+        {
+            (void)handler.write(text, 0x003f);
+        }
+    }
+    messages.starts.push_back(text.offset);
+}
+
+/// decodes a message and encodes it again through the same handler, returns the code-point count
+uint32_t roundTrip(const IUTFTK& handler, const uint8_t* const data, const uint32_t length, uint8_t* const scratch, const uint32_t capacity) noexcept
+{
+    utf_text src = { length, 0, const_cast<uint8_t*>(data) };
+    utf_text dst = { capacity, 0, scratch };
+    uint32_t count = 0;
+    unicode_t unicode = 0;
+    while ((src.offset < src.length) && handler.read(src, unicode).no_error())
+    {
+        (void)handler.write(dst, unicode);
+        ++count;
+    }
+    return count;
+}
+
+/// adversarial UTF8 input of about the size given
+std::vector<uint8_t> makeAdversarial(const uint32_t pattern, const uint32_t size)
+{
+    std::vector<uint8_t> data;
+    data.reserve(size + 8);
+    while (data.size() < size)
+    {
+        switch (pattern)
+        {
+            case(0):    //  continuation bytes only
+            {
+                data.push_back(0x80u | static_cast<uint8_t>(data.size() & 0x3f));
+                break;
+            }
+            case(1):    //  alternating illegal and continuation bytes
+            {
+                data.push_back(0xffu);
+                data.push_back(0x80u);
+                break;
+            }
+            case(2):    //  a lead byte followed by a long continuation run
+            {
+                data.push_back(0xc3u);
+                data.insert(data.end(), 4095, 0xa9u);
+                break;
+            }
+            default:    //  unpaired CESU high surrogates
+            {
+                data.push_back(0xedu);
+                data.push_back(0xa0u);
+                data.push_back(0x80u);
+                break;
+            }
+        }
+    }
+    return data;
+}
+
+/// skips or decodes the whole text (ops 4 and 5 step and back without coalescing, returns the code-points counted)
+uint64_t runAdversarial(const IUTFTK& handler, const uint32_t op, utf_text text) noexcept
+{
+    using unicode::utf::toolkit::backUTF8;
+    using unicode::utf::toolkit::stepUTF8;
+    const uint32_t index = static_cast<uint32_t>(handler.utfSubType());
+    const bool cesu = (index >= static_cast<uint32_t>(UTF_SUB_TYPE::CESU8));
+    const bool java = ((index % 6) >= 3);
+    const bool strict = ((index % 3) == 2);
+    uint64_t points = 0;
+    uint32_t count = 0;
+    switch (op)
+    {
+        case(0):    //  step
+        {
+            while ((count = handler.step(text, 1)) != 0)
+            {
+                points += count;
+            }
+            break;
+        }
+        case(1):    //  back
+        {
+            text.offset = text.length;
+            while ((count = handler.back(text, 1)) != 0)
+            {
+                points += count;
+            }
+            break;
+        }
+        case(2):    //  step 2, back 1
+        {
+            while (handler.step(text, 2) == 2)
+            {
+                points += handler.back(text, 1);
+            }
+            break;
+        }
+        case(3):    //  decode
+        {
+            while (text.offset < text.length)
+            {
+                unicode_t unicode = 0;
+                uint32_t bytes = 0;
+                (void)handler.get(text, unicode, bytes);
+                text.offset += (bytes ? bytes : 1);
+                ++points;
+            }
+            break;
+        }
+        case(4):    //  step without coalescing
+        {
+            while ((count = stepUTF8(text, 1, cesu, java, strict, false)) != 0)
+            {
+                points += count;
+            }
+            break;
+        }
+        default:    //  back without coalescing
+        {
+            text.offset = text.length;
+            while ((count = backUTF8(text, 1, cesu, java, strict, false)) != 0)
+            {
+                points += count;
+            }
+            break;
+        }
+    }
+    return points;
+}
+
+/// times the adversarial inputs at 3 sizes (the time per byte is flat when the work is linear)
+void benchAdversarial(const bench_options& options)
+{
+    static const char* const kPatterns[4] = { "continuation", "illegal", "long-run", "surrogates" };
+    static const char* const kOps[6] = { "step", "back", "step2back1", "decode", "step-nc", "back-nc" };
+    const uint32_t base = (16u << 10);
+    printf("ns per byte at %uK, %uK and %uK bytes\n", (base >> 10), (base >> 8), (base >> 6));
+    for (const UTF_SUB_TYPE type : options.types)
+    {
+        const IUTFTK& handler = IUTFTK::getHandler(type);
+        for (uint32_t pattern = 0; pattern < 4; ++pattern)
+        {
+            for (uint32_t op = 0; op < 6; ++op)
+            {
+                printf("%-10s %-13s %-11s", subTypeName(type), kPatterns[pattern], kOps[op]);
+                for (uint32_t size = base; size <= (base << 4); size <<= 2)
+                {
+                    std::vector<uint8_t> data = makeAdversarial(pattern, size);
+                    const utf_text text = { static_cast<uint32_t>(data.size()), 0, data.data() };
+                    const uint32_t repeats = (((options.total >> 4) / static_cast<uint32_t>(data.size())) + 1);
+                    const auto start = std::chrono::steady_clock::now();
+                    for (uint32_t repeat = 0; repeat < repeats; ++repeat)
+                    {
+                        (void)runAdversarial(handler, op, text);
+                    }
+                    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                    printf(" %8.2f", ((seconds * 1e9) / (static_cast<double>(data.size()) * repeats)));
+                }
+                printf("\n");
+            }
+        }
+    }
+}
+
+bool parseTypes(const char* const list, std::vector<UTF_SUB_TYPE>& types)
+{
+    std::string name;
+    for (const char* scan = list;; ++scan)
+    {
+        if ((*scan == ',') || (*scan == 0))
+        {
+            UTF_SUB_TYPE type;
+            if (!findSubType(name.c_str(), type))
+            {
+                fprintf(stderr, "suiteutf-bench: unknown sub-type '%s' (use --list)\n", name.c_str());
+                return false;
+            }
+            types.push_back(type);
+            name.clear();
+            if (*scan == 0)
+            {
+                return true;
+            }
+        }
+        else
+        {
+            name += *scan;
+        }
+    }
+}
+
+bool parseOptions(const int argc, char** const argv, bench_options& options, int& status)
+{
+    status = 2;
+    for (int index = 1; index < argc; ++index)
+    {
+        const char* const arg = argv[index];
+        const char* const value = ((index + 1) < argc) ? argv[index + 1] : nullptr;
+        if (!strcmp(arg, "-h") || !strcmp(arg, "--help"))
+        {
+            fputs(kUsage, stdout);
+            status = 0;
+            return false;
+        }
+        else if (!strcmp(arg, "-a") || !strcmp(arg, "--adversarial"))
+        {
+            options.adversarial = true;
+        }
+        else if (!strcmp(arg, "-l") || !strcmp(arg, "--list"))
+        {
+            listSubTypes(stdout);
+            status = 0;
+            return false;
+        }
+        else if (!strcmp(arg, "-t") || !strcmp(arg, "--types"))
+        {
+            if ((value == nullptr) || !parseTypes(value, options.types))
+            {
+                return false;
+            }
+            ++index;
+        }
+        else if (!strcmp(arg, "-s") || !strcmp(arg, "--size"))
+        {
+            if ((value == nullptr) || !parseSize(value, options.size) || (options.size > 0x100000u))
+            {
+                fputs("suiteutf-bench: invalid message size (1 to 1M)\n", stderr);
+                return false;
+            }
+            ++index;
+        }
+        else if (!strcmp(arg, "-n") || !strcmp(arg, "--total"))
+        {
+            if ((value == nullptr) || !parseSize(value, options.total))
+            {
+                fputs("suiteutf-bench: invalid total size\n", stderr);
+                return false;
+            }
+            ++index;
+        }
+        else
+        {
+            fprintf(stderr, "suiteutf-bench: unknown option '%s'\n%s", arg, kUsage);
+            return false;
+        }
+    }
+    if (options.types.empty())
+    {
+        for (const sub_type_name& entry : kSubTypeNames)
+        {
+            if (unicode::utf::toolkit::isSubTypeAvailable(entry.type) && (!options.adversarial || (entry.type <= UTF_SUB_TYPE::JCESU8st)))
+            {
+                options.types.push_back(entry.type);
+            }
+        }
+    }
+    return true;
+}
+
+};  //  anonymous namespace
+
+int main(int argc, char** argv)
+{
+    bench_options options;
+    int status = 0;
+    if (!parseOptions(argc, argv, options, status))
+    {
+        return status;
+    }
+    if (options.adversarial)
+    {
+        benchAdversarial(options);
+        return 0;
+    }
+
+    //  build the sample and split it into messages of about options.size UTF8 bytes
+    const std::vector<unicode_t> sample = makeSample(1u << 16);
+    const IUTFTK& utf8 = IUTFTK::getHandler(UTF_SUB_TYPE::UTF8st);
+    std::vector<uint32_t> breaks;
+    uint32_t bytes = 0;
+    uint32_t sampleBytes = 0;
+    for (size_t index = 0; index < sample.size(); ++index)
+    {
+        if ((index == 0) || (bytes >= options.size))
+        {
+            breaks.push_back(static_cast<uint32_t>(index));
+            bytes = 0;
+        }
+        bytes += utf8.len(sample[index]);
+        sampleBytes += utf8.len(sample[index]);
+    }
+    breaks.push_back(static_cast<uint32_t>(sample.size()));
+    const size_t count = (breaks.size() - 1);
+
+    std::vector<encoded_messages> sets(options.types.size());
+    for (size_t index = 0; index < sets.size(); ++index)
+    {
+        sets[index].handler = &IUTFTK::getHandler(options.types[index]);
+        encodeMessages(sample, breaks, sets[index]);
+    }
+    std::vector<uint8_t> scratch((options.size * 4) + 64);
+    const uint32_t capacity = static_cast<uint32_t>(scratch.size());
+    const uint64_t perPass = (static_cast<uint64_t>(sampleBytes) * sets.size());
+    const uint32_t passes = static_cast<uint32_t>((options.total + perPass - 1) / perPass);
+
+    printf("sub-types: %u, messages: %u of about %u bytes, passes: %u\n", static_cast<uint32_t>(sets.size()), static_cast<uint32_t>(count), options.size, passes);
+    for (uint32_t order = 0; order < 2; ++order)
+    {
+        uint64_t points = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t pass = 0; pass < passes; ++pass)
+        {
+            if (order == 0)
+            {   //  grouped
+                for (const encoded_messages& set : sets)
+                {
+                    for (size_t message = 0; message < count; ++message)
+                    {
+                        points += roundTrip(*set.handler, (set.data.data() + set.starts[message]), (set.starts[message + 1] - set.starts[message]), scratch.data(), capacity);
+                    }
+                }
+            }
+            else
+            {   //  interleaved
+                for (size_t message = 0; message < count; ++message)
+                {
+                    for (const encoded_messages& set : sets)
+                    {
+                        points += roundTrip(*set.handler, (set.data.data() + set.starts[message]), (set.starts[message + 1] - set.starts[message]), scratch.data(), capacity);
+                    }
+                }
+            }
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        printf("%-12s %8.1f M code-points/s  (%.3f s)\n", ((order == 0) ? "grouped:" : "interleaved:"), ((static_cast<double>(points) / seconds) * 1e-6), seconds);
+    }
+    return 0;
+}
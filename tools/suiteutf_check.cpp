@@ -0,0 +1,523 @@
+
+//  SuiteUTF
+//  Original design 20102016; maintained and extended 20242025.
+//  Copyright (c) 20102025 Ritchie Brannan.
+//  MIT License. See LICENSE.txt. Project history: docs/History.md.
+//
+//  File:   suiteutf_check.cpp
+//  Author: Ritchie Brannan
+//  Date:   18 Oct 26
+//  
+//  Description:
+//  
+//      suiteutf-check: parallel validation of files and directory trees against a UTF_SUB_TYPE encoding.
+//  
+//  Notes:
+//  
+//      The main thread walks the paths given and feeds the files found to a fixed pool of worker threads through a
+//      bounded queue, so memory use does not grow with the number of files.
+//  
+//      Each file is memory mapped where possible (otherwise streamed through a fixed size window) and validated with
+//      bulk::validate() in segments split with bulk::getChunk(). Line and column numbers are only computed for files
+//      which fail, by rescanning the file up to the failing code-point with bulk::tracking_reader.
+//  
+//      Results are written as each file completes, so the output order is not deterministic when more than one
+//      worker thread is used.
+//  
+//      Exit status: 0 if every file is valid, 1 if any file is invalid, 2 on a usage or I/O error.
+
+#include "suiteutf_tool.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+
+using namespace suiteutf_tool;
+namespace bulk = unicode::utf::bulk;
+using unicode::utf::utf_text;
+using unicode::utf::UTF_TYPE;
+
+const char* const kUsage =
+    "usage: suiteutf-check [options] path...\n"
+    "\n"
+    "  -f, --from NAME     expected sub-type (default UTF8st)\n"
+    "      --detect        identify each file's type from a BOM or leading ASCII, FROM is used if unidentified\n"
+    "  -e, --errors-only   only check for errors (warnings are not computed or reported)\n"
+    "      --json          write the results as a JSON array\n"
+    "  -q, --quiet         only report files which are invalid or cannot be read\n"
+    "  -j, --threads N     worker thread count (default: hardware concurrency)\n"
+    "  -l, --list          list the sub-type names\n"
+    "  -v, --verbose       report a summary on stderr\n"
+    "  -h, --help          show this help\n"
+    "\n"
+    "Directories are walked recursively, symbolic links to directories are not followed.\n";
+
+/// segment size used to split the validation of mapped and streamed files
+const uint32_t kMappedSegment = (256u << 20);
+const uint32_t kStreamSegment = (4u << 20);
+
+struct check_options
+{
+    UTF_SUB_TYPE                from = UTF_SUB_TYPE::UTF8st;
+    bool                        detect = false;
+    bool                        errors_only = false;
+    bool                        json = false;
+    bool                        quiet = false;
+    bool                        verbose = false;
+    uint32_t                    threads = 0;
+    std::vector<const char*>    paths;
+};
+
+struct file_result
+{
+    UTF_SUB_TYPE    type = UTF_SUB_TYPE::UTF8st;
+    uint64_t        size = 0;
+    uint64_t        offset = 0;     //  byte offset of the failing code-point
+    uint64_t        line = 0;       //  1 based line of the failing code-point (0 if unknown)
+    uint64_t        column = 0;     //  1 based code-point column of the failing code-point (0 if unknown)
+    cp_errors       errors;
+    bool            readable = true;
+};
+
+/// bounded multiple producer, multiple consumer path queue
+class path_queue
+{
+public:
+    explicit path_queue(const size_t capacity) : m_capacity(capacity), m_closed(false) {}
+    void push(std::string&& path)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_not_full.wait(lock, [this]() { return (m_paths.size() < m_capacity); });
+        m_paths.push_back(std::move(path));
+        m_not_empty.notify_one();
+    }
+    bool pop(std::string& path)
+    {   //  returns false once the queue is closed and empty
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_not_empty.wait(lock, [this]() { return (m_closed || !m_paths.empty()); });
+        if (m_paths.empty())
+        {
+            return false;
+        }
+        path = std::move(m_paths.front());
+        m_paths.pop_front();
+        m_not_full.notify_one();
+        return true;
+    }
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closed = true;
+        m_not_empty.notify_all();
+    }
+private:
+    std::mutex              m_mutex;
+    std::condition_variable m_not_empty;
+    std::condition_variable m_not_full;
+    std::deque<std::string> m_paths;
+    size_t                  m_capacity;
+    bool                    m_closed;
+};
+
+/// returns the size of the next segment of the window, split at a safe boundary unless the window reaches the end of the input
+uint32_t planSegment(const IUTFTK& handler, const input_window& input, const uint32_t segment) noexcept
+{
+    const uint32_t length = (input.size & ~(handler.unitSize() - 1));
+    uint32_t size = length;
+    if (!input.eof && (length != 0))
+    {
+        const utf_text window = { length, 0, const_cast<uint8_t*>(input.data) };
+        utf_text chunk;
+        uint32_t bytes = 0;
+        if (bulk::getChunk(handler, window, chunk, bytes, segment).none())
+        {
+            size = bytes;
+        }
+    }
+    return size;
+}
+
+/// validates the input, returns false on a read error
+bool validateInput(const IUTFTK*& handler, const check_options& options, input_window& input, const uint32_t segment, file_result& result) noexcept
+{
+    bool first = true;
+    for (;;)
+    {
+        if (!input.fill())
+        {
+            return false;
+        }
+        if (first)
+        {
+            first = false;
+            if (options.detect)
+            {
+                uint32_t bytes = 0;
+                const UTF_TYPE type = unicode::utf::identifyUTF(input.data, input.size, bytes);
+                if ((type != UTF_TYPE::OTHER) && (type != handler->utfType()))
+                {
+                    handler = &IUTFTK::getHandler(type);
+                }
+            }
+        }
+        if (input.size == 0)
+        {
+            return true;
+        }
+        const uint32_t size = planSegment(*handler, input, segment);
+        utf_text text = { size, 0, const_cast<uint8_t*>(input.data) };
+        const cp_errors errors = bulk::validate(*handler, text, (options.errors_only ? bulk::kNoDiagnostics : bulk::kAllDiagnostics));
+        result.errors |= errors;
+        if (errors.error())
+        {
+            result.offset = (input.base + text.offset);
+            return true;
+        }
+        if (input.eof && (size != input.size))
+        {   //  incomplete code-unit at the end of the input
+            result.errors |= (cp_errors::bits::Failed | cp_errors::bits::ReadTruncated);
+            result.offset = (input.base + size);
+            return true;
+        }
+        input.consume(size);
+    }
+}
+
+/// counts the lines and columns up to the failing code-point, returns false on a read error
+bool locateInput(const IUTFTK& handler, input_window& input, const uint32_t segment, file_result& result) noexcept
+{
+    uint64_t line = 1;
+    uint64_t column = 1;
+    while (input.base < result.offset)
+    {
+        if (!input.fill())
+        {
+            return false;
+        }
+        const uint64_t remaining = (result.offset - input.base);
+        const uint32_t planned = planSegment(handler, input, segment);
+        const uint32_t size = ((remaining < planned) ? static_cast<uint32_t>(remaining) : planned);
+        if (size == 0)
+        {
+            break;
+        }
+        bulk::tracking_reader reader(handler, { planned, 0, const_cast<uint8_t*>(input.data) });
+        (void)reader.advance(size);
+        const bulk::text_position& position = reader.position();
+        if (position.line != 0)
+        {
+            line += position.line;
+            column = 1;
+        }
+        column += position.column;
+        input.consume(size);
+    }
+    result.line = line;
+    result.column = column;
+    return true;
+}
+
+/// opens the file and runs check() over a mapped or streamed input window, returns false if the file cannot be read
+template <typename Check>
+bool withInput(const std::string& path, Check&& check)
+{
+    mapped_file mapping;
+    if (mapping.open(path.c_str()))
+    {
+        input_window input(mapping.data(), mapping.size(), (kMappedSegment << 1));
+        return check(input, kMappedSegment);
+    }
+    const int fd = openRead(path.c_str());
+    if (fd < 0)
+    {
+        return false;
+    }
+    input_window input(fd, (kStreamSegment << 1));
+    const bool success = check(input, kStreamSegment);
+    closeFile(fd);
+    return success;
+}
+
+void checkFile(const std::string& path, const check_options& options, file_result& result)
+{
+    const IUTFTK* handler = &IUTFTK::getHandler(options.from);
+    result.readable = withInput(path, [&](input_window& input, const uint32_t segment)
+    {
+        return validateInput(handler, options, input, segment, result);
+    });
+    if (result.readable && !fileSize(path.c_str(), result.size))
+    {
+        result.size = 0;
+    }
+    result.type = handler->utfSubType();
+    if (result.readable && result.errors.error())
+    {
+        if (!withInput(path, [&](input_window& input, const uint32_t segment) { return locateInput(*handler, input, segment, result); }))
+        {
+            result.line = 0;
+            result.column = 0;
+        }
+    }
+}
+
+void appendJsonString(std::string& text, const std::string& string)
+{   //  bytes which are not valid UTF-8 are passed through unchanged
+    text += '"';
+    for (const char c : string)
+    {
+        const unsigned char byte = static_cast<unsigned char>(c);
+        if ((byte == '"') || (byte == '\\'))
+        {
+            text += '\\';
+            text += c;
+        }
+        else if (byte < 0x20)
+        {
+            char escape[8];
+            snprintf(escape, sizeof(escape), "\\u%04x", byte);
+            text += escape;
+        }
+        else
+        {
+            text += c;
+        }
+    }
+    text += '"';
+}
+
+void formatResult(const std::string& path, const check_options& options, const file_result& result, std::string& text)
+{
+    char number[96];
+    const bool valid = (result.readable && result.errors.no_error());
+    if (options.json)
+    {
+        text += "  {\"path\": ";
+        appendJsonString(text, path);
+        if (!result.readable)
+        {
+            text += ", \"readable\": false}";
+            return;
+        }
+        snprintf(number, sizeof(number), ", \"type\": \"%s\", \"size\": %llu, \"valid\": %s, \"cp_errors\": \"0x%08x\"", subTypeName(result.type),
+            static_cast<unsigned long long>(result.size), (valid ? "true" : "false"), static_cast<unsigned int>(result.errors.raw()));
+        text += number;
+        text += ", \"errors\": \"";
+        appendErrors(text, result.errors.errors_only());
+        text += "\", \"warnings\": \"";
+        appendErrors(text, result.errors.warnings_only());
+        text += '"';
+        if (!valid)
+        {
+            snprintf(number, sizeof(number), ", \"offset\": %llu, \"line\": %llu, \"column\": %llu",
+                static_cast<unsigned long long>(result.offset), static_cast<unsigned long long>(result.line), static_cast<unsigned long long>(result.column));
+            text += number;
+        }
+        text += '}';
+        return;
+    }
+    text += path;
+    if (!result.readable)
+    {
+        text += ": ERROR cannot read file\n";
+        return;
+    }
+    if (valid)
+    {
+        text += ": OK (";
+        text += subTypeName(result.type);
+        text += ')';
+        if (result.errors.any())
+        {
+            text += " warnings: ";
+            appendErrors(text, result.errors.warnings_only());
+        }
+        text += '\n';
+        return;
+    }
+    snprintf(number, sizeof(number), " at byte %llu", static_cast<unsigned long long>(result.offset));
+    text += ": FAIL (";
+    text += subTypeName(result.type);
+    text += ')';
+    text += number;
+    if (result.line != 0)
+    {
+        snprintf(number, sizeof(number), ", line %llu, column %llu", static_cast<unsigned long long>(result.line), static_cast<unsigned long long>(result.column));
+        text += number;
+    }
+    text += ": ";
+    appendErrors(text, result.errors.errors_only());
+    text += '\n';
+}
+
+bool parseOptions(const int argc, char** const argv, check_options& options, int& status)
+{
+    status = 2;
+    for (int index = 1; index < argc; ++index)
+    {
+        const char* const arg = argv[index];
+        const char* const value = ((index + 1) < argc) ? argv[index + 1] : nullptr;
+        if (!strcmp(arg, "-h") || !strcmp(arg, "--help"))
+        {
+            fputs(kUsage, stdout);
+            status = 0;
+            return false;
+        }
+        else if (!strcmp(arg, "-l") || !strcmp(arg, "--list"))
+        {
+            listSubTypes(stdout);
+            status = 0;
+            return false;
+        }
+        else if (!strcmp(arg, "-f") || !strcmp(arg, "--from"))
+        {
+            if ((value == nullptr) || !findSubType(value, options.from))
+            {
+                fprintf(stderr, "suiteutf-check: unknown sub-type '%s' (use --list)\n", value ? value : "");
+                return false;
+            }
+            ++index;
+        }
+        else if (!strcmp(arg, "-j") || !strcmp(arg, "--threads"))
+        {
+            if ((value == nullptr) || (atoi(value) <= 0))
+            {
+                fputs("suiteutf-check: invalid thread count\n", stderr);
+                return false;
+            }
+            options.threads = static_cast<uint32_t>(atoi(value));
+            ++index;
+        }
+        else if (!strcmp(arg, "--detect"))    { options.detect = true; }
+        else if (!strcmp(arg, "--json"))      { options.json = true; }
+        else if (!strcmp(arg, "-e") || !strcmp(arg, "--errors-only")) { options.errors_only = true; }
+        else if (!strcmp(arg, "-q") || !strcmp(arg, "--quiet"))   { options.quiet = true; }
+        else if (!strcmp(arg, "-v") || !strcmp(arg, "--verbose")) { options.verbose = true; }
+        else if ((arg[0] == '-') && (arg[1] != 0))
+        {
+            fprintf(stderr, "suiteutf-check: unknown option '%s'\n%s", arg, kUsage);
+            return false;
+        }
+        else
+        {
+            options.paths.push_back(arg);
+        }
+    }
+    if (options.paths.empty())
+    {
+        fputs(kUsage, stderr);
+        return false;
+    }
+    if (options.threads == 0)
+    {
+        const unsigned int cores = std::thread::hardware_concurrency();
+        options.threads = ((cores != 0) ? ((cores < 64) ? cores : 64) : 1);
+    }
+    if (options.threads > 256)
+    {
+        options.threads = 256;
+    }
+    return true;
+}
+
+};  //  anonymous namespace
+
+int main(int argc, char** argv)
+{
+    check_options options;
+    int status = 0;
+    if (!parseOptions(argc, argv, options, status))
+    {
+        return status;
+    }
+    std::mutex output;
+    std::atomic<uint64_t> files(0);
+    std::atomic<uint64_t> invalid(0);
+    std::atomic<uint64_t> unreadable(0);
+    std::atomic<uint64_t> bytes(0);
+    bool first = true;
+    auto report = [&](const std::string& path, const file_result& result)
+    {
+        ++files;
+        bytes += result.size;
+        const bool valid = (result.readable && result.errors.no_error());
+        if (!result.readable)
+        {
+            ++unreadable;
+        }
+        else if (!valid)
+        {
+            ++invalid;
+        }
+        if (!valid || !options.quiet)
+        {
+            std::string text;
+            formatResult(path, options, result, text);
+            std::lock_guard<std::mutex> lock(output);
+            if (options.json)
+            {
+                fputs(first ? "\n" : ",\n", stdout);
+                first = false;
+            }
+            fwrite(text.data(), 1, text.size(), stdout);
+        }
+    };
+    path_queue queue(static_cast<size_t>(options.threads) * 64);
+    auto worker = [&]()
+    {
+        std::string path;
+        while (queue.pop(path))
+        {
+            file_result result;
+            checkFile(path, options, result);
+            report(path, result);
+        }
+    };
+    std::vector<std::thread> pool;
+    for (uint32_t index = 0; index < options.threads; ++index)
+    {
+        pool.emplace_back(worker);
+    }
+    if (options.json)
+    {
+        fputs("[", stdout);
+    }
+    bool missing = false;
+    for (const char* const path : options.paths)
+    {
+        auto onFile = [&](const std::string& file) { queue.push(std::string(file)); };
+        auto onError = [&](const std::string& directory)
+        {
+            file_result result;
+            result.readable = false;
+            report(directory, result);
+        };
+        if (!walkFiles(std::string(path), onFile, onError))
+        {
+            fprintf(stderr, "suiteutf-check: '%s' does not exist\n", path);
+            missing = true;
+        }
+    }
+    queue.close();
+    for (std::thread& thread : pool)
+    {
+        thread.join();
+    }
+    if (options.json)
+    {
+        fputs(first ? "]\n" : "\n]\n", stdout);
+    }
+    if (options.verbose)
+    {
+        fprintf(stderr, "suiteutf-check: %llu files, %llu bytes, %llu invalid, %llu unreadable\n", static_cast<unsigned long long>(files.load()),
+            static_cast<unsigned long long>(bytes.load()), static_cast<unsigned long long>(invalid.load()), static_cast<unsigned long long>(unreadable.load()));
+    }
+    if (missing || (unreadable != 0))
+    {
+        return 2;
+    }
+    return ((invalid != 0) ? 1 : 0);
+}
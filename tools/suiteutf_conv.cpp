@@ -0,0 +1,454 @@
+
+//  SuiteUTF
+//  Original design 20102016; maintained and extended 20242025.
+//  Copyright (c) 20102025 Ritchie Brannan.
+//  MIT License. See LICENSE.txt. Project history: docs/History.md.
+//
+//  File:   suiteutf_conv.cpp
+//  Author: Ritchie Brannan
+//  Date:   18 Oct 26
+//  
+//  Description:
+//  
+//      suiteutf-conv: iconv style converter between any two UTF_SUB_TYPE encodings.
+//  
+//  Notes:
+//  
+//      Regular input files are memory mapped, other inputs (including stdin) are streamed through a fixed size
+//      window so memory use is bounded by the window size and the per-chunk output buffers.
+//  
+//      Each window is split into chunks with bulk::readChunk() and the chunks are transcoded in parallel with
+//      bulk::transcode() or bulk::repair(). The chunk boundaries never split a code-point, a surrogate pair or a
+//      line-feed pairing, so the output is identical to a single threaded conversion.
+//  
+//      A chunk which reaches the end of a window is held back and carried into the next window unless the end of
+//      the input has been reached.
+//  
+//      Exit status: 0 on success, 1 if the input could not be converted, 2 on a usage or I/O error.
+
+#include "suiteutf_tool.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+using namespace suiteutf_tool;
+namespace bulk = unicode::utf::bulk;
+using unicode::unicode_t;
+using unicode::utf::utf_text;
+using unicode::utf::UTF_TYPE;
+
+const char* const kUsage =
+    "usage: suiteutf-conv [options] [-f FROM] [-t TO] [input]\n"
+    "\n"
+    "  -f, --from NAME     source sub-type (default UTF8st)\n"
+    "  -t, --to NAME       target sub-type (default UTF8st)\n"
+    "  -o, --output FILE   write to FILE instead of stdout\n"
+    "      --detect        identify the source type from a BOM or leading ASCII, FROM is used if unidentified\n"
+    "      --add-bom       write a byte order marker (a source byte order marker is not duplicated)\n"
+    "      --strip-bom     remove a source byte order marker\n"
+    "      --nlf           normalise all line-feed variants to 0x0a\n"
+    "      --repair        replace undecodable and unencodable code-points with U+FFFD\n"
+    "      --store MODE    output store mode: auto, cached or nt (non-temporal) (default auto)\n"
+    "  -j, --threads N     worker thread count (default: hardware concurrency)\n"
+    "      --chunk SIZE    chunk size per worker with optional K, M or G suffix (default 4M)\n"
+    "  -l, --list          list the sub-type names\n"
+    "  -v, --verbose       report statistics on stderr\n"
+    "  -h, --help          show this help\n"
+    "\n"
+    "Reads stdin if no input is given or the input is '-'.\n";
+
+struct conv_options
+{
+    UTF_SUB_TYPE    from = UTF_SUB_TYPE::UTF8st;
+    UTF_SUB_TYPE    to = UTF_SUB_TYPE::UTF8st;
+    bool            detect = false;
+    bool            add_bom = false;
+    bool            strip_bom = false;
+    bool            use_nlf = false;
+    bool            use_repair = false;
+    bulk::StoreMode store = bulk::StoreMode::Automatic;
+    bool            verbose = false;
+    uint32_t        threads = 0;
+    uint32_t        chunk = (4u << 20);
+    const char*     input = nullptr;
+    const char*     output = nullptr;
+};
+
+/// chunk transcoding job
+struct chunk_job
+{
+    utf_text                src;        //  chunk view (offset is advanced by the transcode)
+    uint32_t                start;      //  offset of the chunk in the window
+    bool                    final;      //  a truncated sequence at the end of the chunk cannot be completed by more input
+    std::vector<uint8_t>    output;
+    uint32_t                used;
+    uint32_t                repairs;
+    cp_errors               errors;
+};
+
+cp_errors writeReplacement(const IUTFTK& to, utf_text& dst) noexcept
+{
+    cp_errors errors = to.write(dst, 0xfffd);
+    if (errors.error() && errors.none(cp_errors::bits::WriteOverflow))
+    {
+        errors = to.write(dst, 0x003f);
+    }
+    return errors;
+}
+
+void runJob(const IUTFTK& from, const IUTFTK& to, const conv_options& options, chunk_job& job)
+{
+    job.used = 0;
+    job.repairs = 0;
+    cp_errors warnings;
+    const uint32_t initial = ((job.src.length + (job.src.length >> 1) + 64) & ~7u);
+    if (job.output.size() < initial)
+    {
+        job.output.resize(initial);
+    }
+    for (;;)
+    {
+        utf_text dst = { static_cast<uint32_t>(job.output.size()), job.used, job.output.data() };
+        uint32_t repairs = 0;
+        cp_errors errors = (options.use_repair ? bulk::repair(from, job.src, to, dst, repairs, options.use_nlf, options.store) : bulk::transcode(from, job.src, to, dst, options.use_nlf, options.store));
+        job.used = dst.offset;
+        job.repairs += repairs;
+        warnings |= errors.warnings_only();
+        if (errors.any(cp_errors::bits::ReadTruncated) && job.final && options.use_repair)
+        {   //  nothing can follow the truncated sequence: replace it
+            errors = writeReplacement(to, dst);
+            if (errors.none(cp_errors::bits::WriteOverflow))
+            {
+                job.used = dst.offset;
+                job.src.offset = job.src.length;
+                ++job.repairs;
+            }
+        }
+        if (errors.any(cp_errors::bits::WriteOverflow) && (job.output.size() < 0x40000000u))
+        {
+            job.output.resize(job.output.size() << 1);
+            continue;
+        }
+        job.errors = (errors.errors_only() | warnings);
+        break;
+    }
+}
+
+void runJobs(const IUTFTK& from, const IUTFTK& to, const conv_options& options, std::vector<chunk_job>& jobs, const uint32_t count)
+{
+    std::atomic<uint32_t> next(0);
+    auto worker = [&]()
+    {
+        for (uint32_t index = next++; index < count; index = next++)
+        {
+            runJob(from, to, options, jobs[index]);
+        }
+    };
+    const uint32_t threads = ((options.threads < count) ? options.threads : count);
+    std::vector<std::thread> pool;
+    for (uint32_t index = 1; index < threads; ++index)
+    {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : pool)
+    {
+        thread.join();
+    }
+}
+
+bool parseOptions(const int argc, char** const argv, conv_options& options, int& status)
+{
+    status = 2;
+    for (int index = 1; index < argc; ++index)
+    {
+        const char* const arg = argv[index];
+        const char* const value = ((index + 1) < argc) ? argv[index + 1] : nullptr;
+        if (!strcmp(arg, "-h") || !strcmp(arg, "--help"))
+        {
+            fputs(kUsage, stdout);
+            status = 0;
+            return false;
+        }
+        else if (!strcmp(arg, "-l") || !strcmp(arg, "--list"))
+        {
+            listSubTypes(stdout);
+            status = 0;
+            return false;
+        }
+        else if (!strcmp(arg, "-f") || !strcmp(arg, "--from") || !strcmp(arg, "-t") || !strcmp(arg, "--to"))
+        {
+            UTF_SUB_TYPE& type = ((arg[1] == 'f') || (arg[2] == 'f')) ? options.from : options.to;
+            if ((value == nullptr) || !findSubType(value, type))
+            {
+                fprintf(stderr, "suiteutf-conv: unknown sub-type '%s' (use --list)\n", value ? value : "");
+                return false;
+            }
+            ++index;
+        }
+        else if (!strcmp(arg, "-o") || !strcmp(arg, "--output"))
+        {
+            if (value == nullptr)
+            {
+                fputs("suiteutf-conv: missing output file\n", stderr);
+                return false;
+            }
+            options.output = value;
+            ++index;
+        }
+        else if (!strcmp(arg, "-j") || !strcmp(arg, "--threads"))
+        {
+            if ((value == nullptr) || (atoi(value) <= 0))
+            {
+                fputs("suiteutf-conv: invalid thread count\n", stderr);
+                return false;
+            }
+            options.threads = static_cast<uint32_t>(atoi(value));
+            ++index;
+        }
+        else if (!strcmp(arg, "--chunk"))
+        {
+            if ((value == nullptr) || !parseSize(value, options.chunk) || (options.chunk > 0x10000000u))
+            {
+                fputs("suiteutf-conv: invalid chunk size (1 to 256M)\n", stderr);
+                return false;
+            }
+            ++index;
+        }
+        else if (!strcmp(arg, "--store"))
+        {
+            if ((value != nullptr) && !strcmp(value, "auto"))        { options.store = bulk::StoreMode::Automatic; }
+            else if ((value != nullptr) && !strcmp(value, "cached")) { options.store = bulk::StoreMode::Cached; }
+            else if ((value != nullptr) && !strcmp(value, "nt"))     { options.store = bulk::StoreMode::NonTemporal; }
+            else
+            {
+                fputs("suiteutf-conv: invalid store mode (auto, cached or nt)\n", stderr);
+                return false;
+            }
+            ++index;
+        }
+        else if (!strcmp(arg, "--detect"))     { options.detect = true; }
+        else if (!strcmp(arg, "--add-bom"))    { options.add_bom = true; }
+        else if (!strcmp(arg, "--strip-bom"))  { options.strip_bom = true; }
+        else if (!strcmp(arg, "--nlf"))        { options.use_nlf = true; }
+        else if (!strcmp(arg, "--repair"))     { options.use_repair = true; }
+        else if (!strcmp(arg, "-v") || !strcmp(arg, "--verbose")) { options.verbose = true; }
+        else if ((arg[0] == '-') && (arg[1] != 0))
+        {
+            fprintf(stderr, "suiteutf-conv: unknown option '%s'\n%s", arg, kUsage);
+            return false;
+        }
+        else if (options.input == nullptr)
+        {
+            options.input = arg;
+        }
+        else
+        {
+            fputs("suiteutf-conv: only one input may be given\n", stderr);
+            return false;
+        }
+    }
+    if (options.threads == 0)
+    {
+        const unsigned int cores = std::thread::hardware_concurrency();
+        options.threads = ((cores != 0) ? ((cores < 64) ? cores : 64) : 1);
+    }
+    if (options.threads > 256)
+    {
+        options.threads = 256;
+    }
+    options.chunk = ((options.chunk + 7) & ~7u);
+    return true;
+}
+
+void reportError(const conv_options& options, const uint64_t offset, const cp_errors errors)
+{
+    std::string text;
+    appendErrors(text, errors.errors_only());
+    fprintf(stderr, "suiteutf-conv: %s: cannot convert at byte offset %llu: %s\n", (options.input ? options.input : "stdin"), static_cast<unsigned long long>(offset), text.c_str());
+}
+
+int convert(const conv_options& options, input_window& input, const int out)
+{
+    const IUTFTK* from = &IUTFTK::getHandler(options.from);
+    const IUTFTK& to = IUTFTK::getHandler(options.to);
+    std::vector<chunk_job> jobs;
+    cp_errors warnings;
+    uint64_t written = 0;
+    uint64_t repairs = 0;
+    bool first = true;
+    for (;;)
+    {
+        if (!input.fill())
+        {
+            fputs("suiteutf-conv: read error\n", stderr);
+            return 2;
+        }
+        if (first)
+        {   //  source identification and byte order marker handling
+            first = false;
+            if (options.detect)
+            {
+                uint32_t bytes = 0;
+                const UTF_TYPE type = unicode::utf::identifyUTF(input.data, input.size, bytes);
+                if ((type != UTF_TYPE::OTHER) && (type != from->utfType()))
+                {
+                    from = &IUTFTK::getHandler(type);
+                }
+            }
+            utf_text head = { (input.size & ~(from->unitSize() - 1)), 0, const_cast<uint8_t*>(input.data) };
+            unicode_t unicode = 0;
+            uint32_t bytes = 0;
+            if ((options.add_bom || options.strip_bom) && from->get(head, unicode, bytes).no_error() && (unicode == 0xfeff))
+            {
+                input.consume(bytes);
+            }
+            if (options.add_bom)
+            {
+                uint8_t bom[8];
+                utf_text text = { sizeof(bom), 0, bom };
+                if (to.writeBOM(text).no_error() && !writeFully(out, bom, text.offset))
+                {
+                    fputs("suiteutf-conv: write error\n", stderr);
+                    return 2;
+                }
+                written += text.offset;
+            }
+        }
+        utf_text text = { (input.size & ~(from->unitSize() - 1)), 0, const_cast<uint8_t*>(input.data) };
+        uint32_t count = 0;
+        utf_text chunk;
+        while (bulk::readChunk(*from, text, chunk, options.chunk).none())
+        {
+            if (jobs.size() <= count)
+            {
+                jobs.emplace_back();
+            }
+            jobs[count].src = chunk;
+            jobs[count].start = static_cast<uint32_t>(chunk.buffer - input.data);
+            jobs[count].final = input.eof;
+            ++count;
+        }
+        if (!input.eof && (count > 1))
+        {   //  hold back the chunk at the end of the window (a full window without a safe boundary is processed whole)
+            --count;
+        }
+        runJobs(*from, to, options, jobs, count);
+        uint32_t consumed = 0;
+        for (uint32_t index = 0; index < count; ++index)
+        {
+            chunk_job& job = jobs[index];
+            if (!writeFully(out, job.output.data(), job.used))
+            {
+                fputs("suiteutf-conv: write error\n", stderr);
+                return 2;
+            }
+            written += job.used;
+            repairs += job.repairs;
+            warnings |= job.errors.warnings_only();
+            consumed = (job.start + job.src.offset);
+            if (job.errors.error())
+            {
+                if (job.errors.any(cp_errors::bits::ReadTruncated) && !job.final && ((index + 1) == count))
+                {   //  carry the truncated sequence into the next window
+                    break;
+                }
+                reportError(options, (input.base + consumed), job.errors);
+                return 1;
+            }
+        }
+        input.consume(consumed);
+        if (input.eof && (input.size != 0) && (input.size < from->unitSize()))
+        {   //  incomplete code-unit at the end of the input
+            if (!options.use_repair)
+            {
+                reportError(options, input.base, cp_errors::bits::Failed | cp_errors::bits::ReadTruncated);
+                return 1;
+            }
+            uint8_t replacement[8];
+            utf_text text = { sizeof(replacement), 0, replacement };
+            if (writeReplacement(to, text).no_error() && !writeFully(out, replacement, text.offset))
+            {
+                fputs("suiteutf-conv: write error\n", stderr);
+                return 2;
+            }
+            written += text.offset;
+            ++repairs;
+            input.consume(input.size);
+        }
+        if (input.eof && (input.size == 0))
+        {
+            break;
+        }
+    }
+    if (options.verbose)
+    {
+        std::string text;
+        appendErrors(text, warnings);
+        fprintf(stderr, "suiteutf-conv: %s -> %s: %llu bytes in, %llu bytes out, %llu repairs, warnings: %s\n", subTypeName(from->utfSubType()), subTypeName(to.utfSubType()),
+            static_cast<unsigned long long>(input.base), static_cast<unsigned long long>(written), static_cast<unsigned long long>(repairs), text.c_str());
+    }
+    return 0;
+}
+
+};  //  anonymous namespace
+
+int main(int argc, char** argv)
+{
+    conv_options options;
+    int status = 0;
+    if (!parseOptions(argc, argv, options, status))
+    {
+        return status;
+    }
+    int out = 1;
+    if ((options.output != nullptr) && strcmp(options.output, "-"))
+    {
+        out = openWrite(options.output);
+        if (out < 0)
+        {
+            fprintf(stderr, "suiteutf-conv: cannot open '%s' for writing\n", options.output);
+            return 2;
+        }
+    }
+    const uint64_t window = (static_cast<uint64_t>(options.chunk) * options.threads);
+    const uint32_t size = ((window < 0x10000u) ? 0x10000u : ((window > 0x40000000u) ? 0x40000000u : static_cast<uint32_t>(window)));
+    mapped_file mapping;
+    bool mapped = false;
+    int in = 0;
+    if ((options.input != nullptr) && strcmp(options.input, "-"))
+    {
+        mapped = mapping.open(options.input);
+        if (!mapped)
+        {
+            in = openRead(options.input);
+            if (in < 0)
+            {
+                fprintf(stderr, "suiteutf-conv: cannot open '%s'\n", options.input);
+                return 2;
+            }
+        }
+    }
+    if (mapped)
+    {
+        input_window input(mapping.data(), mapping.size(), size);
+        status = convert(options, input, out);
+    }
+    else
+    {
+        input_window input(in, size);
+        status = convert(options, input, out);
+    }
+    if (in > 0)
+    {
+        closeFile(in);
+    }
+    if (out > 1)
+    {
+        closeFile(out);
+    }
+    return status;
+}
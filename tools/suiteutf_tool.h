@@ -0,0 +1,526 @@
+
+//  SuiteUTF
+//  Original design 20102016; maintained and extended 20242025.
+//  Copyright (c) 20102025 Ritchie Brannan.
+//  MIT License. See LICENSE.txt. Project history: docs/History.md.
+//
+//  File:   suiteutf_tool.h
+//  Author: Ritchie Brannan
+//  Date:   18 Oct 26
+//  
+//  Description:
+//  
+//      Shared support for the SuiteUTF command line tools.
+//  
+//  Notes:
+//  
+//      This header is only used by the tools in this directory and is not part of the library.
+//  
+//      Memory mapping and raw file descriptor I/O are used on POSIX systems, other systems fall back to streaming
+//      reads through the file descriptor functions of the C runtime.
+
+#pragma once
+
+#ifndef __SUITEUTF_TOOL_INCLUDED__
+#define __SUITEUTF_TOOL_INCLUDED__
+
+#include "utf_bulk.h"
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace suiteutf_tool
+{
+
+using unicode::utf::toolkit::cp_errors;
+using unicode::utf::toolkit::IUTFTK;
+using unicode::utf::toolkit::UTF_SUB_TYPE;
+
+// ==== sub-type names ====
+
+struct sub_type_name
+{
+    const char*     name;
+    UTF_SUB_TYPE    type;
+};
+
+/// sub-type enumeration names (matched exactly, in enumeration order)
+static const sub_type_name kSubTypeNames[static_cast<uint32_t>(UTF_SUB_TYPE::COUNT)] =
+{
+    { "UTF8",     UTF_SUB_TYPE::UTF8     }, { "UTF8ns",   UTF_SUB_TYPE::UTF8ns   }, { "UTF8st",   UTF_SUB_TYPE::UTF8st   },
+    { "JUTF8",    UTF_SUB_TYPE::JUTF8    }, { "JUTF8ns",  UTF_SUB_TYPE::JUTF8ns  }, { "JUTF8st",  UTF_SUB_TYPE::JUTF8st  },
+    { "CESU8",    UTF_SUB_TYPE::CESU8    }, { "CESU8ns",  UTF_SUB_TYPE::CESU8ns  }, { "CESU8st",  UTF_SUB_TYPE::CESU8st  },
+    { "JCESU8",   UTF_SUB_TYPE::JCESU8   }, { "JCESU8ns", UTF_SUB_TYPE::JCESU8ns }, { "JCESU8st", UTF_SUB_TYPE::JCESU8st },
+    { "UTF16le",  UTF_SUB_TYPE::UTF16le  }, { "UTF16be",  UTF_SUB_TYPE::UTF16be  }, { "UCS2le",   UTF_SUB_TYPE::UCS2le   },
+    { "UCS2be",   UTF_SUB_TYPE::UCS2be   }, { "UTF32le",  UTF_SUB_TYPE::UTF32le  }, { "UTF32be",  UTF_SUB_TYPE::UTF32be  },
+    { "UCS4le",   UTF_SUB_TYPE::UCS4le   }, { "UCS4be",   UTF_SUB_TYPE::UCS4be   }, { "CESU32le", UTF_SUB_TYPE::CESU32le },
+    { "CESU32be", UTF_SUB_TYPE::CESU32be }, { "CESU4le",  UTF_SUB_TYPE::CESU4le  }, { "CESU4be",  UTF_SUB_TYPE::CESU4be  },
+    { "BYTE",     UTF_SUB_TYPE::BYTE     }, { "BYTEns",   UTF_SUB_TYPE::BYTEns   }, { "ASCII",    UTF_SUB_TYPE::ASCII    },
+    { "ASCIIns",  UTF_SUB_TYPE::ASCIIns  }, { "CP1252",   UTF_SUB_TYPE::CP1252   }, { "CP1252ns", UTF_SUB_TYPE::CP1252ns },
+    { "CP1252st", UTF_SUB_TYPE::CP1252st }
+};
+
+/// iconv style aliases (matched ignoring case) mapping to the strict sub-types
+static const sub_type_name kSubTypeAliases[] =
+{
+    { "UTF-8",        UTF_SUB_TYPE::UTF8st   },
+    { "UTF-16LE",     UTF_SUB_TYPE::UTF16le  },
+    { "UTF-16BE",     UTF_SUB_TYPE::UTF16be  },
+    { "UTF-32LE",     UTF_SUB_TYPE::UTF32le  },
+    { "UTF-32BE",     UTF_SUB_TYPE::UTF32be  },
+    { "UCS-2LE",      UTF_SUB_TYPE::UCS2le   },
+    { "UCS-2BE",      UTF_SUB_TYPE::UCS2be   },
+    { "ISO-8859-1",   UTF_SUB_TYPE::BYTEns   },
+    { "LATIN1",       UTF_SUB_TYPE::BYTEns   },
+    { "US-ASCII",     UTF_SUB_TYPE::ASCIIns  },
+    { "WINDOWS-1252", UTF_SUB_TYPE::CP1252st }
+};
+
+inline const char* subTypeName(const UTF_SUB_TYPE utfSubType) noexcept
+{
+    const uint32_t index = static_cast<uint32_t>(utfSubType);
+    return ((index < static_cast<uint32_t>(UTF_SUB_TYPE::COUNT)) ? kSubTypeNames[index].name : "unknown");
+}
+
+inline bool findSubType(const char* const name, UTF_SUB_TYPE& utfSubType) noexcept
+{
+    for (const sub_type_name& entry : kSubTypeNames)
+    {
+        if (strcmp(entry.name, name) == 0)
+        {
+            utfSubType = entry.type;
+            return isSubTypeAvailable(utfSubType);
+        }
+    }
+    for (const sub_type_name& entry : kSubTypeAliases)
+    {
+        uint32_t index = 0;
+        while ((entry.name[index] != 0) && (toupper(static_cast<unsigned char>(name[index])) == entry.name[index]))
+        {
+            ++index;
+        }
+        if ((entry.name[index] == 0) && (name[index] == 0))
+        {
+            utfSubType = entry.type;
+            return isSubTypeAvailable(utfSubType);
+        }
+    }
+    return false;
+}
+
+inline void listSubTypes(FILE* const file) noexcept
+{
+    for (const sub_type_name& entry : kSubTypeNames)
+    {
+        if (isSubTypeAvailable(entry.type))
+        {
+            fprintf(file, "%s\n", entry.name);
+        }
+    }
+    for (const sub_type_name& entry : kSubTypeAliases)
+    {
+        if (isSubTypeAvailable(entry.type))
+        {
+            fprintf(file, "%s (alias of %s)\n", entry.name, subTypeName(entry.type));
+        }
+    }
+}
+
+// ==== cp_errors names ====
+
+/// appends the names of the set cp_errors bits to a string ("None" if no bits are set)
+inline void appendErrors(std::string& string, const cp_errors errors, const char* const separator = "|")
+{
+    static const char* const kBitNames[32] =
+    {
+        nullptr, nullptr, nullptr, nullptr, "UnexpectedByte", "DisallowedByte", "NotEnoughBits", "Untransformable",
+        "ExtendedUTF8", "OverlongUTF8", "ModifiedUTF8", "BadSizeUTF8", "IrregularForm", "DelimitString", "LowSurrogate", "HighSurrogate",
+        "SurrogatePair", "TruncatedPair", "NonCharacter", "Supplementary", "ExtendedUCS4", "InvalidPoint", "NotDecodable", "NotEncodable",
+        "ReadExhausted", "ReadTruncated", "WriteOverflow", "MisalignedLength", "MisalignedOffset", "InvalidOffset", "InvalidBuffer", "Failed"
+    };
+    bool first = true;
+    for (uint32_t bit = 32; bit-- > 4;)
+    {
+        if (errors.any(cp_errors::underlying_type(1) << bit))
+        {
+            if (!first)
+            {
+                string += separator;
+            }
+            string += kBitNames[bit];
+            first = false;
+        }
+    }
+    if (first)
+    {
+        string += "None";
+    }
+}
+
+// ==== command line helpers ====
+
+/// parses a byte size with an optional K, M or G suffix
+inline bool parseSize(const char* const text, uint32_t& size) noexcept
+{
+    char* end = nullptr;
+    unsigned long long value = strtoull(text, &end, 10);
+    if ((end == text) || (value == 0))
+    {
+        return false;
+    }
+    switch (*end)
+    {
+        case('k'): case('K'): { value <<= 10; ++end; break; }
+        case('m'): case('M'): { value <<= 20; ++end; break; }
+        case('g'): case('G'): { value <<= 30; ++end; break; }
+        default:              { break; }
+    }
+    if ((*end != 0) || (value > 0x80000000ull))
+    {
+        return false;
+    }
+    size = static_cast<uint32_t>(value);
+    return true;
+}
+
+// ==== file descriptor I/O ====
+
+#if defined(_WIN32)
+inline int openRead(const char* const path) noexcept { return _open(path, _O_RDONLY | _O_BINARY); }
+inline int openWrite(const char* const path) noexcept { return _open(path, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE); }
+inline int closeFile(const int fd) noexcept { return _close(fd); }
+inline long long readSome(const int fd, uint8_t* const buffer, const uint32_t size) noexcept { return _read(fd, buffer, size); }
+inline long long writeSome(const int fd, const uint8_t* const buffer, const uint32_t size) noexcept { return _write(fd, buffer, size); }
+#else
+inline int openRead(const char* const path) noexcept { return open(path, O_RDONLY); }
+inline int openWrite(const char* const path) noexcept { return open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644); }
+inline int closeFile(const int fd) noexcept { return close(fd); }
+inline long long readSome(const int fd, uint8_t* const buffer, const uint32_t size) noexcept { return read(fd, buffer, size); }
+inline long long writeSome(const int fd, const uint8_t* const buffer, const uint32_t size) noexcept { return write(fd, buffer, size); }
+#endif
+
+/// gets the size of a file, returns false if the file does not exist
+inline bool fileSize(const char* const path, uint64_t& size) noexcept
+{
+#if defined(_WIN32)
+    struct _stat64 info;
+    const bool success = (_stat64(path, &info) == 0);
+#else
+    struct stat info;
+    const bool success = (stat(path, &info) == 0);
+#endif
+    size = (success ? static_cast<uint64_t>(info.st_size) : 0);
+    return success;
+}
+
+/// reads until the buffer is full or the end of the file is reached, returns false on a read error
+inline bool readFully(const int fd, uint8_t* const buffer, const uint32_t size, uint32_t& bytes) noexcept
+{
+    bytes = 0;
+    while (bytes < size)
+    {
+        const long long count = readSome(fd, &buffer[bytes], (size - bytes));
+        if (count <= 0)
+        {
+            return (count == 0);
+        }
+        bytes += static_cast<uint32_t>(count);
+    }
+    return true;
+}
+
+/// writes the entire buffer, returns false on a write error
+inline bool writeFully(const int fd, const uint8_t* const buffer, const uint32_t size) noexcept
+{
+    uint32_t bytes = 0;
+    while (bytes < size)
+    {
+        const long long count = writeSome(fd, &buffer[bytes], (size - bytes));
+        if (count <= 0)
+        {
+            return false;
+        }
+        bytes += static_cast<uint32_t>(count);
+    }
+    return true;
+}
+
+/// read-only memory mapped file (regular files only)
+class mapped_file
+{
+public:
+    mapped_file() noexcept : m_data(nullptr), m_size(0), m_mapped(false) {}
+    ~mapped_file() noexcept { close(); }
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+    const uint8_t*  data() const noexcept { return m_data; }
+    uint64_t        size() const noexcept { return m_size; }
+    bool open(const char* const path) noexcept
+    {   //  returns false if the file cannot be mapped (the caller should fall back to streaming reads)
+        close();
+#if defined(_WIN32)
+        (void)path;
+        return false;
+#else
+        const int fd = ::open(path, O_RDONLY);
+        if (fd < 0)
+        {
+            return false;
+        }
+        struct stat info;
+        bool mapped = false;
+        if ((fstat(fd, &info) == 0) && S_ISREG(info.st_mode))
+        {
+            m_size = static_cast<uint64_t>(info.st_size);
+            if (m_size == 0)
+            {
+                mapped = true;
+            }
+            else
+            {
+                void* const data = mmap(nullptr, static_cast<size_t>(m_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                if (data != MAP_FAILED)
+                {
+                    madvise(data, static_cast<size_t>(m_size), MADV_SEQUENTIAL);
+                    m_data = static_cast<const uint8_t*>(data);
+                    m_mapped = true;
+                    mapped = true;
+                }
+            }
+        }
+        ::close(fd);
+        if (!mapped)
+        {
+            m_size = 0;
+        }
+        return mapped;
+#endif
+    }
+    void close() noexcept
+    {
+#if !defined(_WIN32)
+        if (m_mapped)
+        {
+            munmap(const_cast<uint8_t*>(m_data), static_cast<size_t>(m_size));
+        }
+#endif
+        m_data = nullptr;
+        m_size = 0;
+        m_mapped = false;
+    }
+private:
+    const uint8_t*  m_data;
+    uint64_t        m_size;
+    bool            m_mapped;
+};
+
+/// input window over a memory mapped file or a streamed file descriptor
+class input_window
+{
+public:
+    input_window(const uint8_t* const mapping, const uint64_t total, const uint32_t window) noexcept :
+        data(nullptr), size(0), base(0), eof(false), m_mapping(mapping), m_total(total), m_fd(-1), m_window(window) {}
+    input_window(const int fd, const uint32_t window) :
+        data(nullptr), size(0), base(0), eof(false), m_mapping(nullptr), m_total(0), m_fd(fd), m_window(window), m_buffer(window) {}
+    bool fill() noexcept
+    {   //  makes the window as large as possible, returns false on a read error
+        if (m_fd < 0)
+        {
+            const uint64_t remaining = (m_total - base);
+            size = ((remaining < m_window) ? static_cast<uint32_t>(remaining) : m_window);
+            data = ((size != 0) ? &m_mapping[base] : nullptr);
+            eof = ((base + size) == m_total);
+            return true;
+        }
+        if (!eof && (size < m_window))
+        {
+            uint32_t bytes = 0;
+            if (!readFully(m_fd, &m_buffer[size], (m_window - size), bytes))
+            {
+                return false;
+            }
+            size += bytes;
+            eof = (size < m_window);
+        }
+        data = m_buffer.data();
+        return true;
+    }
+    void consume(const uint32_t bytes) noexcept
+    {
+        if (m_fd >= 0)
+        {
+            memmove(m_buffer.data(), &m_buffer[bytes], (size - bytes));
+        }
+        else
+        {
+            data += bytes;
+        }
+        size -= bytes;
+        base += bytes;
+    }
+    const uint8_t*          data;   //  current window data
+    uint32_t                size;   //  current window size in bytes
+    uint64_t                base;   //  input offset of the current window
+    bool                    eof;    //  the window reaches the end of the input
+private:
+    const uint8_t*          m_mapping;
+    uint64_t                m_total;
+    int                     m_fd;
+    uint32_t                m_window;
+    std::vector<uint8_t>    m_buffer;
+};
+
+// ==== directory walking ====
+
+/// calls onFile(path) for each regular file found under path (or for path itself if it is a file)
+///
+///     Directories are walked iteratively, symbolic links to directories are not followed. onError(path) is called
+///     for each path which cannot be opened. Returns false if path itself does not exist.
+///
+template <typename OnFile, typename OnError>
+bool walkFiles(const std::string& path, OnFile&& onFile, OnError&& onError)
+{
+    std::vector<std::string> pending;
+#if defined(_WIN32)
+    const DWORD attributes = GetFileAttributesA(path.c_str());
+    if (attributes == INVALID_FILE_ATTRIBUTES)
+    {
+        return false;
+    }
+    if (!(attributes & FILE_ATTRIBUTE_DIRECTORY))
+    {
+        onFile(path);
+        return true;
+    }
+    pending.push_back(path);
+    while (!pending.empty())
+    {
+        const std::string directory = pending.back();
+        pending.pop_back();
+        WIN32_FIND_DATAA entry;
+        const HANDLE find = FindFirstFileA((directory + "\\*").c_str(), &entry);
+        if (find == INVALID_HANDLE_VALUE)
+        {
+            onError(directory);
+            continue;
+        }
+        do
+        {
+            if (!strcmp(entry.cFileName, ".") || !strcmp(entry.cFileName, ".."))
+            {
+                continue;
+            }
+            const std::string child = directory + "\\" + entry.cFileName;
+            if (entry.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+            {
+                if (!(entry.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT))
+                {
+                    pending.push_back(child);
+                }
+            }
+            else
+            {
+                onFile(child);
+            }
+        }
+        while (FindNextFileA(find, &entry));
+        FindClose(find);
+    }
+#else
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0)
+    {
+        return false;
+    }
+    if (!S_ISDIR(info.st_mode))
+    {
+        if (S_ISREG(info.st_mode))
+        {
+            onFile(path);
+        }
+        return true;
+    }
+    pending.push_back(path);
+    while (!pending.empty())
+    {
+        const std::string directory = pending.back();
+        pending.pop_back();
+        DIR* const dir = opendir(directory.c_str());
+        if (dir == nullptr)
+        {
+            onError(directory);
+            continue;
+        }
+        const bool slash = (!directory.empty() && (directory.back() == '/'));
+        while (const struct dirent* const entry = readdir(dir))
+        {
+            if (!strcmp(entry->d_name, ".") || !strcmp(entry->d_name, ".."))
+            {
+                continue;
+            }
+            const std::string child = (slash ? (directory + entry->d_name) : (directory + "/" + entry->d_name));
+            bool directory_entry = false;
+            bool file_entry = false;
+#if defined(DT_DIR)
+            if (entry->d_type == DT_DIR)
+            {
+                directory_entry = true;
+            }
+            else if (entry->d_type == DT_REG)
+            {
+                file_entry = true;
+            }
+            else
+#endif
+            {   //  unknown entry types and symbolic links (links to regular files are checked, links to directories are not followed)
+                struct stat child_info;
+                if (lstat(child.c_str(), &child_info) == 0)
+                {
+                    if (S_ISLNK(child_info.st_mode))
+                    {
+                        file_entry = ((stat(child.c_str(), &child_info) == 0) && S_ISREG(child_info.st_mode));
+                    }
+                    else
+                    {
+                        directory_entry = S_ISDIR(child_info.st_mode);
+                        file_entry = S_ISREG(child_info.st_mode);
+                    }
+                }
+            }
+            if (directory_entry)
+            {
+                pending.push_back(child);
+            }
+            else if (file_entry)
+            {
+                onFile(child);
+            }
+        }
+        closedir(dir);
+    }
+#endif
+    return true;
+}
+
+};  //  namespace suiteutf_tool
+
+#endif  //  #ifndef __SUITEUTF_TOOL_INCLUDED__